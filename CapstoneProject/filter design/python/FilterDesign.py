@@ -6,11 +6,13 @@ Outputs:
  - Magnitude response plot for the FIR bandpass candidates
  - Printed FIR taps in C++-ready format
  - Recommended Savitzky–Golay parameters
+ - filter_coeffs.json with every candidate (C++ loads it at runtime: POST /filter {"id": ...})
 """
 
+import json
 import numpy as np
 import matplotlib.pyplot as plt
-from scipy.signal import firwin, freqz, savgol_filter, butter, savgol_filter, savgol_coeffs
+from scipy.signal import firwin, freqz, savgol_filter, butter, savgol_filter, savgol_coeffs, tf2sos
 
 FS = 250.0  # sampling rate [Hz]
 F_LO = 2.0   # bandpass low cutoff [Hz]
@@ -73,6 +75,25 @@ def print_cpp_vector(var_name: str, coeffs, as_double: bool = False):
     print(line)
     print("};\n")
 
+def export_coeffs_json(path: str, candidates):
+    """
+    Write all candidates to one json file for the C++ side (FilterCoeffs.hpp has the schema).
+    FIR -> "b" taps, IIR -> second-order sections (b0 b1 b2 a0 a1 a2), never raw b/a.
+    """
+    sets = []
+    for c in candidates:
+        entry = {"id": c["id"], "name": c["name"]}
+        if c["type"] == "FIR":
+            entry["type"] = "FIR"
+            entry["b"] = [float(x) for x in c["b"]]
+        else:
+            entry["type"] = "SOS"
+            entry["sos"] = [[float(x) for x in row] for row in tf2sos(c["b"], c["a"])]
+        sets.append(entry)
+    with open(path, "w") as f:
+        json.dump({"fs": FS, "sets": sets}, f, indent=1)
+    print(f"wrote {len(sets)} coefficient sets to {path}")
+
 
 # ============ (2) savitzky-golay filter ===================================
 def demo_savgol_params():
@@ -235,6 +256,8 @@ def main():
     plt.legend(loc="lower left", fontsize=8)
     plt.tight_layout()
 
+    export_coeffs_json("filter_coeffs.json", candidates)
+
     plt.show()
 
     print("\n// ===== C++ filter coefficients =====\n")
@@ -2,10 +2,12 @@
 #include <chrono>
 #include <iostream>
 #include "utils/RingBuffer.hpp"
+#include "utils/SpscRingBuffer.hpp"
 #include "utils/Types.h"
 #include "shared/StateStore.hpp"
 #include "stimulus/HttpServer.hpp"
 #include "acq/WindowConfigs.hpp"
+#include "acq/ChunkGapTracker.hpp"
 #include <atomic>
 #include "utils/Logger.hpp"
 #include <csignal>
@@ -25,23 +27,65 @@
 
 #ifdef USE_EEG_FILTERS
 #include "utils/Filters.hpp"
+#include "utils/CalibExport.hpp"
 #endif
 
 #ifdef ACQ_BACKEND_FAKE
 #include "acq/FakeAcquisition.h"
 #endif
+#ifdef ACQ_BACKEND_REPLAY
+#include "acq/ReplayAcquisition.h"
+#endif
+#ifdef ACQ_RECORD_FILE
+#include "acq/AcqRecording.hpp"
+#endif
 
 constexpr bool TEST_MODE = 1;
 
+#if defined(ACQ_BACKEND_FAKE) || defined(ACQ_BACKEND_REPLAY)
+// pacing set via FAKE_ACQ_PACING / FAKE_ACQ_SPEED in CMake (fake + replay)
+#if defined(FAKE_ACQ_PACING_UNPACED)
+constexpr AcqPacing_E ACQ_PACING = AcqPacing_Unpaced;
+constexpr double ACQ_PACING_SPEED = 1.0;
+#elif defined(FAKE_ACQ_PACING_SPEED)
+constexpr AcqPacing_E ACQ_PACING = AcqPacing_Speed;
+constexpr double ACQ_PACING_SPEED = FAKE_ACQ_SPEED;
+#else
+constexpr AcqPacing_E ACQ_PACING = AcqPacing_RealTime;
+constexpr double ACQ_PACING_SPEED = 1.0;
+#endif
+#else
+constexpr double ACQ_PACING_SPEED = 1.0; // hardware: device time is wall time
+#endif
+// a chunk fills up in CHUNK_LATENCY_MS of device time, i.e. that / speed of wall time; same for one scan
+constexpr double CHUNK_WALL_MS = device_to_wall_ms(CHUNK_LATENCY_MS, ACQ_PACING_SPEED);
+constexpr double SCAN_WALL_MS = device_to_wall_ms(PIPELINE_SCAN_MS, ACQ_PACING_SPEED);
+
+#ifdef ACQ_BACKEND_FAKE
+// simulated bluetooth link, FAKE_ACQ_TRANSPORT in CMake
+#if defined(FAKE_ACQ_TRANSPORT_LOSSY)
+constexpr FakeTransport_E ACQ_TRANSPORT = FakeTransport_Lossy;
+#elif defined(FAKE_ACQ_TRANSPORT_BLUETOOTH)
+constexpr FakeTransport_E ACQ_TRANSPORT = FakeTransport_Bluetooth;
+#else
+constexpr FakeTransport_E ACQ_TRANSPORT = FakeTransport_Ideal;
+#endif
+#endif
+
 // Global "please stop" flag set by Ctrl+C (SIGINT) to shut down cleanly
 static std::atomic<bool> g_stop{false};
 
+#ifdef USE_EEG_FILTERS
+// raw scans of the current calib session: producer appends before the filter bank, consumer exports at finalize
+static CalibRecorder_C g_calib_rec;
+#endif
+
 // Interrupt signal sent when ctrl+c is pressed
 void handle_sigint(int) {
     g_stop.store(true,std::memory_order_relaxed);
 }
 
-void producer_thread_fn(RingBuffer_C<bufferChunk_S>& rb, StateStore_s& stateStoreRef){
+void producer_thread_fn(SpscRingBuffer_C<bufferChunk_S>& rb, StateStore_s& stateStoreRef){
     using namespace std::chrono_literals;
     logger::tlabel = "producer";
 try {
@@ -55,10 +99,22 @@ try {
     fakeCfg.lineNoise.enabled = true;
     fakeCfg.alpha.enabled = true;
     fakeCfg.beta.enabled = true;
+    fakeCfg.pacing = ACQ_PACING;
+    fakeCfg.speed = ACQ_PACING_SPEED;
+    fakeCfg.transport = FakeAcquisition_C::transportConfigs_S::preset(ACQ_TRANSPORT);
+    LOG_ALWAYS("fake transport: " << FakeTransport_to_string(ACQ_TRANSPORT));
     // random artifacts, alpha and beta sources off for now
 
     FakeAcquisition_C acqDriver(fakeCfg);
 
+#elif defined(ACQ_BACKEND_REPLAY)
+    LOG_ALWAYS("PATH=REPLAY");
+    ReplayAcquisition_C::replayConfigs_S replayCfg{};
+    replayCfg.path = ACQ_REPLAY_FILE;
+    replayCfg.pacing = ACQ_PACING;
+    replayCfg.speed = ACQ_PACING_SPEED;
+    ReplayAcquisition_C acqDriver(replayCfg);
+
 #else
     LOG_ALWAYS("PATH=HARDWARE");
     UnicornDriver_C acqDriver{};
@@ -67,6 +123,7 @@ try {
 
 #ifdef USE_EEG_FILTERS
     EegFilterBank_C filterBank;
+    bool calibRecFull = false; // warned about the cap already
 #endif
 
     // somthn to use iacqprovider_s instead of unicorndriver_c directly
@@ -80,6 +137,9 @@ try {
     };
 
     size_t tick_count = 0;
+    double lastReadyMs = -1.0;  // hand-over time of the previous chunk (arrival spacing)
+    bool counterSeen = false;   // device scan counter: where the next chunk should start
+    uint64_t nextScan = 0;
 
     // Channel configs
     int n_ch = acqDriver.getNumChannels();
@@ -106,33 +166,156 @@ try {
         stateStoreRef.eeg_channel_enabled[i] = false;
     }
     
+    // declared latency of the acquisition side (filter one is set below whenever the active bandpass changes)
+    stateStoreRef.latency.device_ms.store(acqDriver.latency_ms(), std::memory_order_relaxed);
+    stateStoreRef.latency.chunk_ms.store(CHUNK_WALL_MS, std::memory_order_relaxed);
+
+#ifdef ACQ_RECORD_FILE
+    // raw chunks + labels + hand-over times, for ReplayAcquisition_C
+    AcqRecorder_C recorder;
+    double recT0Ms = -1.0;
+    {
+        std::string err;
+        if (recorder.open(ACQ_RECORD_FILE, NUM_CH_CHUNK, NUM_SCANS_CHUNK, double(ACQ_FS_HZ), err)) {
+            LOG_ALWAYS("recording acquisition to " << ACQ_RECORD_FILE);
+        } else {
+            LOG_ALWAYS("WARN: not recording: " << err);
+        }
+    }
+#endif
+
     // MAIN ACQUISITION LOOP
     while(!g_stop.load(std::memory_order_relaxed)){
-        bufferChunk_S chunk{};
+        // grab the next free slot in the queue and build the chunk in place (no stack chunk, no copy on push)
+        // blocking... will always (eventually) return a slot, 
+        // unless queue is closed, in which case we want out
+        bufferChunk_S* slot = rb.acquire_write_slot();
+        if(slot == nullptr){
+            LOG_ALWAYS("RingBuffer closed while pushing; stopping producer");
+            break;
+        }
+        bufferChunk_S& chunk = *slot; // slot is recycled -> overwrite every header field below
 
 #ifdef ACQ_BACKEND_FAKE
 	int currSimFreq = stateStoreRef.g_freq_hz.load(std::memory_order_acquire);
     acqDriver.setActiveStimulus(static_cast<double>(currSimFreq)); // if 0, backend won't produce sinusoid
 #endif
         
+#ifdef ACQ_BACKEND_REPLAY
+        if (!acqDriver.getData(NUM_SCANS_CHUNK, chunk.data.data())) {
+            LOG_ALWAYS("replay finished after " << acqDriver.get_chunks_played() << " chunks; stopping");
+            // let the consumer work through what's queued first, otherwise unpaced replay ends with a full queue
+            while (rb.get_count() > 0 && !g_stop.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            }
+            g_stop.store(true, std::memory_order_relaxed);
+            break;
+        }
+#else
         acqDriver.getData(NUM_SCANS_CHUNK, chunk.data.data()); // chunk.data.data() gives type float* (addr of first float in std::array obj)
+#endif
+        // first scan was sampled a whole chunk (+ transport) before getData returned
+        const double t_ready_ms = latency_now_ms();
+        if (lastReadyMs >= 0.0) stateStoreRef.transport.interarrival_ms.add(t_ready_ms - lastReadyMs);
+        lastReadyMs = t_ready_ms;
+
+        // scan counter jumped -> scans lost in transport right before this chunk; consumer accounts for it
+        chunk.first_scan = 0;
+        chunk.lost_scans = 0;
+        uint64_t firstScan = 0;
+        if (acqDriver.get_scan_counter(firstScan)) {
+            if (counterSeen && firstScan > nextScan) {
+                const uint64_t lost = firstScan - nextScan;
+                chunk.lost_scans = static_cast<uint32_t>(lost);
+                stateStoreRef.transport.counter_gaps.fetch_add(1, std::memory_order_relaxed);
+                stateStoreRef.transport.counter_lost_scans.fetch_add(lost, std::memory_order_relaxed);
+                LOG_ALWAYS("scan counter jumped " << nextScan << " -> " << firstScan << ": " << lost << " scans lost");
+            }
+            counterSeen = true;
+            nextScan = firstScan + NUM_SCANS_CHUNK;
+            chunk.first_scan = firstScan;
+        }
         tick_count++;
         chunk.tick = tick_count;
+        chunk.epoch_ms = t_ready_ms - acqDriver.latency_ms() - CHUNK_WALL_MS;
+        chunk.numCh = NUM_CH_CHUNK;
+        chunk.numScans = NUM_SCANS_CHUNK;
+        chunk.active_label = false;
+#ifdef ACQ_BACKEND_REPLAY
+        {
+            const AcqRecChunk_S& meta = acqDriver.get_chunk_meta();
+            chunk.ui_state = meta.ui_state;
+            chunk.label = meta.label;
+            chunk.freq_hz = meta.freq_hz;
+        }
+#else
+        chunk.ui_state = stateStoreRef.g_ui_state.load(std::memory_order_acquire);
+        chunk.label = stateStoreRef.g_freq_hz_e.load(std::memory_order_acquire);
+        chunk.freq_hz = stateStoreRef.g_freq_hz.load(std::memory_order_acquire);
+#endif
+#ifdef ACQ_RECORD_FILE
+        if (recorder.is_open()) {
+            if (recT0Ms < 0.0) recT0Ms = t_ready_ms - 1000.0 * double(NUM_SCANS_CHUNK) / double(ACQ_FS_HZ); // first chunk lands at its own length
+            recorder.append(chunk.data.data(), NUM_SCANS_CHUNK, chunk.tick, t_ready_ms - recT0Ms,
+                            chunk.first_scan, chunk.lost_scans, chunk.ui_state, chunk.label, chunk.freq_hz);
+        }
+#endif
 
 #ifdef USE_EEG_FILTERS
-        // before we create window: PREPROCESS CHUNK
+        // calib session: keep the unfiltered scans, the export re-filters the whole session offline (zero phase).
+        // instructions too: calib alternates instructions/active, keeping it one continuous recording
+        if (chunk.ui_state == UIState_Active_Calib || chunk.ui_state == UIState_NoSSVEP_Test || chunk.ui_state == UIState_Instructions) {
+            if (!g_calib_rec.append(chunk) && !calibRecFull) {
+                LOG_ALWAYS("WARN: calib recording full (" << g_calib_rec.get_num_scans() << " scans), rest of the session isn't exported");
+                calibRecFull = true;
+            }
+        } else {
+            calibRecFull = false;
+        }
+        // coeff swap requested from UI? filter bank loads it off-thread, we just pass it on
+        if (stateStoreRef.g_filter_swap_requested.exchange(false, std::memory_order_acq_rel)) {
+            std::string file, id;
+            {
+                std::lock_guard<std::mutex> lock(stateStoreRef.filter_mtx);
+                file = stateStoreRef.filter_request_file;
+                id = stateStoreRef.filter_request_id;
+            }
+            if (!filterBank.request_bandpass_swap(file, id)) {
+                LOG_ALWAYS("bandpass swap already in progress; ignoring request for " << id);
+            }
+        }
+        // before we create window: PREPROCESS CHUNK (in place, in the queue slot)
         filterBank.process_chunk(chunk);
+        {
+            const AdaptiveLineNotch_C& notch = filterBank.get_line_notch();
+            stateStoreRef.line_noise.freq_hz.store(notch.get_freq_hz(), std::memory_order_relaxed);
+            stateStoreRef.line_noise.nominal_hz.store(notch.get_nominal_hz(), std::memory_order_relaxed);
+            stateStoreRef.line_noise.harmonics.store(notch.get_num_harmonics(), std::memory_order_relaxed);
+            for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+                stateStoreRef.line_noise.line_uv_rms[ch].store(notch.get_line_uv_rms(ch), std::memory_order_relaxed);
+                stateStoreRef.line_noise.residual_uv2[ch].store(notch.get_residual_uv2(ch), std::memory_order_relaxed);
+            }
+        }
+        if (filterBank.consume_status_changed()) {
+            const BandpassStatus_S st = filterBank.get_bandpass_status();
+            std::lock_guard<std::mutex> lock(stateStoreRef.filter_mtx);
+            stateStoreRef.filter_status.active_id = st.active_id;
+            stateStoreRef.filter_status.engine = st.engine;
+            stateStoreRef.filter_status.taps = st.taps;
+            stateStoreRef.filter_status.group_delay_ms = st.group_delay_ms;
+            stateStoreRef.filter_status.swap_in_progress = st.swap_in_progress;
+            stateStoreRef.filter_status.last_error = st.last_error;
+            stateStoreRef.filter_status.swaps = st.swaps;
+            stateStoreRef.filter_status.coeffs = st.coeffs;
+            stateStoreRef.latency.filter_ms.store(device_to_wall_ms(filterBank.get_latency_ms(), ACQ_PACING_SPEED), std::memory_order_relaxed);
+        }
 #endif
-        // Update state store with this new chunk for UI vis
-        stateStoreRef.g_hasEegChunk.store(true, std::memory_order_release);
-        stateStoreRef.set_lastEegChunk(chunk);
+        // fan out to stream subscribers (UI live view etc.); never blocks on them
+        stateStoreRef.eeg_stream.publish(chunk);
         
-        // blocking push function... will always (eventually) run and return true, 
-        // unless queue is closed, in which case we want out
-        if(!rb.push(chunk)){
-            LOG_ALWAYS("RingBuffer closed while pushing; stopping producer");
-            break;
-        } 
+        // publish slot to consumer (DropNewest overflow: discarded here)
+        rb.commit();
+        stateStoreRef.acq_queue.store(rb.get_stats());
     }
     // on thread shutdown, close queue to call release n unblock any consumer waiting for acquire
     LOG_ALWAYS("producer shutting down; stopping acquisition backend...");
@@ -151,7 +334,7 @@ catch (...) {
 }
 }
 
-void consumer_thread_fn(RingBuffer_C<bufferChunk_S>& rb, StateStore_s& stateStoreRef){
+void consumer_thread_fn(SpscRingBuffer_C<bufferChunk_S>& rb, StateStore_s& stateStoreRef){
     using namespace std::chrono_literals;
     logger::tlabel = "consumer";
     LOG_ALWAYS("consumer start");
@@ -164,10 +347,11 @@ void consumer_thread_fn(RingBuffer_C<bufferChunk_S>& rb, StateStore_s& stateStor
 
 try{
     SignalQualityAnalyzer_C SignalQualityAnalyzer(&stateStoreRef);
+    SpectralCache_C spectrum; // one FFT per window, shared by SQA (and features once they're in)
 
     sliding_window_t window; // should acquire the data for 1 window with that many pops n then increment by hop... 
     bufferChunk_S temp; // placeholder
-
+    ChunkGapTracker_C gapTracker; // windows across a gap (lost scans / dropped chunks) don't get handed out
     namespace fs = std::filesystem;
 
     // Two independent CSV files, one at window level, one at chunk level
@@ -201,6 +385,9 @@ try{
         // Session changed - close old files and reset flags
         if (chunk_opened) { csv_chunk.flush(); csv_chunk.close(); chunk_opened = false; }
         if (win_opened)   { csv_win.flush();   csv_win.close();   win_opened   = false; }
+#ifdef USE_EEG_FILTERS
+        g_calib_rec.clear();
+#endif
 
         active_session_id = sid;
         active_data_dir   = ddir;
@@ -264,7 +451,7 @@ try{
         // Header
         csv_win << "window_idx,ui_state,is_trimmed,is_bad,sample_idx";
         for (int ch = 0; ch < n_ch_local; ++ch) csv_win << ",eeg" << (ch + 1);
-        csv_win << ",testfreq_e,testfreq_hz\n";
+        csv_win << ",testfreq_e,testfreq_hz,fs_hz\n"; // fs_hz: rows are after the filter bank (PIPELINE_FS_HZ)
 
         win_opened = true;
         rows_written_win = 0;
@@ -284,17 +471,10 @@ try{
         int n_ch_local = stateStoreRef.g_n_eeg_channels.load(std::memory_order_acquire);
         if (n_ch_local <= 0 || n_ch_local > NUM_CH_CHUNK) n_ch_local = NUM_CH_CHUNK;
 
-        // choose buffer
-        std::vector<float> snap;                 // local storage when snapshotting
-        const std::vector<float>* pBuf = nullptr;
-
-        if (use_trimmed && w.isTrimmed && !w.trimmed_window.empty()) {
-            pBuf = &w.trimmed_window;
-        } else {
-            w.sliding_window.get_data_snapshot(snap);
-            pBuf = &snap;
-        }
-        const std::vector<float>& buf = *pBuf;
+        // choose buffer (both are views into the window's storage, no copies)
+        const std::span<const float> buf =
+            (use_trimmed && w.isTrimmed && !w.trimmed_window.empty()) ? w.trimmed_window
+                                                                       : w.sliding_window.view();
 
         if (buf.empty()) {
             LOG_ALWAYS("WARN: snapshot empty, skipping CSV");
@@ -323,13 +503,44 @@ try{
                 csv_win << "," << buf[base + static_cast<std::size_t>(ch)];
             }
 
-            csv_win << "," << tf_e << "," << tf_hz << "\n";
+            csv_win << "," << tf_e << "," << tf_hz << "," << PIPELINE_FS_HZ << "\n";
             ++rows_written_win;
         }
 
         if ((rows_written_win % 5000) == 0) csv_win.flush();
     };
 
+    // every pop goes through here
+    auto pop_chunk = [&]() -> bool {
+        if (!rb.pop(&temp)) return false;
+        if (gapTracker.on_chunk(temp)) {
+            auto& tr = stateStoreRef.transport;
+            tr.gaps.store(gapTracker.get_gaps(), std::memory_order_relaxed);
+            tr.dropped_chunks.store(gapTracker.get_dropped_chunks(), std::memory_order_relaxed);
+            tr.lost_scans.store(gapTracker.get_lost_scans(), std::memory_order_relaxed);
+        }
+#ifdef ACQ_BACKEND_REPLAY
+        // replay: the recorded labels drive the consumer, in step with the data (however far ahead the producer is)
+        stateStoreRef.g_ui_state.store(temp.ui_state, std::memory_order_release);
+        stateStoreRef.g_freq_hz_e.store(temp.label, std::memory_order_release);
+        stateStoreRef.g_freq_hz.store(temp.freq_hz, std::memory_order_release);
+#endif
+        return true;
+    };
+
+    // Signal to training manager: data is ready (to launch training thread)
+    auto request_training = [&stateStoreRef]() {
+        {
+            std::lock_guard<std::mutex> lock(stateStoreRef.mtx_train_job_request);
+            stateStoreRef.train_job_requested = true;
+        }
+        LOG_ALWAYS("notify");
+        stateStoreRef.cv_train_job_request.notify_one();
+    };
+#ifdef USE_EEG_FILTERS
+    std::jthread calibExport; // zero-phase export of the last calib session (joins on reassign / exit)
+#endif
+
     auto handle_finalize_if_requested = [&]() {
         // quick check flag (locked)
         bool do_finalize = false;
@@ -384,27 +595,58 @@ try{
         sesspaths::prune_old_sessions_for_subject(new_data / subject_id, 3);
         // TODO: PRUNE MODELS IF/WHEN TRAINING FAILS !
 
-        // Signal to training manager: data is ready (to launch training thread)
-        {
-            std::lock_guard<std::mutex> lock(stateStoreRef.mtx_train_job_request);
-            stateStoreRef.train_job_requested = true;
+#ifdef USE_EEG_FILTERS
+        // training windows: the whole recording re-filtered zero phase, untrimmed. Runs off this thread into a
+        // temp file that replaces the online eeg_windows.csv once it's complete (online one stays if it fails);
+        // training gets signalled after that
+        CalibRecording_S calibRec = g_calib_rec.take();
+        if (calibRec.num_scans() > 0) {
+            int n_ch_local = stateStoreRef.g_n_eeg_channels.load(std::memory_order_acquire);
+            if (n_ch_local <= 0 || n_ch_local > NUM_CH_CHUNK) n_ch_local = NUM_CH_CHUNK;
+            const fs::path final_data = fs::path(stateStoreRef.currentSessionInfo.get_active_data_path());
+            calibExport = std::jthread([&stateStoreRef, request_training, rec = std::move(calibRec),
+                                        set = stateStoreRef.get_filter_status().coeffs,
+                                        out_path = final_data / "eeg_windows.csv",
+                                        nCh = static_cast<std::size_t>(n_ch_local)]() {
+                logger::tlabel = "calib_export";
+                const fs::path tmp_path = fs::path(out_path).concat(".zp.tmp");
+                const unsigned nThreads = std::max(1u, std::thread::hardware_concurrency());
+                std::string err;
+                const auto t0 = clock_T::now();
+                const long nWin = export_calib_windows(rec, set, tmp_path.string(), nCh, nThreads, err);
+                const auto ms = std::chrono::duration_cast<ms_T>(clock_T::now() - t0).count();
+                std::error_code ec;
+                if (nWin >= 0) fs::rename(tmp_path, out_path, ec);
+                if (nWin < 0 || ec) {
+                    LOG_ALWAYS("ERROR: zero-phase export failed (" << (nWin < 0 ? err : ec.message())
+                               << "), training uses the online windows");
+                    fs::remove(tmp_path, ec);
+                } else {
+                    LOG_ALWAYS("zero-phase export: " << rec.num_scans() << " raw scans -> " << nWin
+                               << " windows (" << set.id << ", " << ms << " ms) -> " << out_path.string());
+                }
+                request_training();
+            });
+            return;
         }
-        LOG_ALWAYS("notify");
-        stateStoreRef.cv_train_job_request.notify_one();
+#endif
+        request_training();
     };
 
+    stateStoreRef.latency.window_ms.store(device_to_wall_ms(sliding_window_t::latency_ms(), ACQ_PACING_SPEED), std::memory_order_relaxed);
+    stateStoreRef.latency.classifier_ms.store(CLASSIFIER_LATENCY_MS, std::memory_order_relaxed);
+
 	// build first window
 	while(window.sliding_window.get_count()<window.winLen){
 		// sc
-		if(!rb.pop(&temp)){ // internally wait here (pop cmd is blocking)
+		if(!pop_chunk()){ // internally wait here (pop cmd is blocking)
 			break;
 		} 
 		else { 
-			// this will fit fine because winLen is a multiple of number of scans per channel = 32
+			// this will fit fine because winLen is a multiple of number of scans per chunk (32, or 16 decimated)
 			// pop sucessful -> push into sliding window
-			for(int i = 0; i<NUM_SAMPLES_CHUNK;i++){
-				window.sliding_window.push(temp.data[i]);
-			}
+			window.sliding_window.push_n(temp.data.data(), temp.numScans * NUM_CH_CHUNK);
+			window.newest_epoch_ms = scan_stamp_ms(temp.epoch_ms, temp.numScans - 1, SCAN_WALL_MS);
 		}
 	}
     
@@ -428,7 +670,7 @@ try{
             // pop but don't build window 
             // need to pop bcuz need to prevent buffer overflow 
             // TODO: clean up implementation to always pull/pop and then save window logic to end
-            if(!rb.pop(&temp)) break;
+            if(!pop_chunk()) break;
             continue; //back to top while loop
         }
         // save this as prev state to check after window is built to make sure UI state hasn't changed in between
@@ -436,10 +678,8 @@ try{
         prevLabel = currLabel;
         
         // 2) ============================= build the new window =============================
-        float discard; // first pop
-        for(size_t k=0;k<window.winHop;k++){
-            window.sliding_window.pop(&discard); 
-        }
+        // first pop (drop the oldest hop in one go)
+        window.sliding_window.discard_n(window.winHop);
 
         while(window.sliding_window.get_count()<window.winLen){ // now push
             UIState_E intState = stateStoreRef.g_ui_state.load(std::memory_order_acquire);
@@ -452,9 +692,10 @@ try{
             if (window.stash_len > 0) {
                 // take full amnt_left_to_add from stash if it's available, otherwise take window.stash_len
                 const std::size_t take = (window.stash_len > amnt_left_to_add) ? amnt_left_to_add : window.stash_len;
-                for (std::size_t i = 0; i < take; ++i){
-                    window.sliding_window.push(window.stash[i]);
-				}
+                window.sliding_window.push_n(window.stash.data(), take);
+                const std::size_t take_scans = take / NUM_CH_CHUNK;
+                window.newest_epoch_ms = scan_stamp_ms(window.stash_epoch_ms, take_scans - 1, SCAN_WALL_MS);
+                window.stash_epoch_ms = scan_stamp_ms(window.stash_epoch_ms, take_scans, SCAN_WALL_MS);
                 // move leftover stash to front of array for next round
                 if (take < window.stash_len) {
                     std::memmove(window.stash.data(), // start of stash array (dest)
@@ -470,25 +711,25 @@ try{
                 LOG_ALWAYS("There's an issue with sliding window stash.");
                 break;
             }
-			if(!rb.pop(&temp)){
+			if(!pop_chunk()){
 				break;
 			} else {
 				// pop successful -> push into sliding window
-				if(amnt_left_to_add >= NUM_SAMPLES_CHUNK){
-                    for(std::size_t j=0;j<NUM_SAMPLES_CHUNK;j++){
-                        window.sliding_window.push(temp.data[j]);
-                    } // goes back to check while for next chunk
+				const std::size_t chunk_samples = temp.numScans * NUM_CH_CHUNK; // fewer than NUM_SAMPLES_CHUNK if decimated
+				if(amnt_left_to_add >= chunk_samples){
+                    window.sliding_window.push_n(temp.data.data(), chunk_samples);
+                    window.newest_epoch_ms = scan_stamp_ms(temp.epoch_ms, temp.numScans - 1, SCAN_WALL_MS);
+                    // goes back to check while for next chunk
 				}
 				else {
 					// take what we need and stash the rest for next window
-					for(std::size_t j=0;j<NUM_SAMPLES_CHUNK;j++){
-						if(j<amnt_left_to_add){
-							window.sliding_window.push(temp.data[j]);
-						} else {
-							window.stash[j-amnt_left_to_add]=temp.data[j];
-                            window.stash_len++; // increasing slots to add from stash for next time
-						}
-					}
+					window.sliding_window.push_n(temp.data.data(), amnt_left_to_add);
+					const std::size_t taken_scans = amnt_left_to_add / NUM_CH_CHUNK;
+					window.newest_epoch_ms = scan_stamp_ms(temp.epoch_ms, taken_scans - 1, SCAN_WALL_MS);
+					window.stash_epoch_ms = scan_stamp_ms(temp.epoch_ms, taken_scans, SCAN_WALL_MS);
+					const std::size_t leftover = chunk_samples - amnt_left_to_add;
+					std::memcpy(window.stash.data(), temp.data.data() + amnt_left_to_add, leftover * sizeof(float));
+					window.stash_len = leftover; // slots to add from stash for next time
 				}
 			}
 		}
@@ -503,6 +744,13 @@ try{
             window.has_label = false;
             continue; // go build next window
         }
+        // scans missing somewhere inside -> not a continuous stretch of EEG, wait until the gap slid out
+        if (!gapTracker.window_is_contiguous(WINDOW_SCANS, window.stash_len / NUM_CH_CHUNK)) {
+            window.decision = SSVEP_Unknown;
+            window.has_label = false;
+            stateStoreRef.transport.gap_windows.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
 
         // verified it's an ok window
         ++tick_count;
@@ -510,13 +758,27 @@ try{
 
         // reset before looking at state store vals
         window.isTrimmed = false;
+        window.trimmed_window = {};
         window.has_label = false;
         window.testFreq = TestFreq_None;
 
         // always check artifacts and flag bad windows
-        SignalQualityAnalyzer.check_artifact_and_flag_window(window);
+        const double t_decision_ms = latency_now_ms();
+        SignalQualityAnalyzer.check_artifact_and_flag_window(window, spectrum);
+        {
+            // content of a filtered sample is filter_ms older than its stamp (declared spans are already wall ms)
+            const double now_ms = latency_now_ms();
+            const SampleAges_S ages = sample_ages_ms(now_ms, window.newest_epoch_ms,
+                                                     stateStoreRef.latency.filter_ms.load(std::memory_order_relaxed),
+                                                     stateStoreRef.latency.window_ms.load(std::memory_order_relaxed));
+            stateStoreRef.latency.age_newest_ms.add(ages.newest_ms);
+            stateStoreRef.latency.age_oldest_ms.add(ages.oldest_ms);
+            stateStoreRef.latency.decision_compute_ms.add(now_ms - t_decision_ms);
+        }
 
         if(currState == UIState_Active_Calib || currState == UIState_NoSSVEP_Test) {
+            // online windows are streamed as they come (filter builds: replaced at finalize by the zero-phase
+            // export, until then this is what survives a crash)
             if (!ensure_csv_open_window()) {
                 continue; // must be open for logging
             }
@@ -527,9 +789,8 @@ try{
             if (n_ch_local <= 0 || n_ch_local > NUM_CH_CHUNK) n_ch_local = NUM_CH_CHUNK;
             
             // trim window ends for training data (GUARD)
-            window.trimmed_window.clear();
-            window.sliding_window.get_trimmed_snapshot(window.trimmed_window,
-                40 * n_ch_local, 40 * n_ch_local);
+            window.trimmed_window = window.sliding_window.view_trimmed(
+                WINDOW_TRIM_SCANS * n_ch_local, WINDOW_TRIM_SCANS * n_ch_local);
             window.isTrimmed = true;
 
             // we should be attaching a label to our windows for calibration data
@@ -575,8 +836,7 @@ try{
         }
         
 	}
-    // exiting due to producer exiting means we need to close window rb
-    window.sliding_window.close();
+    // exiting due to producer exiting means we need to close chunk rb
     rb.close();
     if (chunk_opened) { csv_chunk.flush(); csv_chunk.close(); }
     if (win_opened)   { csv_win.flush();   csv_win.close();   }
@@ -600,7 +860,21 @@ void stimulus_thread_fn(StateStore_s& stateStoreRef){
     try {
         LOG_ALWAYS("stim: start");
         StimulusController_C stimController(&stateStoreRef);
-        stimController.runUIStateMachine();
+        // SC only polls its own flag, forward g_stop to it so shutdown (ctrl+c / end of replay) can join this thread
+        std::thread stopper([&stimController]{
+            while(!g_stop.load(std::memory_order_acquire)){
+                std::this_thread::sleep_for(std::chrono::milliseconds{30});
+            }
+            stimController.stopStateMachine();
+        });
+        try {
+            stimController.runUIStateMachine();
+        } catch (...) {
+            g_stop.store(true, std::memory_order_relaxed); // joinable stopper would terminate() on unwind
+            stopper.join();
+            throw;
+        }
+        stopper.join();
         LOG_ALWAYS("stim: exit");
     }
     catch (const std::system_error& e) {
@@ -791,8 +1065,18 @@ void training_manager_thread_fn(StateStore_s& stateStoreRef){
 int main() {
     LOG_ALWAYS("start (VERBOSE=" << logger::verbose() << ")");
 
+    // what the producer does when the consumer falls behind (set via ACQ_OVERFLOW_POLICY in CMake)
+#if defined(ACQ_OVERFLOW_DROP_OLDEST)
+    constexpr OverflowPolicy_E acqOverflowPolicy = OverflowPolicy_DropOldest;
+#elif defined(ACQ_OVERFLOW_DROP_NEWEST)
+    constexpr OverflowPolicy_E acqOverflowPolicy = OverflowPolicy_DropNewest;
+#else
+    constexpr OverflowPolicy_E acqOverflowPolicy = OverflowPolicy_Block;
+#endif
+
     // Shared singletons/objects
-    RingBuffer_C<bufferChunk_S> ringBuf(ACQ_RING_BUFFER_CAPACITY);
+    SpscRingBuffer_C<bufferChunk_S> ringBuf(ACQ_RING_BUFFER_CAPACITY, acqOverflowPolicy); // lock-free chunk queue (producer -> consumer)
+    LOG_ALWAYS("acq queue: capacity=" << ACQ_RING_BUFFER_CAPACITY << " overflow policy=" << OverflowPolicy_to_string(acqOverflowPolicy));
     StateStore_s stateStore;
     HttpServer_C server(stateStore, 7777);
     server.http_start_server();
@@ -0,0 +1,58 @@
+#include "AcqPacer.hpp"
+#include "../utils/Logger.hpp"
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+void AcqPacer_C::init(const std::string& name, AcqPacing_E mode, double speed, double nominalSps) {
+    name_ = name;
+    mode_ = mode;
+    switch (mode) {
+        case AcqPacing_RealTime: speed_ = 1.0; break;
+        case AcqPacing_Speed:    speed_ = (speed > 0.0) ? speed : 1.0; break;
+        case AcqPacing_Unpaced:  speed_ = 0.0; break;
+    }
+    targetSps_ = nominalSps * speed_;
+    started_ = false;
+    resyncs_ = 0;
+    rateScans_ = 0;
+    achievedSps_ = 0.0;
+    LOG_ALWAYS(name_ << " pacing: " << AcqPacing_to_string(mode_) << " (target " << targetSps_ << " scans/s, 0 = as fast as possible)");
+}
+
+void AcqPacer_C::pace(double streamSec, std::size_t nScans) {
+    using namespace std::chrono;
+    auto now = steady_clock::now();
+    if (!started_) {
+        started_ = true;
+        anchor_ = now;
+        anchorStreamSec_ = 0.0;
+        rateT0_ = now;
+    }
+
+    if (speed_ > 0.0) {
+        // absolute deadline for the last scan of this chunk -> no drift from sleep overshoot
+        const auto due = anchor_ + duration_cast<steady_clock::duration>(duration<double>((streamSec - anchorStreamSec_) / speed_));
+        if (now - due > duration<double>(ACQ_PACE_MAX_BEHIND_SEC)) {
+            // stalled (consumer behind + block policy), don't burst the backlog out, start over from here
+            ++resyncs_;
+            const double behindMs = duration<double, std::milli>(now - due).count();
+            LOG_ALWAYS(name_ << ": " << behindMs << " ms behind, re-anchoring (resyncs=" << resyncs_ << ")");
+            anchor_ = now;
+            anchorStreamSec_ = streamSec;
+        } else if (due > now) {
+            std::this_thread::sleep_until(due);
+            now = steady_clock::now();
+        }
+    }
+
+    rateScans_ += nScans;
+    const double elapsed = duration<double>(now - rateT0_).count();
+    if (elapsed >= ACQ_RATE_REPORT_SEC) {
+        achievedSps_ = double(rateScans_) / elapsed;
+        LOG_ALWAYS(name_ << ": " << achievedSps_ << " scans/s achieved (" << AcqPacing_to_string(mode_)
+                   << ", target " << targetSps_ << ", resyncs=" << resyncs_ << ")");
+        rateT0_ = now;
+        rateScans_ = 0;
+    }
+}
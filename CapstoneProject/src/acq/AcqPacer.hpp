@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/* ACQ PACING (shared by the fake + replay providers)
+- RealTime: pace() blocks until the chunk's stream time is due on the wall clock, like the headset.
+  Deadlines are absolute (anchor + stream time), so sleep overshoot doesn't accumulate into drift.
+  If we fall more than ACQ_PACE_MAX_BEHIND_SEC behind (producer stalled on a full queue), we re-anchor
+  instead of bursting out the whole backlog
+- Speed: same thing with the stream time divided by speed (soak tests in less wall time)
+- Unpaced: no sleeping, runs as fast as the pipeline takes chunks (throughput benchmark)
+Stream time is whatever the provider says it is: scans / fs for the fake one, the recorded arrival
+times for a replay (so the original chunk jitter comes back too).
+Achieved scans/s is measured in every mode and logged every ACQ_RATE_REPORT_SEC
+*/
+
+enum AcqPacing_E {
+	AcqPacing_RealTime = 0,
+	AcqPacing_Speed,
+	AcqPacing_Unpaced
+};
+
+inline const char* AcqPacing_to_string(AcqPacing_E p) {
+	switch (p) {
+		case AcqPacing_RealTime: return "realtime";
+		case AcqPacing_Speed:    return "speed";
+		case AcqPacing_Unpaced:  return "unpaced";
+	}
+	return "unknown";
+}
+
+inline constexpr double ACQ_PACE_MAX_BEHIND_SEC = 1.0;
+inline constexpr double ACQ_RATE_REPORT_SEC = 10.0;
+
+class AcqPacer_C {
+public:
+	// name only goes into the log lines; nominalSps is what "target" means in the rate report
+	void init(const std::string& name, AcqPacing_E mode, double speed, double nominalSps);
+
+	// blocks until streamSec (end of this chunk, from the start of the stream) is due, counts nScans
+	void pace(double streamSec, std::size_t nScans);
+
+	AcqPacing_E get_mode() const { return mode_; };
+	double get_speed() const { return speed_; };          // 0 = unpaced
+	double get_target_sps() const { return targetSps_; }; // 0 = unpaced
+	double get_achieved_sps() const { return achievedSps_; }; // over the last report period (0 until the first)
+	std::size_t get_resyncs() const { return resyncs_; };
+
+private:
+	std::string name_ = "acq";
+	AcqPacing_E mode_ = AcqPacing_RealTime;
+	double speed_ = 1.0;
+	double targetSps_ = 0.0;
+	bool started_ = false;
+	std::chrono::steady_clock::time_point anchor_{};
+	double anchorStreamSec_ = 0.0;   // stream time that lines up with anchor_
+	std::size_t resyncs_ = 0;
+	std::chrono::steady_clock::time_point rateT0_{};
+	std::size_t rateScans_ = 0;
+	double achievedSps_ = 0.0;
+};
@@ -0,0 +1,309 @@
+#include "AcqRecording.hpp"
+#include "WindowConfigs.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+template <typename T>
+static void put(std::ofstream& f, const T& v) {
+    f.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+static bool get(std::ifstream& f, T& v) {
+    return static_cast<bool>(f.read(reinterpret_cast<char*>(&v), sizeof(T)));
+}
+
+// ============================== RECORDER ===================================
+
+bool AcqRecorder_C::open(const std::string& path, std::size_t nCh, std::size_t scansPerChunk, double fs, std::string& err) {
+    close();
+    f_.open(path, std::ios::binary | std::ios::trunc);
+    if (!f_.is_open()) {
+        err = "can't open " + path + " for writing";
+        return false;
+    }
+    nCh_ = nCh;
+    chunks_ = 0;
+    f_.write(ACQ_REC_MAGIC, sizeof(ACQ_REC_MAGIC));
+    put(f_, static_cast<uint32_t>(nCh));
+    put(f_, static_cast<uint32_t>(scansPerChunk));
+    put(f_, fs);
+    return static_cast<bool>(f_);
+}
+
+bool AcqRecorder_C::append(const float* data, std::size_t nScans, uint64_t tick, double t_ms, uint64_t firstScan, uint32_t lostScans,
+                           UIState_E state, TestFreq_E label, int freqHz) {
+    if (!f_.is_open()) return false;
+    put(f_, tick);
+    put(f_, t_ms);
+    put(f_, firstScan);
+    put(f_, lostScans);
+    put(f_, static_cast<uint8_t>(state));
+    put(f_, static_cast<uint8_t>(label));
+    put(f_, static_cast<int16_t>(freqHz));
+    put(f_, static_cast<uint32_t>(nScans));
+    f_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(nScans * nCh_ * sizeof(float)));
+    ++chunks_;
+    return static_cast<bool>(f_);
+}
+
+void AcqRecorder_C::close() {
+    if (f_.is_open()) {
+        f_.flush();
+        f_.close();
+    }
+}
+
+// ============================== LOADING ====================================
+
+// version 1 = no first_scan / lost_scans per chunk
+static bool load_binary(std::ifstream& f, AcqRecording_S& out, std::string& err, int version) {
+    uint32_t nCh = 0, scansPerChunk = 0;
+    double fs = 0.0;
+    if (!get(f, nCh) || !get(f, scansPerChunk) || !get(f, fs) || nCh == 0 || fs <= 0.0) {
+        err = "bad header";
+        return false;
+    }
+    out.nCh = nCh;
+    out.fs = fs;
+    out.hasTiming = true;
+
+    for (;;) {
+        uint64_t tick = 0;
+        if (!get(f, tick)) break; // clean end
+        AcqRecChunk_S c;
+        uint8_t st = 0, lb = 0;
+        int16_t hz = 0;
+        uint32_t nScans = 0;
+        if (!get(f, c.t_ms) || (version >= 2 && (!get(f, c.first_scan) || !get(f, c.lost_scans)))
+            || !get(f, st) || !get(f, lb) || !get(f, hz) || !get(f, nScans)) {
+            err = "truncated chunk header at chunk " + std::to_string(out.chunks.size());
+            return false;
+        }
+        c.tick = tick;
+        c.ui_state = static_cast<UIState_E>(st);
+        c.label = static_cast<TestFreq_E>(lb);
+        c.freq_hz = hz;
+        c.nScans = nScans;
+        c.firstScan = out.num_scans();
+        const std::size_t n = std::size_t(nScans) * nCh;
+        out.data.resize(out.data.size() + n);
+        if (!f.read(reinterpret_cast<char*>(out.data.data() + c.firstScan * nCh), static_cast<std::streamsize>(n * sizeof(float)))) {
+            // recorder got killed mid chunk: keep what's complete
+            out.data.resize(c.firstScan * nCh);
+            break;
+        }
+        out.hasCounter = out.hasCounter || c.first_scan != 0;
+        out.chunks.push_back(c);
+    }
+    if (out.chunks.empty()) {
+        err = "no chunks";
+        return false;
+    }
+    return true;
+}
+
+static void split_csv(const std::string& line, std::vector<std::string>& cols) {
+    cols.clear();
+    std::size_t p = 0;
+    for (;;) {
+        const std::size_t q = line.find(',', p);
+        cols.push_back(line.substr(p, q == std::string::npos ? std::string::npos : q - p));
+        if (q == std::string::npos) break;
+        p = q + 1;
+    }
+    if (!cols.empty() && !cols.back().empty() && cols.back().back() == '\r') cols.back().pop_back();
+}
+
+static UIState_E state_from_label(TestFreq_E lb) {
+    if (lb == TestFreq_NoSSVEP) return UIState_NoSSVEP_Test;
+    return (lb == TestFreq_None) ? UIState_Instructions : UIState_Active_Calib;
+}
+
+static bool load_csv(std::ifstream& f, AcqRecording_S& out, std::string& err, std::size_t scansPerChunk, double fsHz) {
+    std::string line;
+    std::vector<std::string> cols;
+    if (!std::getline(f, line)) {
+        err = "empty file";
+        return false;
+    }
+    split_csv(line, cols);
+    int colWin = -1, colState = -1, colLabel = -1, colHz = -1, colFs = -1, colTrim = -1, colTick = -1;
+    std::vector<int> colEeg;
+    for (int i = 0; i < int(cols.size()); ++i) {
+        const std::string& c = cols[i];
+        if (c == "window_idx") colWin = i;
+        else if (c == "ui_state") colState = i;
+        else if (c == "testfreq_e") colLabel = i;
+        else if (c == "testfreq_hz") colHz = i;
+        else if (c == "fs_hz") colFs = i;
+        else if (c == "is_trimmed") colTrim = i;
+        else if (c == "chunk_tick") colTick = i;
+        else if (c.rfind("eeg", 0) == 0) colEeg.push_back(i);
+    }
+    if (colEeg.empty() || colLabel < 0) {
+        err = "csv needs eegN and testfreq_e columns";
+        return false;
+    }
+    if (colEeg.size() > NUM_CH_CHUNK) {
+        err = "csv has " + std::to_string(colEeg.size()) + " channels, pipeline is built for " + std::to_string(NUM_CH_CHUNK);
+        return false;
+    }
+    const std::size_t nCh = colEeg.size();
+    out.nCh = nCh;
+    out.hasTiming = false;
+
+    // rate: fs_hz column, else the length of the first window / chunk (group = rows with one window_idx / chunk_tick)
+    const int colGroup = (colWin >= 0) ? colWin : colTick;
+    double fsCol = 0.0;
+    long firstGroup = 0;
+    std::size_t firstGroupLen = 0;
+    bool firstGroupDone = false, firstGroupTrimmed = false;
+
+    // per scan labels while reading, cut into chunks at the end
+    std::vector<uint8_t> st, lb;
+    std::vector<int16_t> hz;
+    auto push_scan = [&](const float* x, UIState_E s, TestFreq_E l, int h) {
+        out.data.insert(out.data.end(), x, x + nCh);
+        st.push_back(static_cast<uint8_t>(s));
+        lb.push_back(static_cast<uint8_t>(l));
+        hz.push_back(static_cast<int16_t>(h));
+    };
+
+    // window files: collect one window, then stitch it onto the stream
+    std::vector<float> win;
+    long winIdx = -1, prevWinIdx = -2;
+    UIState_E winState = UIState_None;
+    TestFreq_E winLabel = TestFreq_None;
+    int winHz = 0;
+    std::size_t prevLen = 0;
+    auto flush_window = [&]() {
+        if (win.empty()) return;
+        const std::size_t len = win.size() / nCh;
+        std::size_t skip = 0; // scans already in the stream
+        const std::size_t hop = WINDOW_HOP_SCANS;
+        if (winIdx == prevWinIdx + 1 && len == prevLen && len > hop && out.num_scans() >= len - hop) {
+            const float* tail = out.data.data() + (out.num_scans() - (len - hop)) * nCh;
+            if (std::memcmp(tail, win.data(), (len - hop) * nCh * sizeof(float)) == 0) skip = len - hop;
+        }
+        if (skip == 0 && out.num_scans() > 0) ++out.segments;
+        for (std::size_t s = skip; s < len; ++s) push_scan(&win[s * nCh], winState, winLabel, winHz);
+        prevWinIdx = winIdx;
+        prevLen = len;
+        win.clear();
+    };
+
+    std::vector<float> x(nCh);
+    std::size_t row = 1;
+    while (std::getline(f, line)) {
+        ++row;
+        if (line.empty() || line == "\r") continue;
+        split_csv(line, cols);
+        if (cols.size() < std::size_t(colEeg.back() + 1) || cols.size() <= std::size_t(colLabel)) {
+            err = "row " + std::to_string(row) + ": too few columns";
+            return false;
+        }
+        char* end = nullptr;
+        for (std::size_t ch = 0; ch < nCh; ++ch) {
+            const std::string& c = cols[colEeg[ch]];
+            x[ch] = std::strtof(c.c_str(), &end);
+            if (end == c.c_str()) {
+                err = "row " + std::to_string(row) + ": bad number '" + c + "'";
+                return false;
+            }
+        }
+        const TestFreq_E l = static_cast<TestFreq_E>(std::atoi(cols[colLabel].c_str()));
+        const UIState_E s = (colState >= 0) ? static_cast<UIState_E>(std::atoi(cols[colState].c_str())) : state_from_label(l);
+        const int h = (colHz >= 0) ? std::max(0, std::atoi(cols[colHz].c_str())) : 0;
+        if (colFs >= 0 && std::size_t(colFs) < cols.size()) {
+            const double v = std::atof(cols[colFs].c_str());
+            if (v <= 0.0 || (fsCol > 0.0 && v != fsCol)) {
+                err = "row " + std::to_string(row) + ": fs_hz '" + cols[colFs] + "'" + (fsCol > 0.0 ? " changes mid file" : "");
+                return false;
+            }
+            fsCol = v;
+        }
+        if (colGroup >= 0 && !firstGroupDone) {
+            const long g = std::atol(cols[colGroup].c_str());
+            if (firstGroupLen == 0) {
+                firstGroup = g;
+                firstGroupTrimmed = colTrim >= 0 && std::atoi(cols[colTrim].c_str()) != 0;
+            }
+            if (g == firstGroup) ++firstGroupLen;
+            else firstGroupDone = true;
+        }
+
+        if (colWin < 0) {
+            push_scan(x.data(), s, l, h);
+            continue;
+        }
+        const long w = std::atol(cols[colWin].c_str());
+        if (w != winIdx) {
+            flush_window();
+            winIdx = w;
+            winState = s;
+            winLabel = l;
+            winHz = h;
+        }
+        win.insert(win.end(), x.begin(), x.end());
+    }
+    flush_window();
+
+    if (fsCol > 0.0) {
+        out.fs = fsCol;
+    } else if (firstGroupLen > 0 && colGroup == colWin) {
+        const double ms = double(WINDOW_MS) - (firstGroupTrimmed ? 2.0 * double(WINDOW_TRIM_MS) : 0.0);
+        out.fs = 1000.0 * double(firstGroupLen) / ms;
+    } else if (firstGroupLen > 0) {
+        out.fs = 1000.0 * double(firstGroupLen) / double(CHUNK_MS);
+    } else {
+        out.fs = fsHz;
+    }
+
+    const std::size_t nScans = out.num_scans();
+    if (nScans < scansPerChunk) {
+        err = "csv has " + std::to_string(nScans) + " scans, not even one chunk";
+        return false;
+    }
+    // whole chunks only; labels = those of the chunk's first scan
+    out.data.resize((nScans / scansPerChunk) * scansPerChunk * nCh);
+    for (std::size_t s0 = 0; s0 + scansPerChunk <= nScans; s0 += scansPerChunk) {
+        AcqRecChunk_S c;
+        c.firstScan = s0;
+        c.nScans = scansPerChunk;
+        c.tick = out.chunks.size() + 1;
+        c.t_ms = 1000.0 * double(s0 + scansPerChunk) / out.fs;
+        c.ui_state = static_cast<UIState_E>(st[s0]);
+        c.label = static_cast<TestFreq_E>(lb[s0]);
+        c.freq_hz = hz[s0];
+        out.chunks.push_back(c);
+    }
+    return true;
+}
+
+bool load_acq_recording(const std::string& path, AcqRecording_S& out, std::string& err,
+                        std::size_t scansPerChunk, double fsHz) {
+    out = AcqRecording_S{};
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+        err = "can't open " + path;
+        return false;
+    }
+    char magic[sizeof(ACQ_REC_MAGIC)] = {};
+    f.read(magic, sizeof(magic));
+    const bool full = f.gcount() == sizeof(magic);
+    const int version = !full ? 0
+                      : std::memcmp(magic, ACQ_REC_MAGIC, sizeof(magic)) == 0    ? 2
+                      : std::memcmp(magic, ACQ_REC_MAGIC_V1, sizeof(magic)) == 0 ? 1 : 0;
+    bool ok;
+    if (version > 0) {
+        ok = load_binary(f, out, err, version);
+    } else {
+        f.clear();
+        f.seekg(0);
+        ok = load_csv(f, out, err, scansPerChunk, fsHz);
+    }
+    if (!ok) err = path + ": " + err;
+    return ok;
+}
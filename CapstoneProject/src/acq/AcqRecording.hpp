@@ -0,0 +1,80 @@
+#pragma once
+#include "../utils/Types.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* ACQ RECORDING (what ReplayAcquisition_C plays back)
+BINARY (.eegrec), written chunk by chunk by the producer when ACQ_RECORD_FILE is set, little endian:
+- header: "EEGREC02", uint32 nCh, uint32 scansPerChunk, double fs
+- per chunk: uint64 tick, double t_ms, uint64 first_scan, uint32 lost_scans, uint8 ui_state,
+  uint8 label (TestFreq_E), int16 freq_hz, uint32 nScans, float data[nScans * nCh] (raw, before the
+  filter bank, interleaved)
+- t_ms = when the chunk was handed over, from the start of the stream (first chunk = its own length),
+  so a replay can reproduce the original arrival jitter, not just the nominal rate
+- first_scan / lost_scans = bufferChunk_S's (device scan counter, 0 = backend has none), so a replay
+  hits the same transport gaps. "EEGREC01" files (no counter fields) still load, with both 0
+CSV IMPORT (eeg_windows.csv / eeg_calib_data.csv, anything with eegN + testfreq_e columns):
+- window files: consecutive windows (window_idx + 1) whose first rows repeat the previous window's last
+  rows (hop = WINDOW_HOP_SCANS) are stitched back into one stream; anything else starts a new segment
+- no ui_state column -> Active_Calib / NoSSVEP_Test / Instructions from the label
+- rate: fs_hz column if there is one (the app writes PIPELINE_FS_HZ there), else rows per window
+  (WINDOW_MS, minus 2 x WINDOW_TRIM_MS if is_trimmed) or per chunk_tick (CHUNK_MS), else the fsHz passed in.
+  The rows come after the filter bank, so a file from an EEG_DECIMATION=2 build is at half the headset
+  rate: replay refuses anything that isn't ACQ_FS_HZ instead of playing it at the wrong speed
+- no timing in a csv: replay paces it at the nominal rate. These rows are already filtered, so they go
+  through the bandpass a second time on replay
+*/
+
+inline constexpr char ACQ_REC_MAGIC[8] = { 'E', 'E', 'G', 'R', 'E', 'C', '0', '2' };
+inline constexpr char ACQ_REC_MAGIC_V1[8] = { 'E', 'E', 'G', 'R', 'E', 'C', '0', '1' };
+
+struct AcqRecChunk_S {
+    std::size_t firstScan = 0;   // into AcqRecording_S::data (scans)
+    std::size_t nScans = 0;
+    uint64_t tick = 0;
+    double t_ms = 0.0;
+    UIState_E ui_state = UIState_None;
+    TestFreq_E label = TestFreq_None;
+    int freq_hz = 0;
+    uint64_t first_scan = 0;     // device scan counter (not firstScan above), 0 = none
+    uint32_t lost_scans = 0;     // producer saw the counter jump by this much right before the chunk
+};
+
+struct AcqRecording_S {
+    std::size_t nCh = 0;
+    double fs = 0.0;
+    bool hasTiming = false;            // binary yes, csv no
+    bool hasCounter = false;           // some chunk has a nonzero first_scan (EEGREC02 from a backend with one)
+    std::vector<float> data;           // interleaved, nCh stride
+    std::vector<AcqRecChunk_S> chunks;
+    std::size_t segments = 1;          // csv: contiguous pieces that got stitched (1 = no breaks)
+
+    std::size_t num_scans() const { return nCh ? data.size() / nCh : 0; };
+};
+
+class AcqRecorder_C {
+public:
+    AcqRecorder_C() = default;
+    ~AcqRecorder_C() { close(); };
+
+    bool open(const std::string& path, std::size_t nCh, std::size_t scansPerChunk, double fs, std::string& err);
+    // t_ms as described above; data is nScans x nCh interleaved
+    bool append(const float* data, std::size_t nScans, uint64_t tick, double t_ms, uint64_t firstScan, uint32_t lostScans,
+                UIState_E state, TestFreq_E label, int freqHz);
+    void close();
+    bool is_open() const { return f_.is_open(); };
+    std::size_t get_num_chunks() const { return chunks_; };
+
+private:
+    std::ofstream f_;
+    std::size_t nCh_ = 0;
+    std::size_t chunks_ = 0;
+};
+
+// binary or csv (looks at the magic). scansPerChunk only matters for csv (cut into chunks of that size),
+// fsHz is what a csv is assumed to be sampled at if the file doesn't say (see above); out.fs = what it is
+bool load_acq_recording(const std::string& path, AcqRecording_S& out, std::string& err,
+                        std::size_t scansPerChunk = NUM_SCANS_CHUNK, double fsHz = double(ACQ_FS_HZ));
@@ -0,0 +1,48 @@
+#pragma once
+#include "../utils/Types.h"
+#include <cstddef>
+#include <cstdint>
+
+/* GAPS IN THE CHUNK STREAM (consumer side)
+- two ways scans go missing before the consumer sees them:
+    transport -> device scan counter jumped (bufferChunk_S::lost_scans, filled in by the producer)
+    queue     -> tick jumped: producer dropped chunks on overflow (DropNewest/DropOldest policy)
+- either way the samples on both sides of the gap aren't continuous in time, so a window holding
+  both isn't a real 2.56 s of EEG (SSVEP phase breaks). Consumer keeps building windows as usual but
+  only hands out ones whose scans all came after the last gap -> a gap costs one window length of decisions
+- counts in pipeline scans (after decimation) for the window check; lost scans in device scans
+*/
+
+class ChunkGapTracker_C {
+public:
+    // every popped chunk, in order. true if there's a gap right before it
+    bool on_chunk(const bufferChunk_S& c) {
+        const uint64_t droppedChunks = (lastTick_ != 0 && c.tick > lastTick_ + 1) ? c.tick - lastTick_ - 1 : 0;
+        lastTick_ = c.tick;
+        const bool gap = (droppedChunks > 0) || (c.lost_scans > 0);
+        if (gap) {
+            ++gaps_;
+            droppedChunks_ += droppedChunks;
+            lostScans_ += c.lost_scans + droppedChunks * NUM_SCANS_CHUNK;
+            scansSinceGap_ = 0;
+        }
+        scansSinceGap_ += c.numScans;
+        return gap;
+    }
+
+    // window full: were all of its scans popped after the last gap? (stashScans = popped but not in the window yet)
+    bool window_is_contiguous(std::size_t windowScans, std::size_t stashScans) const {
+        return gaps_ == 0 || scansSinceGap_ >= windowScans + stashScans;
+    }
+
+    uint64_t get_gaps() const { return gaps_; }
+    uint64_t get_dropped_chunks() const { return droppedChunks_; }
+    uint64_t get_lost_scans() const { return lostScans_; } // transport + dropped chunks, device scans
+
+private:
+    uint64_t lastTick_ = 0;
+    uint64_t gaps_ = 0;
+    uint64_t droppedChunks_ = 0;
+    uint64_t lostScans_ = 0;
+    std::size_t scansSinceGap_ = 0;
+};
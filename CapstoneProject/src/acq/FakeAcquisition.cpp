@@ -1,11 +1,34 @@
 #include "FakeAcquisition.h"
+#include "../utils/Logger.hpp"
 #include <cmath>
 #include <numbers>
 #include <algorithm>
 
 static constexpr double kTwoPi = std::numbers::pi * 2.0;
 
-FakeAcquisition_C::FakeAcquisition_C(const stimConfigs_S &configs) : configs_(configs), rng_(0xC0FFEEu), activeStimulusHz_(0.0), numChannels_(NUM_CH_CHUNK) {
+FakeAcquisition_C::transportConfigs_S FakeAcquisition_C::transportConfigs_S::preset(FakeTransport_E t) {
+    transportConfigs_S c{};
+    switch (t) {
+        case FakeTransport_Ideal:
+            c.enabled = false;
+            break;
+        case FakeTransport_Bluetooth:
+            c.enabled = true; // defaults above
+            break;
+        case FakeTransport_Lossy:
+            c.enabled = true;
+            c.jitterMeanMs = 25.0;
+            c.stallProb = 0.05;
+            c.stallMinMs = 100.0;
+            c.stallMaxMs = 600.0;
+            c.lossProb = 0.02;
+            c.lossMaxScans = 32;
+            break;
+    }
+    return c;
+}
+
+FakeAcquisition_C::FakeAcquisition_C(const stimConfigs_S &configs) : configs_(configs), activeStimulusHz_(0.0), rng_(configs.seed), noise_(configs.seed), transportRng_(configs.seed ^ 0x7A7A7A7Au), numChannels_(NUM_CH_CHUNK) {
 	// nothing (start in "no stim" mode)
 
 	if (configs_.occasionalArtifactsEnabled){
@@ -14,6 +37,14 @@ FakeAcquisition_C::FakeAcquisition_C(const stimConfigs_S &configs) : configs_(co
     	samplesToNextArtifact_ = static_cast<std::size_t>(firstBlinkDelaySec * fs);
 	}
 
+    pacer_.init("fake acq", configs_.pacing, configs_.speed, fs);
+    if (configs_.transport.enabled) {
+        const transportConfigs_S& t = configs_.transport;
+        LOG_ALWAYS("fake acq transport: " << t.baseDelayMs << " ms + " << (t.jitter == TransportJitter_Uniform ? "uniform" : "exponential")
+                   << " jitter (mean " << t.jitterMeanMs << " ms), stalls " << t.stallProb << "/chunk of " << t.stallMinMs << "-" << t.stallMaxMs
+                   << " ms, loss " << t.lossProb << "/chunk of 1-" << t.lossMaxScans << " scans");
+    }
+
     // Just number them in fake acq...
     channelLabels_.resize(numChannels_);
     for (int i = 0; i < numChannels_; ++i) {
@@ -29,10 +60,10 @@ FakeAcquisition_C::FakeAcquisition_C(const stimConfigs_S &configs) : configs_(co
         chNoiseSigma_[ch] = configs_.noiseSigma_uV * randu(0.8, 1.2);
 
         // random phases
-        chSsvEpPhase_[ch] = randu(0.0, kTwoPi);
-        chAlphaPhase_[ch] = randu(0.0, kTwoPi);
-        chBetaPhase_[ch]  = randu(0.0, kTwoPi);
-        chLinePhase_[ch]  = randu(0.0, kTwoPi);
+        chSsvEp_.set_phase(ch, randu(0.0, kTwoPi));
+        chAlpha_.set_phase(ch, randu(0.0, kTwoPi));
+        chBeta_.set_phase(ch, randu(0.0, kTwoPi));
+        chLine_.set_phase(ch, randu(0.0, kTwoPi));
 
         // per-channel background gains
         chAlphaGain_[ch] = randu(0.7, 1.3);
@@ -114,12 +145,8 @@ double FakeAcquisition_C::artifact_value_for_channel(std::size_t ch) {
 }
 
 void FakeAcquisition_C::synthesize_data_stream(float* dest, std::size_t numberOfScans) {
-	// Local cache
-	const double activeFreq = activeStimulusHz_; // can have frequencies change instantly for any given chunk
+	const std::size_t nCh = static_cast<std::size_t>(numChannels_);
 	const double sigAmp_uV = configs_.ssvepAmplitude_uV;
-	const double noise_uV = configs_.noiseSigma_uV;
-
-	// Per sample phase increments to move sine wave along consistently per sample without using real time
 	const double dt = 1.0 / fs;
 
 	const bool stimEnabled = (activeStimulusHz_ > 0.0); // adding sin for ssvep?
@@ -130,90 +157,82 @@ void FakeAcquisition_C::synthesize_data_stream(float* dest, std::size_t numberOf
     const bool enableAlpha      = configs_.alpha.enabled;
     const bool enableBeta       = configs_.beta.enabled;
 
-	// phase increments (harmless even if not used) -> how we get freq of wave
-	const double dphi_ssvep = kTwoPi * activeFreq * dt; // angular dist = angular speed(2pif) x time
-	const double dphi_drift = kTwoPi * configs_.dcDrift.freqHz * dt;
-    const double dphi_alpha = kTwoPi * configs_.alpha.freqHz * dt;
-    const double dphi_beta  = kTwoPi * configs_.beta.freqHz  * dt;
-    const double dphi_line  = kTwoPi * configs_.lineNoise.freqHz * dt;
+	// per-scan rotations e^{j dphi} (dphi = 2 pi f dt); stimulus can change between chunks, phase carries over
+	auto rot = [dt](double f, double& rc, double& rs) { rc = std::cos(kTwoPi * f * dt); rs = std::sin(kTwoPi * f * dt); };
+	double ssC, ssS, drC, drS, alC, alS, beC, beS, lnC, lnS, atC, atS;
+	rot(activeStimulusHz_, ssC, ssS);
+	rot(configs_.dcDrift.freqHz, drC, drS);
+	rot(configs_.alpha.freqHz, alC, alS);
+	rot(configs_.beta.freqHz, beC, beS);
+	rot(configs_.lineNoise.freqHz, lnC, lnS);
+	rot(0.15, atC, atS); // 0.15 Hz slow attention modulation
+
+	// amplitudes per channel don't change within a block
+	std::array<double, NUM_CH_CHUNK> alphaAmp{}, betaAmp{}, lineAmp{}, ssvepAmp{};
+	for (std::size_t ch = 0; ch < nCh; ++ch) {
+		alphaAmp[ch] = enableAlpha ? configs_.alpha.amp_uV * chAlphaGain_[ch] : 0.0;
+		betaAmp[ch]  = enableBeta ? configs_.beta.amp_uV * chBetaGain_[ch] : 0.0;
+		lineAmp[ch]  = enableLine ? configs_.lineNoise.amp_uV * chLineGain_[ch] : 0.0;
+		ssvepAmp[ch] = stimEnabled ? sigAmp_uV * chSsvEpGain_[ch] : 0.0;
+	}
 
-	double attnModPhase = 0.0;
-    const double dphi_attn = kTwoPi * 0.15 * dt; // 0.15 Hz slow modulation
+	// all the noise for this block at once
+	noiseBuf_.resize(numberOfScans * nCh);
+	noise_.fill(noiseBuf_.data(), noiseBuf_.size());
 
     for (std::size_t i = 0; i < numberOfScans; i++) {
 
         // advance artifact scheduling
         if (enableArtifacts) maybe_start_artifact();
+        const bool artActive = enableArtifacts && artSamplesLeft_ > 0;
 
-        // global drift phase
-        double drift = 0.0;
-        if (enableDrift) {
-            drift = configs_.dcDrift.amp_uV * std::sin(driftPhase_);
-            driftPhase_ += dphi_drift;
-            if (driftPhase_ >= kTwoPi) driftPhase_ -= kTwoPi;
-        }
+        // global drift
+        const double drift = enableDrift ? configs_.dcDrift.amp_uV * driftS_ : 0.0;
 
-        // compute attention modulation scalar (0.9..1.1) -> for more realistic SSVEP mod by attn
-        const double attn = 1.0 + 0.10 * std::sin(attnModPhase);
-        attnModPhase += dphi_attn;
-        if (attnModPhase >= kTwoPi) attnModPhase -= kTwoPi;
+        // attention modulation scalar (0.9..1.1) -> for more realistic SSVEP mod by attn
+        const double attn = 1.0 + 0.10 * attnS_;
 
         // ========================= per-channel composition =========================
-        for (std::size_t ch = 0; ch < (std::size_t)numChannels_; ch++) {
-
-            double bg = 0.0;
-
-            // drift applies to all (scaled a tiny bit by channel gain)
-            bg += drift * chGain_[ch];
-
-            // alpha (per-channel phase + gain)
-            if (enableAlpha) {
-                bg += (configs_.alpha.amp_uV * chAlphaGain_[ch]) * std::sin(chAlphaPhase_[ch]);
-                chAlphaPhase_[ch] += dphi_alpha;
-                if (chAlphaPhase_[ch] >= kTwoPi) chAlphaPhase_[ch] -= kTwoPi; // NEW (per-channel)
-            }
-
-            // beta (per-channel phase + gain)
-            if (enableBeta) {
-                bg += (configs_.beta.amp_uV * chBetaGain_[ch]) * std::sin(chBetaPhase_[ch]);
-                chBetaPhase_[ch] += dphi_beta;
-                if (chBetaPhase_[ch] >= kTwoPi) chBetaPhase_[ch] -= kTwoPi; // NEW
-            }
-
-            // line noise (per-channel phase + gain)
-            if (enableLine) {
-                bg += (configs_.lineNoise.amp_uV * chLineGain_[ch]) * std::sin(chLinePhase_[ch]);
-                chLinePhase_[ch] += dphi_line;
-                if (chLinePhase_[ch] >= kTwoPi) chLinePhase_[ch] -= kTwoPi; // NEW
-            }
-
-            // SSVEP (per-channel gain + per-channel phase) with harmonic (2f)
-            double ssvep = 0.0;
-            if (stimEnabled) {
-                const double A = sigAmp_uV * chSsvEpGain_[ch] * attn;
-
-                // fundamental
-                ssvep += A * std::sin(chSsvEpPhase_[ch]);
-
-                // harmonic 2f at 0.35 amplitude
-                ssvep += 0.35 * A * std::sin(2.0 * chSsvEpPhase_[ch]);
-
-                // advance phase
-                chSsvEpPhase_[ch] += dphi_ssvep;
-                if (chSsvEpPhase_[ch] >= kTwoPi) chSsvEpPhase_[ch] -= kTwoPi;
-            }
-
-            // artifact (blink/pop)
-            const double art = artifact_value_for_channel(ch);
+        float* row = dest + NUM_CH_CHUNK * i;
+        const float* nz = noiseBuf_.data() + nCh * i;
+        for (std::size_t ch = 0; ch < nCh; ch++) {
+            // drift applies to all (scaled a tiny bit by channel gain), alpha/beta/line have per-channel phase + gain
+            double v = drift * chGain_[ch]
+                     + alphaAmp[ch] * chAlpha_.s[ch]
+                     + betaAmp[ch] * chBeta_.s[ch]
+                     + lineAmp[ch] * chLine_.s[ch];
+
+            // SSVEP fundamental + 2f harmonic at 0.35 amplitude (sin 2x = 2 sin x cos x)
+            const double A = ssvepAmp[ch] * attn;
+            v += A * chSsvEp_.s[ch] * (1.0 + 0.70 * chSsvEp_.c[ch]);
 
             // noise (per-channel sigma)
-            const double noiseVal = background_noise_signal(chNoiseSigma_[ch]);
+            v += chNoiseSigma_[ch] * double(nz[ch]);
 
-            // net
-            const double netVal = bg + ssvep + art + noiseVal;
+            row[ch] = static_cast<float>(v);
+        }
+        // artifact (blink/pop), rare -> separate pass so the loop above stays branch free
+        if (artActive) {
+            for (std::size_t ch = 0; ch < nCh; ch++) {
+                row[ch] += static_cast<float>(artifact_value_for_channel(ch));
+            }
+        }
 
-            dest[NUM_CH_CHUNK * i + ch] = static_cast<float>(netVal);
+        // advance oscillators
+        if (enableDrift) {
+            const double c = driftC_ * drC - driftS_ * drS;
+            driftS_ = driftS_ * drC + driftC_ * drS;
+            driftC_ = c;
         }
+        {
+            const double c = attnC_ * atC - attnS_ * atS;
+            attnS_ = attnS_ * atC + attnC_ * atS;
+            attnC_ = c;
+        }
+        if (enableAlpha) chAlpha_.rotate(alC, alS);
+        if (enableBeta)  chBeta_.rotate(beC, beS);
+        if (enableLine)  chLine_.rotate(lnC, lnS);
+        if (stimEnabled) chSsvEp_.rotate(ssC, ssS);
 
         // advance artifact state counters once per scan (not per channel)
         if (enableArtifacts && artSamplesLeft_ > 0) {
@@ -235,6 +254,16 @@ void FakeAcquisition_C::synthesize_data_stream(float* dest, std::size_t numberOf
 
         sampleCount_++;
     }
+
+	// pull the phasors back onto the unit circle (rounding error only, ~1e-14 per block)
+	chSsvEp_.renormalize();
+	chAlpha_.renormalize();
+	chBeta_.renormalize();
+	chLine_.renormalize();
+	const double kd = 1.5 - 0.5 * (driftC_ * driftC_ + driftS_ * driftS_);
+	driftC_ *= kd; driftS_ *= kd;
+	const double ka = 1.5 - 0.5 * (attnC_ * attnC_ + attnS_ * attnS_);
+	attnC_ *= ka; attnS_ *= ka;
 }
 
 void FakeAcquisition_C::setActiveStimulus(double fStimHz) {
@@ -250,14 +279,65 @@ void FakeAcquisition_C::setActiveStimulus(double fStimHz) {
 	activeStimulusHz_ = fStimHz;
 }
 
+double FakeAcquisition_C::latency_ms() const {
+	const transportConfigs_S& t = configs_.transport;
+	if (!t.enabled) return 0.0;
+	if (lastDelayMs_ < 0.0) return t.baseDelayMs + t.jitterMeanMs; // declared before the first chunk
+	// wall clock ms; unpaced hands everything over right away
+	const double speed = pacer_.get_speed();
+	return (speed > 0.0) ? lastDelayMs_ / speed : 0.0;
+}
+
+double FakeAcquisition_C::transport_delay_ms() {
+	const transportConfigs_S& t = configs_.transport;
+	std::uniform_real_distribution<double> u01(0.0, 1.0);
+	double d = t.baseDelayMs;
+	if (t.jitterMeanMs > 0.0) {
+		if (t.jitter == TransportJitter_Uniform) {
+			d += 2.0 * t.jitterMeanMs * u01(transportRng_);
+		} else {
+			d += std::exponential_distribution<double>(1.0 / t.jitterMeanMs)(transportRng_);
+		}
+	}
+	if (u01(transportRng_) < t.stallProb) {
+		++stalls_;
+		d += t.stallMinMs + (t.stallMaxMs - t.stallMinMs) * u01(transportRng_);
+	}
+	return d;
+}
+
+void FakeAcquisition_C::lose_scans() {
+	const transportConfigs_S& t = configs_.transport;
+	std::uniform_real_distribution<double> u01(0.0, 1.0);
+	if (t.lossMaxScans == 0 || u01(transportRng_) >= t.lossProb) return;
+	const std::size_t n = 1 + std::uniform_int_distribution<std::size_t>(0, t.lossMaxScans - 1)(transportRng_);
+	// sampled by the device, never arrives
+	lostBuf_.resize(n * NUM_CH_CHUNK);
+	synthesize_data_stream(lostBuf_.data(), n);
+	streamScans_ += n;
+	lostScans_ += n;
+}
+
 bool FakeAcquisition_C::getData(std::size_t const numberOfScans, float* dest) {
 	// validate arguments
 	if (dest == NULL || numberOfScans <= 0) {
 		return 0;
 	}
-	// work in std::size_t for math, upcast uint32_t --> size_t (64 bits) is safe (no truncation)
-	const std::size_t requiredLen = numberOfScans * NUM_CH_CHUNK;
+	const bool transport = configs_.transport.enabled;
+	if (transport) lose_scans();
+	firstScan_ = sampleCount_;
 	synthesize_data_stream(dest, numberOfScans);
+	streamScans_ += numberOfScans;
+
+	const double sampledSec = double(streamScans_) / fs; // last scan of the chunk
+	double deliverySec = sampledSec;
+	if (transport) {
+		// in order: can't overtake the previous chunk -> chunks held up by a stall come out as a burst
+		deliverySec = std::max(sampledSec + transport_delay_ms() / 1000.0, lastDeliverySec_);
+		lastDelayMs_ = 1000.0 * (deliverySec - sampledSec);
+	}
+	lastDeliverySec_ = deliverySec;
+	pacer_.pace(deliverySec, numberOfScans); // hand it over when the device would have
 	return 1;
 }
 
@@ -1,7 +1,7 @@
 /*
 ==============================================================================
 	File: FakeAcquisition.h
-	Desc: Internally, this module generates a continuous EEG sample stream at 250Hz, 
+	Desc: Internally, this module generates a continuous EEG sample stream at ACQ_FS_HZ (250Hz by default), 
 	mimicking the Unicorn EEG headset. The data is published as fixed size-N chunks,
 	mimicking the UNICORN_GetData() API call.
 	The UNICORN_GetData() returns digitized, scaled EEG values in microvolts, so
@@ -18,6 +18,24 @@
   NOTE: Not designed to be used across multiple threads (no atomics)
   (Should be used in 'producer' only, otherwise race conds could arise)
 
+  PACING (stimConfigs_S::pacing, AcqPacer_C): realtime / speed x fs / unpaced, stream time = scans / fs.
+  getData blocks until the last scan of the chunk would have been sampled, see AcqPacer.hpp
+
+  TRANSPORT (stimConfigs_S::transport, off by default): models the Unicorn's bluetooth link
+  - every chunk gets a delivery delay: base + jitter (uniform or exponential) + now and then a stall
+  - delivery stays in order, so the chunks queued up behind a stall come out back to back (burst)
+  - now and then a run of scans is lost: they're still synthesized (signal stays continuous) but never
+    handed out, the scan counter (get_scan_counter, like the device's Counter channel) jumps over them
+  - latency_ms() = actual delay of the last chunk -> the producer stamps true acquisition times
+  - own rng (seed derived from stimConfigs_S::seed): turning it on doesn't change the signal itself
+
+  SYNTHESIS (per getData call, one block of scans):
+  - noise for the whole block comes from GaussNoise_C in one go (SIMD Box-Muller, see GaussNoise.hpp)
+  - oscillators are phasors (cos, sin) rotated by e^{j dphi} each scan: 4 mul + 2 add instead of a sin()
+    call, SoA over channels so the per-scan channel loops vectorize. Renormalized to |z|=1 after every
+    block (double, so the drift in between is ~1e-14). SSVEP 2f = 2 sin cos of the same phasor
+  - same stimConfigs_S::seed -> same stream
+
 ==============================================================================
 */
 
@@ -27,7 +45,33 @@
 #include "../utils/Types.h" // gives NUM_CH_CHUNK, NUM_SCANS_CHUNK
 #include <random>    // std::mt19937, std::normal_distribution 
 #include "IAcqProvider.h" // IAcqProvider_S
+#include "GaussNoise.hpp"
+#include "AcqPacer.hpp"
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+enum TransportJitter_E {
+	TransportJitter_Uniform = 0,     // [0, 2 x mean]
+	TransportJitter_Exponential,     // long tail, mean
+};
+
+// transport presets (FAKE_ACQ_TRANSPORT in CMake)
+enum FakeTransport_E {
+	FakeTransport_Ideal = 0,   // every chunk on time, nothing lost
+	FakeTransport_Bluetooth,   // typical dongle link: some jitter, short stalls, rare scan loss
+	FakeTransport_Lossy,       // bad link (distance, interference)
+};
+
+inline const char* FakeTransport_to_string(FakeTransport_E t) {
+	switch (t) {
+		case FakeTransport_Ideal:     return "ideal";
+		case FakeTransport_Bluetooth: return "bluetooth";
+		case FakeTransport_Lossy:     return "lossy";
+		default:                      return "unknown";
+	}
+}
 
 class FakeAcquisition_C : public IAcqProvider_S {
 public:
@@ -37,6 +81,19 @@ public:
 		double amp_uV   = 0.0;
     	bool   enabled  = false;
 	};
+	struct transportConfigs_S {
+		bool enabled = false;
+		double baseDelayMs = 20.0;                            // fixed part, on every chunk
+		TransportJitter_E jitter = TransportJitter_Exponential;
+		double jitterMeanMs = 8.0;
+		double stallProb = 0.02;                              // per chunk
+		double stallMinMs = 50.0, stallMaxMs = 300.0;
+		double lossProb = 0.002;                              // per chunk: a run of scans before it is lost
+		std::size_t lossMaxScans = 8;                         // run length uniform in [1, lossMaxScans]
+
+		static transportConfigs_S preset(FakeTransport_E t);
+	};
+
 	struct stimConfigs_S {
 
 		double ssvepAmplitude_uV = 12.0;
@@ -50,6 +107,13 @@ public:
 
 		bool occasionalArtifactsEnabled = 1;
 
+		uint64_t seed = 0xC0FFEEu; // artifacts/per-channel params (mt19937) + noise (GaussNoise_C)
+
+		AcqPacing_E pacing = AcqPacing_RealTime;
+		double speed = 1.0; // only used by AcqPacing_Speed
+
+		transportConfigs_S transport{}; // see TRANSPORT at the top
+
 	}; // stimConfigs_S
 	
 	// Constructors/Destructors
@@ -70,6 +134,12 @@ public:
 
 	bool getData(std::size_t const numberOfScans, float* dest) override; // mirrors Unicorn C API GetData()
 	void setActiveStimulus(double fStimHz); // sets the active stimulus frequency (0 = none)
+	double get_achieved_sps() const { return pacer_.get_achieved_sps(); } // scans/s over the last report period (0 until the first)
+
+	double latency_ms() const override; // delay of the last chunk (transport on), expected one before the first
+	bool get_scan_counter(uint64_t& firstScan) const override { firstScan = firstScan_; return true; }
+	std::size_t get_lost_scans() const { return lostScans_; } // total so far
+	std::size_t get_stalls() const { return stalls_; }
 
 	int getNumChannels() const override {
         return numChannels_;
@@ -80,35 +150,61 @@ public:
     }
 
 private:
-	const double fs = 250.0;
+	const double fs = double(ACQ_FS_HZ);
 	stimConfigs_S configs_{}; // default initiliazer _{}
 	
-	double phaseOffset_ = 0; // persistent variable to keep track of phase offset between synthesize_data_stream function calls for continuity
 	std::size_t sampleCount_ = 0; // running sample counter to stamp each chunk's starting sample index
 	double activeStimulusHz_ = 0.0; // current active stimulus frequency (0 = none)
 
 	// Random sources for noise gen
 	std::mt19937 rng_;
-	std::normal_distribution<double> noiseNorm_{ 0.0, 1.0 }; // std=1; scaled later
 	std::normal_distribution<double> norm01_{0.0, 1.0};   
 	std::uniform_real_distribution<double> uni01_{0.0, 1.0};
-
-	// Phase offsets for the superimposed signals
-	double driftPhase_   = 0.0;
-	double alphaPhase_   = 0.0;
-	double betaPhase_   = 0.0;
-	double linePhase_    = 0.0;
+	GaussNoise_C noise_;            // background noise, whole block at once
+	std::vector<float> noiseBuf_;   // numberOfScans x numChannels_ standard normals
+
+	// oscillator phasors (cos, sin), one per channel, SoA so channel loops vectorize
+	struct PhasorBank_S {
+		std::array<double, NUM_CH_CHUNK> c{};
+		std::array<double, NUM_CH_CHUNK> s{};
+		void set_phase(std::size_t ch, double ph) { c[ch] = std::cos(ph); s[ch] = std::sin(ph); }
+		void rotate(double rc, double rs) {
+			for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+				const double nc = c[ch] * rc - s[ch] * rs;
+				s[ch] = s[ch] * rc + c[ch] * rs;
+				c[ch] = nc;
+			}
+		}
+		void renormalize() {
+			for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+				const double k = 1.5 - 0.5 * (c[ch] * c[ch] + s[ch] * s[ch]); // 1/|z| to first order
+				c[ch] *= k;
+				s[ch] *= k;
+			}
+		}
+	};
+	// global ones (same for every channel)
+	double driftC_ = 1.0, driftS_ = 0.0;
+	double attnC_  = 1.0, attnS_  = 0.0; // slow SSVEP amplitude modulation
+
+	// pacing (see top of file)
+	AcqPacer_C pacer_;
+	std::size_t streamScans_ = 0;   // scans sampled so far (incl. lost ones) -> stream time for the pacer
+
+	// transport (see top of file)
+	std::mt19937 transportRng_;
+	std::vector<float> lostBuf_;    // lost scans get synthesized in here and thrown away
+	uint64_t firstScan_ = 0;        // scan counter of the first scan of the last chunk
+	double lastDeliverySec_ = 0.0;  // stream time the previous chunk was handed over at
+	double lastDelayMs_ = -1.0;     // of the last chunk, -1 = none yet
+	std::size_t lostScans_ = 0;
+	std::size_t stalls_ = 0;
+	double transport_delay_ms();    // draws one chunk's delay
+	void lose_scans();              // maybe drop a run of scans before the next chunk
 
 	// Helpers
 	void synthesize_data_stream(float* dest, std::size_t numberOfScans); // used by mock_GetData
 
-	inline double background_noise_signal(double noise_uV){
-		// per channel Gaussian noise
-		return noise_uV * noiseNorm_(rng_);
-	}
-	inline double stimulus_signal(double sigAmp_uV, double phase){
-		return sigAmp_uV * std::sin(phase);
-	}
 	void maybe_start_artifact();
     double artifact_value_for_channel(std::size_t ch);
 	double randu(double a, double b) { return a + (b - a) * uni01_(rng_); }
@@ -123,14 +219,14 @@ private:
     std::array<double, NUM_CH_CHUNK> chNoiseSigma_{};   // per-channel noise sigma
 
     std::array<double, NUM_CH_CHUNK> chSsvEpGain_{};    // per-channel ssvep amplitude multiplier
-    std::array<double, NUM_CH_CHUNK> chSsvEpPhase_{};   // per-channel ssvep phase offset
+    PhasorBank_S chSsvEp_{};                            // per-channel ssvep phase
 
     std::array<double, NUM_CH_CHUNK> chAlphaGain_{};    // per-channel alpha multiplier
-    std::array<double, NUM_CH_CHUNK> chAlphaPhase_{};   // per-channel alpha phase
+    PhasorBank_S chAlpha_{};                            // per-channel alpha phase
     std::array<double, NUM_CH_CHUNK> chBetaGain_{};     // per-channel beta multiplier
-    std::array<double, NUM_CH_CHUNK> chBetaPhase_{};    // per-channel beta phase
+    PhasorBank_S chBeta_{};                             // per-channel beta phase
     std::array<double, NUM_CH_CHUNK> chLineGain_{};     // per-channel line multiplier
-    std::array<double, NUM_CH_CHUNK> chLinePhase_{};    // per-channel line phase
+    PhasorBank_S chLine_{};                             // per-channel line phase
 
 	// ===================== artifact model =====================
 	enum class ArtifactType { None, Blink, ElectrodePop };
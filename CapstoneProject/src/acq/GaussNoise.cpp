@@ -0,0 +1,254 @@
+#include "GaussNoise.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define GAUSS_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define GAUSS_TARGET_AVX2
+    #else
+        // no fma on purpose: mul+add stays mul+add, so avx2 and scalar round the same way
+        #define GAUSS_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+static constexpr float U24 = 5.9604644775390625e-8f; // 2^-24
+static constexpr float SQRTHF = 0.707106781186547524f;
+static constexpr float TWO_PI_F = 6.28318530717958647692f;
+
+// cephes logf
+static constexpr float LOG_P0 = 7.0376836292e-2f, LOG_P1 = -1.1514610310e-1f, LOG_P2 = 1.1676998740e-1f,
+                       LOG_P3 = -1.2420140846e-1f, LOG_P4 = 1.4249322787e-1f, LOG_P5 = -1.6668057665e-1f,
+                       LOG_P6 = 2.0000714765e-1f, LOG_P7 = -2.4999993993e-1f, LOG_P8 = 3.3333331174e-1f;
+static constexpr float LOG_Q1 = -2.12194440e-4f, LOG_Q2 = 0.693359375f;
+// cephes sinf/cosf on [-pi/4, pi/4]
+static constexpr float SIN_P0 = -1.9515295891e-4f, SIN_P1 = 8.3321608736e-3f, SIN_P2 = -1.6666654611e-1f;
+static constexpr float COS_P0 = 2.443315711809948e-5f, COS_P1 = -1.388731625493765e-3f, COS_P2 = 4.166664568298827e-2f;
+
+static uint64_t splitmix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// ============================ KERNELS ===============================
+// st = [s0 x8, s1 x8, s2 x8, s3 x8]; writes nBlocks * 16 floats (8 cos outputs then 8 sin outputs)
+
+static inline uint32_t xoshiro_next(uint32_t* s, std::size_t l) {
+    uint32_t& s0 = s[l];
+    uint32_t& s1 = s[8 + l];
+    uint32_t& s2 = s[16 + l];
+    uint32_t& s3 = s[24 + l];
+    const uint32_t res = s0 + s3;
+    const uint32_t t = s1 << 9;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = (s3 << 11) | (s3 >> 21);
+    return res;
+}
+
+static void kernel_scalar(uint32_t* st, float* out, std::size_t nBlocks) {
+    for (std::size_t b = 0; b < nBlocks; ++b, out += 16) {
+        for (std::size_t l = 0; l < 8; ++l) {
+            const uint32_t ra = xoshiro_next(st, l);
+            const uint32_t rb = xoshiro_next(st, l);
+
+            // ln(u1), u1 in (0,1]
+            const float u1 = float(int32_t((ra >> 8) + 1)) * U24;
+            const uint32_t bits = std::bit_cast<uint32_t>(u1);
+            int32_t e = int32_t(bits >> 23) - 126;
+            const float m = std::bit_cast<float>((bits & 0x007FFFFFu) | 0x3F000000u); // [0.5, 1)
+            const bool lt = m < SQRTHF;
+            e -= lt ? 1 : 0;
+            const float x = (m - 1.0f) + (lt ? m : 0.0f);
+            const float fe = float(e);
+            const float z = x * x;
+            float y = LOG_P0;
+            y = y * x + LOG_P1; y = y * x + LOG_P2; y = y * x + LOG_P3; y = y * x + LOG_P4;
+            y = y * x + LOG_P5; y = y * x + LOG_P6; y = y * x + LOG_P7; y = y * x + LOG_P8;
+            y = y * x;
+            y = y * z;
+            y = y + fe * LOG_Q1;
+            y = y - 0.5f * z;
+            float lnu = x + y;
+            lnu = lnu + fe * LOG_Q2;
+            const float rad = std::sqrt(std::max(-2.0f * lnu, 0.0f));
+
+            // sincos(2 pi u2), quadrant picked in the u2 domain
+            const float u2 = float(int32_t(rb >> 8)) * U24;
+            const int32_t q = int32_t(u2 * 4.0f + 0.5f);
+            const float a = (u2 - float(q) * 0.25f) * TWO_PI_F;
+            const float a2 = a * a;
+            float sn = SIN_P0;
+            sn = sn * a2 + SIN_P1; sn = sn * a2 + SIN_P2;
+            sn = sn * a2; sn = sn * a; sn = sn + a;
+            float cs = COS_P0;
+            cs = cs * a2 + COS_P1; cs = cs * a2 + COS_P2;
+            cs = cs * a2; cs = cs * a2; cs = cs - 0.5f * a2; cs = cs + 1.0f;
+            float S = (q & 1) ? cs : sn;
+            float C = (q & 1) ? sn : cs;
+            if (q & 2) S = -S;
+            if ((q + 1) & 2) C = -C;
+
+            out[l] = rad * C;
+            out[8 + l] = rad * S;
+        }
+    }
+}
+
+#if defined(GAUSS_SIMD_X86)
+GAUSS_TARGET_AVX2
+static inline __m256i xoshiro_next_avx2(__m256i& s0, __m256i& s1, __m256i& s2, __m256i& s3) {
+    const __m256i res = _mm256_add_epi32(s0, s3);
+    const __m256i t = _mm256_slli_epi32(s1, 9);
+    s2 = _mm256_xor_si256(s2, s0);
+    s3 = _mm256_xor_si256(s3, s1);
+    s1 = _mm256_xor_si256(s1, s2);
+    s0 = _mm256_xor_si256(s0, s3);
+    s2 = _mm256_xor_si256(s2, t);
+    s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+    return res;
+}
+
+GAUSS_TARGET_AVX2
+static void kernel_avx2(uint32_t* st, float* out, std::size_t nBlocks) {
+    __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(st));
+    __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(st + 8));
+    __m256i s2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(st + 16));
+    __m256i s3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(st + 24));
+    const __m256 vU24 = _mm256_set1_ps(U24);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256i signBit = _mm256_set1_epi32(int32_t(0x80000000u));
+    for (std::size_t b = 0; b < nBlocks; ++b, out += 16) {
+        const __m256i ra = xoshiro_next_avx2(s0, s1, s2, s3);
+        const __m256i rb = xoshiro_next_avx2(s0, s1, s2, s3);
+
+        // ln(u1)
+        const __m256 u1 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_srli_epi32(ra, 8), _mm256_set1_epi32(1))), vU24);
+        const __m256i bits = _mm256_castps_si256(u1);
+        __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126));
+        const __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                             _mm256_set1_epi32(0x3F000000)));
+        const __m256 lt = _mm256_cmp_ps(m, _mm256_set1_ps(SQRTHF), _CMP_LT_OQ);
+        e = _mm256_add_epi32(e, _mm256_castps_si256(lt)); // mask is -1 where lt
+        const __m256 x = _mm256_add_ps(_mm256_sub_ps(m, one), _mm256_and_ps(lt, m));
+        const __m256 fe = _mm256_cvtepi32_ps(e);
+        const __m256 z = _mm256_mul_ps(x, x);
+        __m256 y = _mm256_set1_ps(LOG_P0);
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(LOG_P1));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(LOG_P2));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(LOG_P3));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(LOG_P4));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(LOG_P5));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(LOG_P6));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(LOG_P7));
+        y = _mm256_add_ps(_mm256_mul_ps(y, x), _mm256_set1_ps(LOG_P8));
+        y = _mm256_mul_ps(y, x);
+        y = _mm256_mul_ps(y, z);
+        y = _mm256_add_ps(y, _mm256_mul_ps(fe, _mm256_set1_ps(LOG_Q1)));
+        y = _mm256_sub_ps(y, _mm256_mul_ps(half, z));
+        __m256 lnu = _mm256_add_ps(x, y);
+        lnu = _mm256_add_ps(lnu, _mm256_mul_ps(fe, _mm256_set1_ps(LOG_Q2)));
+        const __m256 rad = _mm256_sqrt_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), lnu), _mm256_setzero_ps()));
+
+        // sincos(2 pi u2)
+        const __m256 u2 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(rb, 8)), vU24);
+        const __m256i q = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(u2, _mm256_set1_ps(4.0f)), half));
+        const __m256 a = _mm256_mul_ps(_mm256_sub_ps(u2, _mm256_mul_ps(_mm256_cvtepi32_ps(q), _mm256_set1_ps(0.25f))),
+                                       _mm256_set1_ps(TWO_PI_F));
+        const __m256 a2 = _mm256_mul_ps(a, a);
+        __m256 sn = _mm256_set1_ps(SIN_P0);
+        sn = _mm256_add_ps(_mm256_mul_ps(sn, a2), _mm256_set1_ps(SIN_P1));
+        sn = _mm256_add_ps(_mm256_mul_ps(sn, a2), _mm256_set1_ps(SIN_P2));
+        sn = _mm256_mul_ps(sn, a2);
+        sn = _mm256_mul_ps(sn, a);
+        sn = _mm256_add_ps(sn, a);
+        __m256 cs = _mm256_set1_ps(COS_P0);
+        cs = _mm256_add_ps(_mm256_mul_ps(cs, a2), _mm256_set1_ps(COS_P1));
+        cs = _mm256_add_ps(_mm256_mul_ps(cs, a2), _mm256_set1_ps(COS_P2));
+        cs = _mm256_mul_ps(cs, a2);
+        cs = _mm256_mul_ps(cs, a2);
+        cs = _mm256_sub_ps(cs, _mm256_mul_ps(half, a2));
+        cs = _mm256_add_ps(cs, one);
+
+        const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+        __m256 S = _mm256_blendv_ps(sn, cs, swap);
+        __m256 C = _mm256_blendv_ps(cs, sn, swap);
+        // q&2 -> sign bit (bit 1 shifted up to bit 31)
+        S = _mm256_xor_ps(S, _mm256_castsi256_ps(_mm256_and_si256(_mm256_slli_epi32(q, 30), signBit)));
+        C = _mm256_xor_ps(C, _mm256_castsi256_ps(_mm256_and_si256(_mm256_slli_epi32(_mm256_add_epi32(q, _mm256_set1_epi32(1)), 30), signBit)));
+
+        _mm256_storeu_ps(out, _mm256_mul_ps(rad, C));
+        _mm256_storeu_ps(out + 8, _mm256_mul_ps(rad, S));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(st), s0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(st + 8), s1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(st + 16), s2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(st + 24), s3);
+}
+#endif
+
+// ============================ GaussNoise_C ===============================
+
+GaussNoise_C::GaussNoise_C(uint64_t seed)
+    : GaussNoise_C(seed, fir_simd_path_supported(FirSimd_AVX2) ? FirSimd_AVX2 : FirSimd_Scalar) {}
+
+GaussNoise_C::GaussNoise_C(uint64_t s, FirSimdPath_E path) {
+    // only avx2 has its own kernel, sse/neon would be 2x4 lanes of the same thing -> scalar for now
+    path_ = (path == FirSimd_AVX2 && fir_simd_path_supported(FirSimd_AVX2)) ? FirSimd_AVX2 : FirSimd_Scalar;
+    seed(s);
+}
+
+void GaussNoise_C::seed(uint64_t s) {
+    uint64_t x = s;
+    for (std::size_t l = 0; l < LANES; ++l) {
+        do {
+            const uint64_t a = splitmix64(x);
+            const uint64_t b = splitmix64(x);
+            state_[l] = uint32_t(a);
+            state_[LANES + l] = uint32_t(a >> 32);
+            state_[2 * LANES + l] = uint32_t(b);
+            state_[3 * LANES + l] = uint32_t(b >> 32);
+        } while ((state_[l] | state_[LANES + l] | state_[2 * LANES + l] | state_[3 * LANES + l]) == 0); // all-zero state is stuck
+    }
+    cachePos_ = BLOCK;
+}
+
+void GaussNoise_C::gen_blocks(float* out, std::size_t nBlocks) {
+#if defined(GAUSS_SIMD_X86)
+    if (path_ == FirSimd_AVX2) {
+        kernel_avx2(state_, out, nBlocks);
+        return;
+    }
+#endif
+    kernel_scalar(state_, out, nBlocks);
+}
+
+void GaussNoise_C::fill(float* out, std::size_t n) {
+    // leftovers from the last call first, so the stream doesn't depend on how it's sliced up
+    const std::size_t fromCache = std::min(n, BLOCK - cachePos_);
+    std::memcpy(out, cache_ + cachePos_, fromCache * sizeof(float));
+    cachePos_ += fromCache;
+    out += fromCache;
+    n -= fromCache;
+
+    const std::size_t nBlocks = n / BLOCK;
+    if (nBlocks > 0) {
+        gen_blocks(out, nBlocks);
+        out += nBlocks * BLOCK;
+        n -= nBlocks * BLOCK;
+    }
+    if (n > 0) {
+        gen_blocks(cache_, 1);
+        std::memcpy(out, cache_, n * sizeof(float));
+        cachePos_ = n;
+    }
+}
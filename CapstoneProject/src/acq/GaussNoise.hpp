@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "../utils/FirSimd.hpp" // FirSimdPath_E + cpu detection
+
+/* BATCHED GAUSSIAN NOISE (for FakeAcquisition_C)
+- 8 independent xoshiro128+ streams (one per lane), seeded from one 64 bit seed with splitmix64
+- Box-Muller on 8 lanes at a time: top 24 bits of two draws -> u1 in (0,1], u2 in [0,1),
+  r = sqrt(-2 ln u1), out = r cos(2 pi u2), r sin(2 pi u2) -> 16 normals per step
+- log/sincos are cephes-style float polynomials (no libm calls, so it stays in registers).
+  sincos reduces in the u2 domain (quadrant = round(4 u2), exact in float) -> no range reduction error
+- kernels: AVX2 (8 lanes in one register) or scalar (same ops in the same order, no FMA in either)
+  -> same seed gives the exact same numbers on any path, chunk sizes don't matter either (block cache)
+- |z| is capped at sqrt(-2 ln 2^-24) ~ 5.8 sigma (1 in ~1e8 would go past that with a true normal)
+*/
+
+class GaussNoise_C {
+public:
+    static constexpr std::size_t LANES = 8;
+    static constexpr std::size_t BLOCK = 2 * LANES; // normals per Box-Muller step
+
+    explicit GaussNoise_C(uint64_t seed = 0xC0FFEEu);
+    GaussNoise_C(uint64_t seed, FirSimdPath_E path); // unsupported path -> scalar
+
+    void seed(uint64_t seed);
+    // n standard normals (mean 0, std 1)
+    void fill(float* out, std::size_t n);
+
+    FirSimdPath_E get_path() const { return path_; };
+
+private:
+    FirSimdPath_E path_ = FirSimd_Scalar;
+    uint32_t state_[4 * LANES]{};  // s0 lanes, s1 lanes, s2 lanes, s3 lanes
+    float cache_[BLOCK]{};         // leftover of the last block when n isn't a multiple of BLOCK
+    std::size_t cachePos_ = BLOCK; // next unread in cache_ (BLOCK = empty)
+
+    void gen_blocks(float* out, std::size_t nBlocks);
+};
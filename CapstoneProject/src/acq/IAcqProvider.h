@@ -23,6 +23,11 @@ struct IAcqProvider_S {
 	virtual bool unicorn_stop_and_close() = 0;
 	virtual bool dump_config_and_indices() = 0;
 	virtual void setActiveStimulus(double fStimHz) { }; // default no-op
+	// time from a scan being sampled to getData() handing it over, on top of waiting for the rest of the chunk
+	virtual double latency_ms() const { return 0.0; }
+	// device scan counter of the first scan of the last getData() (jumps when scans get lost in transport);
+	// false if the backend doesn't have one
+	virtual bool get_scan_counter(uint64_t& /*firstScan*/) const { return false; }
 
 	// channel metadata
     virtual int  getNumChannels() const = 0;
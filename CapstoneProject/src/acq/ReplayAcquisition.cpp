@@ -0,0 +1,88 @@
+#include "ReplayAcquisition.h"
+#include "../utils/Logger.hpp"
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+#include <cstring>
+
+ReplayAcquisition_C::ReplayAcquisition_C(const replayConfigs_S& configs) : configs_(configs) {
+}
+
+ReplayAcquisition_C::ReplayAcquisition_C(const replayConfigs_S& configs, AcqRecording_S recording)
+    : configs_(configs), rec_(std::move(recording)), fromMemory_(true) {
+    loaded_ = check_recording();
+}
+
+bool ReplayAcquisition_C::unicorn_init() {
+    if (fromMemory_) return loaded_;
+    std::string err;
+    if (!load_acq_recording(configs_.path, rec_, err)) {
+        LOG_ALWAYS("replay: ERROR loading recording: " << err);
+        return false;
+    }
+    loaded_ = check_recording();
+    return loaded_;
+}
+
+bool ReplayAcquisition_C::check_recording() {
+    if (rec_.nCh == 0 || rec_.nCh > NUM_CH_CHUNK) {
+        LOG_ALWAYS("replay: ERROR recording has " << rec_.nCh << " channels, pipeline is built for " << NUM_CH_CHUNK);
+        return false;
+    }
+    if (std::fabs(rec_.fs - double(ACQ_FS_HZ)) > 1e-6) {
+        LOG_ALWAYS("replay: ERROR recording is " << rec_.fs << " Hz, pipeline is built for " << ACQ_FS_HZ << " (EEG_FS_HZ)"
+                   << (rec_.hasTiming ? "" : "; csv rows are at the rate after the filter bank of the build that wrote them"));
+        return false;
+    }
+    if (rec_.chunks.empty()) {
+        LOG_ALWAYS("replay: ERROR recording is empty");
+        return false;
+    }
+    channelLabels_.resize(rec_.nCh);
+    for (std::size_t i = 0; i < rec_.nCh; ++i) channelLabels_[i] = "Ch" + std::to_string(i + 1);
+
+    pacer_.init("replay", configs_.pacing, configs_.speed, rec_.fs);
+    const double durSec = rec_.chunks.back().t_ms / 1000.0;
+    LOG_ALWAYS("replay: " << (configs_.path.empty() ? std::string("(memory)") : configs_.path) << ": "
+               << rec_.chunks.size() << " chunks, " << rec_.num_scans() << " scans x " << rec_.nCh << " ch, "
+               << durSec << " s" << (rec_.hasTiming ? " (recorded timing)" : " (nominal timing)")
+               << (rec_.segments > 1 ? ", " + std::to_string(rec_.segments) + " stitched segments" : std::string())
+               << (configs_.loop ? ", looping" : ""));
+    return true;
+}
+
+bool ReplayAcquisition_C::getData(std::size_t const numberOfScans, float* dest) {
+    if (!loaded_ || dest == nullptr) return false;
+    if (next_ >= rec_.chunks.size()) {
+        if (!configs_.loop) return false;
+        loopOffsetMs_ += rec_.chunks.back().t_ms;
+        loopOffsetScans_ += rec_.chunks.back().first_scan + rec_.chunks.back().nScans - rec_.chunks.front().first_scan;
+        next_ = 0;
+    }
+    const AcqRecChunk_S& c = rec_.chunks[next_];
+    if (c.nScans != numberOfScans) {
+        LOG_ALWAYS("replay: ERROR chunk " << next_ << " has " << c.nScans << " scans, asked for " << numberOfScans);
+        return false;
+    }
+
+    // recording may have fewer channels than the build: rest stays 0 (disabled channels)
+    const float* src = rec_.data.data() + c.firstScan * rec_.nCh;
+    if (rec_.nCh == NUM_CH_CHUNK) {
+        std::memcpy(dest, src, numberOfScans * NUM_CH_CHUNK * sizeof(float));
+    } else {
+        for (std::size_t s = 0; s < numberOfScans; ++s) {
+            std::memcpy(dest + s * NUM_CH_CHUNK, src + s * rec_.nCh, rec_.nCh * sizeof(float));
+            std::memset(dest + s * NUM_CH_CHUNK + rec_.nCh, 0, (NUM_CH_CHUNK - rec_.nCh) * sizeof(float));
+        }
+    }
+    lastChunk_ = next_++;
+    ++played_;
+    pacer_.pace((loopOffsetMs_ + c.t_ms) / 1000.0, numberOfScans); // hand it over when it originally arrived
+    return true;
+}
+
+bool ReplayAcquisition_C::get_scan_counter(uint64_t& firstScan) const {
+    if (!loaded_ || !rec_.hasCounter || played_ == 0) return false;
+    firstScan = loopOffsetScans_ + rec_.chunks[lastChunk_].first_scan;
+    return true;
+}
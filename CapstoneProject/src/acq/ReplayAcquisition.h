@@ -0,0 +1,80 @@
+/*
+==============================================================================
+	File: ReplayAcquisition.h
+	Desc: Plays a recorded session back through the normal producer path, chunk by chunk, with the
+	labels (ui state + test freq) and timing it was recorded with. Source is an .eegrec from the
+	producer (ACQ_RECORD_FILE) or an eeg_windows.csv / eeg_calib_data.csv, see AcqRecording.hpp.
+
+	- same data every run -> field issues reproduce exactly, consumer/SQA/classifier can be
+	  benchmarked on real EEG (unpaced) and latency can be regression tested without a headset
+	- pacing is AcqPacer_C (realtime / speed / unpaced). Stream time is the recorded hand-over time
+	  of each chunk, so realtime replay also brings back the original arrival jitter (csv: nominal rate)
+	- the chunk's recorded labels are available via get_chunk_meta() after each getData(); the
+	  producer stamps them onto the chunk so the consumer sees the session as it was recorded
+	- the recorded scan counter comes back through get_scan_counter(), so the producer sees the same
+	  transport gaps (lost_scans) as the original session
+	- end of recording: getData() returns false, unless loop is set
+
+	NOTE: producer thread only, same as the other providers
+==============================================================================
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include "AcqRecording.hpp"
+#include "AcqPacer.hpp"
+#include "IAcqProvider.h"
+
+class ReplayAcquisition_C : public IAcqProvider_S {
+public:
+	struct replayConfigs_S {
+		std::string path;
+		AcqPacing_E pacing = AcqPacing_RealTime;
+		double speed = 1.0;    // only used by AcqPacing_Speed
+		bool loop = false;     // start over at the end instead of running dry
+	};
+
+	explicit ReplayAcquisition_C(const replayConfigs_S& configs);
+	// or straight from memory (tests)
+	ReplayAcquisition_C(const replayConfigs_S& configs, AcqRecording_S recording);
+
+	ReplayAcquisition_C(const ReplayAcquisition_C&) = delete;
+	ReplayAcquisition_C& operator=(const ReplayAcquisition_C&) = delete;
+
+	// Lifecycle methods to match IAcqProvider_S interface
+	bool unicorn_init() override; // loads + checks the recording
+	bool unicorn_start_acq(bool /*testMode*/) override { return loaded_; } // no test signal in a recording
+	bool unicorn_stop_and_close() override { return true; }
+	bool dump_config_and_indices() override { return true; }
+
+	// numberOfScans has to match the recording's chunks (NUM_SCANS_CHUNK); false at the end / on mismatch
+	bool getData(std::size_t const numberOfScans, float* dest) override;
+
+	// recorded device counter of the last getData() (false if the recording has none); keeps counting up when looping
+	bool get_scan_counter(uint64_t& firstScan) const override;
+
+	int getNumChannels() const override { return static_cast<int>(rec_.nCh); }
+	void getChannelLabels(std::vector<std::string>& out) const override { out = channelLabels_; }
+
+	const AcqRecChunk_S& get_chunk_meta() const { return rec_.chunks[lastChunk_]; } // of the last getData()
+	std::size_t get_num_chunks() const { return rec_.chunks.size(); }
+	std::size_t get_chunks_played() const { return played_; }
+	double get_achieved_sps() const { return pacer_.get_achieved_sps(); }
+
+private:
+	replayConfigs_S configs_{};
+	AcqRecording_S rec_{};
+	bool loaded_ = false;
+	bool fromMemory_ = false;
+	std::vector<std::string> channelLabels_;
+	AcqPacer_C pacer_;
+
+	std::size_t next_ = 0;        // next chunk to hand out
+	std::size_t lastChunk_ = 0;
+	std::size_t played_ = 0;
+	double loopOffsetMs_ = 0.0;   // stream time of the previous passes when looping
+	uint64_t loopOffsetScans_ = 0; // same for the scan counter
+
+	bool check_recording();
+};
@@ -11,6 +11,8 @@
 #include "../../unicorn/include/unicorn.h"
 
 inline constexpr int UNICORN_SAMPLING_RATE_HZ = UNICORN_SAMPLING_RATE;
+// bluetooth transfer + driver buffering before GetData returns a scan. rough estimate, not measured yet
+inline constexpr double UNICORN_TRANSPORT_LATENCY_MS = 20.0;
 
 // Simple exception type for hard failures
 struct unicorn_error : std::runtime_error {
@@ -1,8 +1,13 @@
 #include "UnicornDriver.h"
 #include "../../unicorn/include/unicorn.h"
+#include "../utils/Types.h"
 #include <cstring>
 #include <vector>
 
+// the unicorn is 8 ch @ 250 Hz; other EEG_NUM_CHANNELS / EEG_FS_HZ builds are fake acq only
+static_assert(NUM_CH_CHUNK == UNICORN_EEG_CHANNELS_COUNT, "unicorn backend needs EEG_NUM_CHANNELS=8");
+static_assert(ACQ_FS_HZ == UNICORN_SAMPLING_RATE, "unicorn backend needs EEG_FS_HZ=250");
+
 // Constructor
 UnicornDriver_C::UnicornDriver_C(){
     handle = {};
@@ -72,7 +77,14 @@ bool UnicornDriver_C::set_configuration(UNICORN_HANDLE &handle){
         // store labels in order
         channelLabels_.emplace_back(cfg.Channels[ch].name); // char name[32] -> unicorn exposes c style array for name
     }
+    // 3) + the sample counter: jumps when bluetooth loses scans (stripped out again in getData)
+    cfg.Channels[UNICORN_COUNTER_CONFIG_INDEX].enabled = 1;
     UCHECK(UNICORN_SetConfiguration(handle,&cfg));
+
+    uint32_t idx = 0;
+    counterIdx_ = (UNICORN_GetChannelIndex(handle, "Counter", &idx) == UNICORN_ERROR_SUCCESS) ? static_cast<int>(idx) : -1;
+    UCHECK(UNICORN_GetNumberOfAcquiredChannels(handle, &numAcqCh_));
+    if (counterIdx_ < 0) LOG_ALWAYS("WARN: no Counter channel, lost scans won't be detected");
     return true;
 }
 
@@ -171,9 +183,13 @@ bool UnicornDriver_C::unicorn_stop_and_close(){
 
 // use this to directly write into bufferchunk_s
 bool UnicornDriver_C::getData(size_t numberOfScans, float* dest){
-	uint32_t numAcqCh = 0; // number of enabled channels
-  	UCHECK(UNICORN_GetNumberOfAcquiredChannels(handle, &numAcqCh));
-	const uint32_t needed = numberOfScans * numAcqCh;
-	UCHECK(UNICORN_GetData(handle, numberOfScans, dest, needed));
+	// acquired scan = 8 EEG (config order, so first) + counter
+	const uint32_t needed = numberOfScans * numAcqCh_;
+	scanBuf_.resize(needed);
+	UCHECK(UNICORN_GetData(handle, numberOfScans, scanBuf_.data(), needed));
+	for (size_t s = 0; s < numberOfScans; ++s) {
+		std::memcpy(dest + s * NUM_CH_CHUNK, scanBuf_.data() + s * numAcqCh_, NUM_CH_CHUNK * sizeof(float));
+	}
+	if (counterIdx_ >= 0) firstCounter_ = static_cast<uint64_t>(scanBuf_[counterIdx_]); // exact as float up to 2^24 scans (~18 h)
 	return true;
 }
\ No newline at end of file
@@ -18,7 +18,9 @@ public:
 	bool dump_config_and_indices();
 	//bool unicorn_read_one_sample(eeg_sample_t& sample); // uses provider's getdata call to transform into sample format
 	bool getData(std::size_t numberOfScans, float* dest) override; // single chunk from getdata()
-	
+	double latency_ms() const override { return UNICORN_TRANSPORT_LATENCY_MS; }
+	bool get_scan_counter(uint64_t& firstScan) const override { firstScan = firstCounter_; return counterIdx_ >= 0; }
+
 	int getNumChannels() const override { return numChannels_; }
     void getChannelLabels(std::vector<std::string>& out) const override { out = channelLabels_; }
 
@@ -33,6 +35,11 @@ private:
 	// Channel configs
 	int numChannels_ = 0;
 	std::vector<std::string> channelLabels_;
+	// Counter channel is acquired too (gap detection), getData() strips it out of the scans
+	int counterIdx_ = -1;           // within an acquired scan, -1 = not available
+	uint32_t numAcqCh_ = 0;
+	std::vector<float> scanBuf_;    // numberOfScans x numAcqCh_ straight from the device
+	uint64_t firstCounter_ = 0;
 	// Opaque Device Handles
 	UNICORN_HANDLE handle{};
 	UNICORN_DEVICE_SERIAL serial{};
@@ -1,22 +1,36 @@
 #pragma once
 #include "../utils/Types.h"
-#include "../utils/RingBuffer.hpp"
+#include "../utils/MirroredRingBuffer.hpp"
+#include <span>
 
 // unicorn sampling rate of 250 Hz means 1 scan is about 4ms (or, 32 scans per getData() call is about 128ms)
-inline constexpr std::size_t WINDOW_SCANS         = NUM_SCANS_CHUNK*20;     // 640 samples @250Hz (sampling period 4ms), this is 2.56s
-inline constexpr std::size_t WINDOW_HOP_SCANS     = 80;      // every 0.32s (87.5% overlap) 
+// windows are defined in time and sized at the rate the consumer actually gets (PIPELINE_FS_HZ, after decimation)
+inline constexpr std::size_t WINDOW_MS            = 2560;    // 20 chunks
+inline constexpr std::size_t WINDOW_HOP_MS        = 320;     // 87.5% overlap
+inline constexpr std::size_t WINDOW_TRIM_MS       = 160;     // cut from each end of calib windows (filter edge junk)
+inline constexpr std::size_t WINDOW_SCANS         = WINDOW_MS * PIPELINE_FS_HZ / 1000;     // 640 @250Hz, 320 @125Hz
+inline constexpr std::size_t WINDOW_HOP_SCANS     = WINDOW_HOP_MS * PIPELINE_FS_HZ / 1000; // 80 @250Hz, 40 @125Hz
+inline constexpr std::size_t WINDOW_TRIM_SCANS    = WINDOW_TRIM_MS * PIPELINE_FS_HZ / 1000; // 40 @250Hz, 20 @125Hz
+static_assert(WINDOW_SCANS % NUM_SCANS_CHUNK_OUT == 0, "window should be a whole number of chunks");
+static_assert(WINDOW_HOP_SCANS * 1000 == WINDOW_HOP_MS * PIPELINE_FS_HZ, "hop must be a whole number of scans");
 
 struct sliding_window_t {
     size_t const winLen = WINDOW_SCANS*NUM_CH_CHUNK;
     size_t const winHop = WINDOW_HOP_SCANS*NUM_CH_CHUNK; // amount to jump for next window
+
+    // oldest sample vs newest one in a full window (what windowing adds to the age of the data at a decision)
+    static constexpr double latency_ms() { return 1000.0 * double(WINDOW_SCANS - 1) / double(PIPELINE_FS_HZ); }
+    // acquisition time (bufferChunk_S::epoch_ms clock) of the newest scan pushed, and of the first scan in stash
+    double newest_epoch_ms = 0.0;
+    double stash_epoch_ms = 0.0;
     
 	std::size_t tick = 0; // contains number of bufferchunk samples in window
 	
-	RingBuffer_C<float> sliding_window{WINDOW_SCANS*NUM_CH_CHUNK}; // major interleaved samples ; take by iterating over buffer chunks in ring buffer
-	std::vector<float> trimmed_window;
+	MirroredRingBuffer_C<float> sliding_window{WINDOW_SCANS*NUM_CH_CHUNK}; // major interleaved samples ; always readable as one contiguous span (view())
+	std::span<const float> trimmed_window; // view into sliding_window (valid until the next hop)
 	bool isTrimmed = 0;
 
-	std::array<float, NUM_SAMPLES_CHUNK> stash{}; // overflow storage
+	std::array<float, NUM_SAMPLES_CHUNK> stash{}; // overflow storage (decimated chunks only use the front)
 	std::size_t stash_len = 0; // how many floats in stash are valid
 
 	// Window quality score to detect artifacts
@@ -1,9 +1,11 @@
 #pragma once
+#include <array>
 #include <vector>
 #include "../utils/Types.h"
 #include "ONNXClassifier.hpp"
 #include "../acq/UnicornCheck.h"
 #include "../acq/WindowConfigs.hpp"
+#include "../utils/SpectralCache.hpp"
 
 enum class FeatureKind_E {
     // TODO
@@ -12,23 +14,14 @@ enum class FeatureKind_E {
 };
 
 struct FeatureCache_S {
-    // Individual channel datastreams cached once per window
-    std::vector<float> ch1;
-    std::vector<float> ch2;
-    std::vector<float> ch3;
-    std::vector<float> ch4;
-    std::vector<float> ch5;
-    std::vector<float> ch6;
-    std::vector<float> ch7;
-    std::vector<float> ch8;
-    std::size_t fs = UNICORN_SAMPLING_RATE_HZ;
+    // Individual channel datastreams cached once per window (ch[0] = EEG1, ...)
+    std::array<std::vector<float>, NUM_CH_CHUNK> ch;
+    std::size_t fs = PIPELINE_FS_HZ; // windows are at the decimated rate (ACQ_FS_HZ / EEG_DECIMATION), not ACQ_FS_HZ
 
-    // TODO: Cache for expensive features so we dont reconstruct objects every window (fourier/AR)
-    bool mag_computed_this_window = false;
-    std::vector<float> mag;
-    bool psd_computed_this_window = false;
-    std::vector<float> freq;
-    std::vector<float> power;
+    // window spectrum: the consumer's SpectralCache_C (already computed for this window by SQA, compute() again
+    // is a no-op) -> psd / band_power / snr_at for SSVEP features, no FFT of our own
+    // TODO: AR cache
+    const SpectralCache_C* spectrum = nullptr;
 };
 
 class FeatureVector_C {
@@ -38,10 +31,10 @@ public:
     // to set configs after default construction:
     void setConfigs(const OnnxConfigs_S& cfgs);
 
-    std::vector<float> write_feature_vector(sliding_window_t window);
+    std::vector<float> write_feature_vector(const sliding_window_t& window); // reads window.sliding_window.view() in place
 private:
     float compute_one_feature(FeatureKind_E ftrKind);
-    void extract_individual_channel_vectors(sliding_window_t window, std::vector<float>* ch1, std::vector<float>* ch2, std::vector<float>* ch3, std::vector<float>* ch4,std::vector<float>* ch5,std::vector<float>* ch6,std::vector<float>* ch7,std::vector<float>* ch8);
+    void extract_individual_channel_vectors(const sliding_window_t& window, std::array<std::vector<float>, NUM_CH_CHUNK>& out);
 
     const OnnxConfigs_S& cfgs_; // ref to classifier meta
     FeatureCache_S cache_;
@@ -2,6 +2,10 @@
 #include <string>
 #include <vector>
 
+// decision is made as soon as the window is full -> no algorithmic delay of its own.
+// its compute time goes in /latency decision_compute_ms once run mode calls it (only SQA is timed there now)
+inline constexpr double CLASSIFIER_LATENCY_MS = 0.0;
+
 // Struct holding configs from ONNX JSON (Python training)
 struct OnnxConfigs_S {
     std::vector<std::string> feat_names; // global order for full feature vector
@@ -1,5 +1,9 @@
 #pragma once
 #include "../utils/Types.h"
+#include "../utils/BroadcastRingBuffer.hpp"
+#include "../utils/SpscRingBuffer.hpp"
+#include "../utils/FilterCoeffs.hpp"
+#include "../utils/LatencyStats.hpp"
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
@@ -43,20 +47,108 @@ struct StateStore_s{
     std::atomic<TestFreq_E> g_freq_hz_e{TestFreq_None};
     std::atomic<int> g_freq_hz{0};
 
-    // ============ For displaying signal in real-time on UI (hardware checks page) ============
-    std::atomic<bool> g_hasEegChunk{false};
-    // custom types require mutex protection
-    mutable std::mutex last_chunk_mutex;
-    bufferChunk_S g_lastEegChunk;
-    // helper so UI reads last chunk
-    bufferChunk_S get_lastEegChunk() const {
-        std::lock_guard<std::mutex> lock(last_chunk_mutex);
-        return g_lastEegChunk;  // return by value (copy)
-    }
-    // helper so backend (producer) sets last chunk
-    void set_lastEegChunk(const bufferChunk_S& v) {
-        std::lock_guard<std::mutex> lock(last_chunk_mutex);
-        g_lastEegChunk = v;
+    // ============ Filtered chunk stream (1 producer -> N subscribers) ============
+    // producer publishes every filtered chunk; UI live view / recorder / classifier each subscribe
+    // with their own cursor. Lock-free + the producer never waits on a slow reader.
+    BroadcastRingBuffer_C<bufferChunk_S> eeg_stream{EEG_STREAM_CAPACITY};
+
+    // ============ Acquisition queue telemetry (producer -> decoder chunk queue) ============
+    // producer copies rb.get_stats() in here after every commit; atomics so nobody waits on anybody
+    struct AcqQueueTelemetry_s {
+        std::atomic<int> policy{OverflowPolicy_Block};
+        std::atomic<size_t> capacity{0};
+        std::atomic<size_t> depth{0};
+        std::atomic<size_t> high_water{0};
+        std::atomic<uint64_t> pushed{0};
+        std::atomic<uint64_t> dropped_oldest{0};
+        std::atomic<uint64_t> dropped_newest{0};
+        std::atomic<uint64_t> producer_blocks{0};
+
+        void store(const SpscQueueStats_S& st) {
+            policy.store(st.policy, std::memory_order_relaxed);
+            capacity.store(st.capacity, std::memory_order_relaxed);
+            depth.store(st.depth, std::memory_order_relaxed);
+            high_water.store(st.high_water, std::memory_order_relaxed);
+            pushed.store(st.pushed, std::memory_order_relaxed);
+            dropped_oldest.store(st.dropped_oldest, std::memory_order_relaxed);
+            dropped_newest.store(st.dropped_newest, std::memory_order_relaxed);
+            producer_blocks.store(st.producer_blocks, std::memory_order_relaxed);
+        }
+        SpscQueueStats_S load() const {
+            SpscQueueStats_S st;
+            st.policy = static_cast<OverflowPolicy_E>(policy.load(std::memory_order_relaxed));
+            st.capacity = capacity.load(std::memory_order_relaxed);
+            st.depth = depth.load(std::memory_order_relaxed);
+            st.high_water = high_water.load(std::memory_order_relaxed);
+            st.pushed = pushed.load(std::memory_order_relaxed);
+            st.dropped_oldest = dropped_oldest.load(std::memory_order_relaxed);
+            st.dropped_newest = dropped_newest.load(std::memory_order_relaxed);
+            st.producer_blocks = producer_blocks.load(std::memory_order_relaxed);
+            return st;
+        }
+    };
+    AcqQueueTelemetry_s acq_queue;
+
+    // ============ Transport: chunk arrival + gaps (see ChunkGapTracker.hpp) ============
+    // producer: arrivals + scan counter jumps; consumer: gaps it saw + windows it held back because of them
+    struct TransportTelemetry_s {
+        LatencyHistogram_C interarrival_ms;          // getData() hand-over to hand-over (bursts ~0, stalls long)
+        std::atomic<uint64_t> counter_lost_scans{0}; // producer: device scan counter jumps
+        std::atomic<uint64_t> counter_gaps{0};
+        std::atomic<uint64_t> gaps{0};               // consumer: counter jumps + dropped chunks (tick jumps)
+        std::atomic<uint64_t> dropped_chunks{0};
+        std::atomic<uint64_t> lost_scans{0};
+        std::atomic<uint64_t> gap_windows{0};        // full windows not handed out, a gap inside
+    };
+    TransportTelemetry_s transport;
+
+    // ============ Line noise (adaptive notch in the filter bank) ============
+    // producer copies the notch state in here after every chunk; atomics like acq_queue
+    struct LineNoiseTelemetry_s {
+        std::atomic<double> freq_hz{0.0};      // tracked mains freq
+        std::atomic<double> nominal_hz{0.0};
+        std::atomic<size_t> harmonics{0};
+        std::array<std::atomic<float>, NUM_CH_CHUNK> line_uv_rms{};   // line amplitude being removed
+        std::array<std::atomic<float>, NUM_CH_CHUNK> residual_uv2{};  // line power left after the notch
+    };
+    LineNoiseTelemetry_s line_noise;
+
+    // ============ Pipeline latency (see LatencyStats.hpp) ============
+    // declared per stage: producer writes device/chunk/filter (filter again after a swap), consumer window/classifier.
+    // measured at every decision by the consumer
+    struct LatencyTelemetry_s {
+        std::atomic<double> device_ms{0.0};
+        std::atomic<double> chunk_ms{0.0};
+        std::atomic<double> filter_ms{0.0};
+        std::atomic<double> window_ms{0.0};
+        std::atomic<double> classifier_ms{0.0};
+        LatencyHistogram_C age_newest_ms;       // newest sample in the window
+        LatencyHistogram_C age_oldest_ms;       // oldest sample in the window
+        LatencyHistogram_C decision_compute_ms; // SQA check per window (all the consumer computes per window so far)
+    };
+    LatencyTelemetry_s latency;
+
+    // ============ Bandpass coefficient hot swap (HTTP -> producer -> filter bank) ============
+    // HTTP drops a request here, producer picks it up next chunk and hands it to the filter bank
+    // (which loads it on its own thread). Producer copies the filter bank status back when it changes.
+    struct FilterStatus_s {
+        std::string active_id;
+        std::string engine;
+        size_t taps = 0;
+        double group_delay_ms = 0.0;
+        bool swap_in_progress = false;
+        std::string last_error;
+        unsigned swaps = 0;
+        FilterCoeffSet_S coeffs; // active set (consumer re-runs it zero-phase for the calib export)
+    };
+    mutable std::mutex filter_mtx;
+    std::string filter_request_file;
+    std::string filter_request_id;
+    std::atomic<bool> g_filter_swap_requested{false};
+    FilterStatus_s filter_status;
+    FilterStatus_s get_filter_status() const {
+        std::lock_guard<std::mutex> lock(filter_mtx);
+        return filter_status;
     }
 
     // ============= Running statistic measures of EEG (rolling 45s) for bad window detection/removal ============================
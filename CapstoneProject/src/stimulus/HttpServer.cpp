@@ -14,12 +14,14 @@
 
 // Constructor
 HttpServer_C::HttpServer_C(StateStore_s& stateStoreRef, int port) : stateStoreRef_(stateStoreRef), liveServerRef_(nullptr), port_(port) {
+    eegStreamSubId_ = stateStoreRef_.eeg_stream.subscribe("http_live_view");
 }
 
 // Destructor 
 HttpServer_C::~HttpServer_C() {
     // need to unallocate dynamically allocated ptr ref (done w 'new')
     delete liveServerRef_;
+    stateStoreRef_.eeg_stream.unsubscribe(eegStreamSubId_);
 }
 
 // ============= Helpers ============
@@ -29,6 +31,18 @@ static inline void set_cors_headers(httplib::Response& res) {
     res.set_header("Access-Control-Allow-Headers", "Content-Type");
 }
 
+// quotes/backslashes/control chars -> safe inside a JSON string (error msgs can contain paths, quotes)
+static std::string json_escape(const std::string& in) {
+    std::string out;
+    out.reserve(in.size());
+    for (char c : in) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if (static_cast<unsigned char>(c) < 0x20) { out += ' '; }
+        else { out += c; }
+    }
+    return out;
+}
+
 // Writes JSON string into httplib:response body with correct CORS header
 void HttpServer_C::write_json(httplib::Response& res, std::string_view json_body) const {
     set_cors_headers(res);
@@ -288,7 +302,36 @@ void HttpServer_C::handle_get_quality(const httplib::Request& req,
     write_arr("max_abs_uv",  rollingStats.max_abs_uv);  oss << ",";
     write_arr("max_step_uv", rollingStats.max_step_uv); oss << ",";
     write_arr("kurt",        rollingStats.kurt);        oss << ",";
-    write_arr("entropy",     rollingStats.entropy);
+    write_arr("entropy",     rollingStats.entropy);     oss << ",";
+    write_arr("spec_entropy", rollingStats.spec_entropy); oss << ",";
+    write_arr("line_ratio",  rollingStats.line_ratio);  oss << ",";
+    write_arr("alpha_uv2",   rollingStats.alpha_uv2);   oss << ",";
+    write_arr("emg_uv2",     rollingStats.emg_uv2);
+    oss << "},";
+
+    // spread over the same windows (min / median / max of the per-window values)
+    auto write_spread = [&](const char* key, const Stats_s& st){
+        oss << "\"" << key << "\":{";
+        write_arr("std_uv",  st.std_uv);  oss << ",";
+        write_arr("rms_uv",  st.rms_uv);  oss << ",";
+        write_arr("kurt",    st.kurt);    oss << ",";
+        write_arr("entropy", st.entropy);
+        oss << "},";
+    };
+    write_spread("rolling_min",    ss.rollingMin);
+    write_spread("rolling_median", ss.rollingMedian);
+    write_spread("rolling_max",    ss.rollingMax);
+
+    // robust per-channel baseline (median/MAD/p01/p99 since start) + the artifact thresholds it gives
+    const RobustStats_s& rb = ss.robust;
+    oss << "\"robust\":{";
+    write_arr("median_uv",      rb.median_uv);      oss << ",";
+    write_arr("mad_uv",         rb.mad_uv);         oss << ",";
+    write_arr("p01_uv",         rb.p01_uv);         oss << ",";
+    write_arr("p99_uv",         rb.p99_uv);         oss << ",";
+    write_arr("amp_thresh_uv",  rb.amp_thresh_uv);  oss << ",";
+    write_arr("step_thresh_uv", rb.step_thresh_uv); oss << ",";
+    oss << "\"adaptive\":" << (rb.adaptive ? "true" : "false");
     oss << "},";
 
     // summary rates (rolling + overall)
@@ -296,7 +339,46 @@ void HttpServer_C::handle_get_quality(const httplib::Request& req,
         << "\"current_bad_win_rate\":" << ss.current_bad_win_rate << ","
         << "\"overall_bad_win_rate\":" << ss.overall_bad_win_rate << ","
         << "\"num_win_in_rolling\":"   << ss.num_win_in_rolling
-        << "}";
+        << "},";
+
+    // acquisition queue health: worst-case queueing delay = high_water chunks
+    const SpscQueueStats_S q = stateStoreRef_.acq_queue.load();
+    const double chunk_ms = 1000.0 * NUM_SCANS_CHUNK / ACQ_FS_HZ;
+    oss << "\"acq_queue\":{"
+        << "\"policy\":\"" << OverflowPolicy_to_string(q.policy) << "\","
+        << "\"capacity\":"        << q.capacity << ","
+        << "\"depth\":"           << q.depth << ","
+        << "\"high_water\":"      << q.high_water << ","
+        << "\"high_water_ms\":"   << (q.high_water * chunk_ms) << ","
+        << "\"pushed\":"          << q.pushed << ","
+        << "\"dropped_oldest\":"  << q.dropped_oldest << ","
+        << "\"dropped_newest\":"  << q.dropped_newest << ","
+        << "\"producer_blocks\":" << q.producer_blocks
+        << "},";
+
+    // transport: chunk arrival jitter + gaps (lost scans / dropped chunks) and what they cost in windows
+    const auto& tr = stateStoreRef_.transport;
+    oss << "\"transport\":{"
+        << "\"interarrival_p50_ms\":"  << tr.interarrival_ms.percentile(0.50) << ","
+        << "\"interarrival_p99_ms\":"  << tr.interarrival_ms.percentile(0.99) << ","
+        << "\"chunks\":"               << tr.interarrival_ms.get_count() << ","
+        << "\"counter_gaps\":"         << tr.counter_gaps.load(std::memory_order_relaxed) << ","
+        << "\"counter_lost_scans\":"   << tr.counter_lost_scans.load(std::memory_order_relaxed) << ","
+        << "\"gaps\":"                 << tr.gaps.load(std::memory_order_relaxed) << ","
+        << "\"dropped_chunks\":"       << tr.dropped_chunks.load(std::memory_order_relaxed) << ","
+        << "\"lost_scans\":"           << tr.lost_scans.load(std::memory_order_relaxed) << ","
+        << "\"gap_windows\":"          << tr.gap_windows.load(std::memory_order_relaxed)
+        << "},";
+
+    // line noise from the adaptive notch (0 harmonics = filters off / not running yet)
+    const auto& ln = stateStoreRef_.line_noise;
+    oss << "\"line_noise\":{"
+        << "\"freq_hz\":"    << ln.freq_hz.load(std::memory_order_relaxed) << ","
+        << "\"nominal_hz\":" << ln.nominal_hz.load(std::memory_order_relaxed) << ","
+        << "\"harmonics\":"  << ln.harmonics.load(std::memory_order_relaxed) << ",";
+    write_arr("line_uv_rms",  ln.line_uv_rms);  oss << ",";
+    write_arr("residual_uv2", ln.residual_uv2);
+    oss << "}";
 
     oss << "}";
     write_json(res, oss.str());
@@ -308,12 +390,14 @@ void HttpServer_C::handle_get_eeg(const httplib::Request& req,
 {
     (void)req;
 
-    if (!stateStoreRef_.g_hasEegChunk.load(std::memory_order_acquire)) {
+    if (eegStreamSubId_ < 0 || stateStoreRef_.eeg_stream.get_published() == 0) {
         write_json(res, "{\"ok\":false,\"msg\":\"no eeg yet\"}");
         return;
     }
 
-    bufferChunk_S last = stateStoreRef_.get_lastEegChunk();
+    // everything new since the last poll (capped), so the plot has no gaps/repeats
+    std::lock_guard<std::mutex> lock(eeg_live_mtx_);
+    const size_t n_chunks = stateStoreRef_.eeg_stream.read_newest(eegStreamSubId_, eegLiveBuf_.data(), eegLiveBuf_.size());
 
     int n_ch = stateStoreRef_.g_n_eeg_channels.load(std::memory_order_acquire);
     if (n_ch <= 0 || n_ch > NUM_CH_CHUNK) {
@@ -321,12 +405,11 @@ void HttpServer_C::handle_get_eeg(const httplib::Request& req,
     }
 
     const int stride = NUM_CH_CHUNK; // interleave stride in bufferChunk_S
-    const int samples_per_channel = NUM_SAMPLES_CHUNK / stride;
 
     std::ostringstream oss;
     oss << "{"
         << "\"ok\":true,"
-        << "\"fs\":250,"
+        << "\"fs\":" << PIPELINE_FS_HZ << ","
         << "\"units\":\"uV\","
         << "\"n_channels\":" << n_ch << ",";
 
@@ -339,14 +422,31 @@ void HttpServer_C::handle_get_eeg(const httplib::Request& req,
     }
     oss << "],";
 
-    // channels
+    // stream health for this reader
+    for (const StreamSubscriberStats_S& st : stateStoreRef_.eeg_stream.get_stats()) {
+        if (st.name != "http_live_view") continue;
+        oss << "\"stream\":{"
+            << "\"lag\":" << st.lag << ","
+            << "\"dropped\":" << st.dropped << ","
+            << "\"overruns\":" << st.overruns
+            << "},";
+        break;
+    }
+
+    // channels (chunks back to back, oldest first)
     oss << "\"channels\":[";
     for (int ch = 0; ch < n_ch; ++ch) {
         oss << "[";
-        for (int s = 0; s < samples_per_channel; ++s) {
-            int idx = s * stride + ch;  // time-major interleave
-            oss << last.data[idx];
-            if (s < samples_per_channel - 1) oss << ",";
+        bool first = true;
+        for (size_t c = 0; c < n_chunks; ++c) {
+            const bufferChunk_S& chunk = eegLiveBuf_[c];
+            const int samples_per_chunk = static_cast<int>(chunk.numScans); // after decimation, if any
+            for (int s = 0; s < samples_per_chunk; ++s) {
+                int idx = s * stride + ch;  // time-major interleave
+                if (!first) oss << ",";
+                oss << chunk.data[idx];
+                first = false;
+            }
         }
         oss << "]";
         if (ch < n_ch - 1) oss << ",";
@@ -357,6 +457,86 @@ void HttpServer_C::handle_get_eeg(const httplib::Request& req,
 }
 
 
+// bandpass coeff status (which set is live, engine, last load error)
+void HttpServer_C::handle_get_filter(const httplib::Request& req, httplib::Response& res){
+    (void)req;
+    const StateStore_s::FilterStatus_s st = stateStoreRef_.get_filter_status();
+    std::ostringstream oss;
+    oss << "{"
+        << "\"active_id\":\"" << json_escape(st.active_id) << "\","
+        << "\"engine\":\"" << json_escape(st.engine) << "\","
+        << "\"taps\":" << st.taps << ","
+        << "\"group_delay_ms\":" << st.group_delay_ms << ","
+        << "\"swap_in_progress\":" << (st.swap_in_progress ? "true" : "false") << ","
+        << "\"swaps\":" << st.swaps << ","
+        << "\"last_error\":\"" << json_escape(st.last_error) << "\""
+        << "}";
+    write_json(res, oss.str());
+}
+
+// declared latency per stage + measured sample age at decision time (p50/p99 since startup)
+void HttpServer_C::handle_get_latency(const httplib::Request& req, httplib::Response& res){
+    (void)req;
+    const StateStore_s::LatencyTelemetry_s& lt = stateStoreRef_.latency;
+    const double device = lt.device_ms.load(std::memory_order_relaxed);
+    const double chunk = lt.chunk_ms.load(std::memory_order_relaxed);
+    const double filter = lt.filter_ms.load(std::memory_order_relaxed);
+    const double window = lt.window_ms.load(std::memory_order_relaxed);
+    const double classifier = lt.classifier_ms.load(std::memory_order_relaxed);
+    auto hist = [](const LatencyHistogram_C& h) {
+        std::ostringstream o;
+        o << "{\"p50\":" << h.percentile(0.50) << ",\"p99\":" << h.percentile(0.99) << ",\"n\":" << h.get_count() << "}";
+        return o.str();
+    };
+    std::ostringstream oss;
+    oss << "{"
+        << "\"budget_ms\":{"
+        << "\"device\":" << device << ","
+        << "\"chunk\":" << chunk << ","
+        << "\"filter\":" << filter << ","
+        << "\"window\":" << window << ","
+        << "\"classifier\":" << classifier << ","
+        << "\"total\":" << (device + chunk + filter + window + classifier) << "},"
+        << "\"age_newest_ms\":" << hist(lt.age_newest_ms) << ","
+        << "\"age_oldest_ms\":" << hist(lt.age_oldest_ms) << ","
+        << "\"decision_compute_ms\":" << hist(lt.decision_compute_ms)
+        << "}";
+    write_json(res, oss.str());
+}
+
+// coeff files live next to DEFAULT_FILTER_COEFF_FILE (working dir): only a bare file name gets through,
+// no separators / "..", no drive prefix ("C:x.json") -> a client can't make the producer open anything else
+static bool is_bare_coeff_filename(const std::string& file) {
+    if (file.empty() || file == "builtin") return true;
+    return file.find_first_of("/\\:") == std::string::npos && file.find("..") == std::string::npos;
+}
+
+// ask for a different bandpass set: {"id":"fir_hann_201", "file":"filter_coeffs.json"} (file optional, a bare
+// name in the coeff dir; "builtin" picks the compiled-in fir_blackman_201 / iir_butter_2)
+// swap happens in the background; poll GET /filter to see when it's live
+void HttpServer_C::handle_post_filter(const httplib::Request& req, httplib::Response& res){
+    const std::string& body = req.body;
+    std::string id;
+    std::string file = DEFAULT_FILTER_COEFF_FILE;
+    if (!JSON::extract_json_string(body, "\"id\"", id) || id.empty()) {
+        JSON::json_extract_fail("http_server", "id");
+        write_json_error(res, 400, "missing_or_invalid_field", "id");
+        return;
+    }
+    (void)JSON::extract_json_string(body, "\"file\"", file); // optional
+    if (!is_bare_coeff_filename(file)) {
+        write_json_error(res, 400, "missing_or_invalid_field", "file");
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateStoreRef_.filter_mtx);
+        stateStoreRef_.filter_request_file = file;
+        stateStoreRef_.filter_request_id = id;
+    }
+    stateStoreRef_.g_filter_swap_requested.store(true, std::memory_order_release);
+    write_json(res, "{\"ok\":true}");
+}
+
 // check ready and write monitor refresh rate from client response
 void HttpServer_C::handle_post_ready(const httplib::Request& req, httplib::Response& res){
     /* 
@@ -408,6 +588,15 @@ bool HttpServer_C::http_start_server(){
     liveServerRef_->Get("/eeg",
         [this](const httplib::Request& rq, httplib::Response& rs){ this->handle_get_eeg(rq, rs); });
 
+    liveServerRef_->Get("/filter",
+        [this](const httplib::Request& rq, httplib::Response& rs){ this->handle_get_filter(rq, rs); });
+
+    liveServerRef_->Get("/latency",
+        [this](const httplib::Request& rq, httplib::Response& rs){ this->handle_get_latency(rq, rs); });
+
+    liveServerRef_->Post("/filter",
+        [this](const httplib::Request& rq, httplib::Response& rs){ this->handle_post_filter(rq, rs); });
+
     liveServerRef_->Post("/event",
         [this](const httplib::Request& rq, httplib::Response& rs){ this->handle_post_event(rq, rs); });
 
@@ -421,6 +610,9 @@ bool HttpServer_C::http_start_server(){
     liveServerRef_->Options("/ready",
         [this](const httplib::Request& rq, httplib::Response& rs){ this->handle_options_and_set(rq, rs); });
 
+    liveServerRef_->Options("/filter",
+        [this](const httplib::Request& rq, httplib::Response& rs){ this->handle_options_and_set(rq, rs); });
+
     LOG_ALWAYS("HTTP Server successfully opened");
     return true;
 }
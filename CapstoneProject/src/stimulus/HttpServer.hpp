@@ -45,6 +45,13 @@ private:
     httplib::Server* liveServerRef_; // live httplib::server
     int port_;
     std::atomic<bool> is_running_ = false;
+    // live view = one subscriber on the eeg stream. httplib runs handlers on a pool,
+    // so the cursor + scratch buffer are guarded here (producer never sees this mutex)
+    static constexpr const char* DEFAULT_FILTER_COEFF_FILE = "filter_coeffs.json"; // written by FilterDesign.py
+    static constexpr size_t EEG_LIVE_MAX_CHUNKS = 16; // max chunks per GET /eeg (~2 s), older ones are skipped
+    int eegStreamSubId_ = -1;
+    std::mutex eeg_live_mtx_;
+    std::array<bufferChunk_S, EEG_LIVE_MAX_CHUNKS> eegLiveBuf_{};
     // Handlers
     void handle_get_state(const httplib::Request& req, httplib::Response& res); // return current c++ statestore snapshot (JSON)
     void handle_post_event(const httplib::Request& req, httplib::Response& res); // accept small UI cmds (JSON)
@@ -52,5 +59,8 @@ private:
     void handle_options_and_set(const httplib::Request& req, httplib::Response& res); // CORS preflight
     void handle_get_quality(const httplib::Request& req, httplib::Response& res);
     void handle_get_eeg(const httplib::Request& req, httplib::Response& res);
+    void handle_get_filter(const httplib::Request& req, httplib::Response& res);  // active bandpass set + swap status
+    void handle_get_latency(const httplib::Request& req, httplib::Response& res); // declared per-stage latency + measured sample ages
+    void handle_post_filter(const httplib::Request& req, httplib::Response& res); // request a bandpass coeff swap
     void write_json(httplib::Response& res, std::string_view json_body) const;
 }; // HttpServer_C
\ No newline at end of file
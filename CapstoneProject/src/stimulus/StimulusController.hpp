@@ -11,6 +11,7 @@ STIMULUS CONTROLLER : writer
 #include <optional>
 #include "../shared/StateStore.hpp"
 #include <deque>
+#include <atomic>
 
 // SINGLETON
 class StimulusController_C{
@@ -21,7 +22,7 @@ public:
     void runUIStateMachine();
     void stopStateMachine();
 private:
-    bool is_stopped_ = false;
+    std::atomic<bool> is_stopped_{false}; // set from another thread on shutdown
     StateStore_s* stateStoreRef_;
     UIState_E state_;
     UIState_E prevState_;
@@ -0,0 +1,113 @@
+/*
+==============================================================================
+	File: BroadcastRingBuffer.hpp
+	Desc: Single-producer, multi-consumer (1 -> N) broadcast ring for the
+	filtered chunk stream. Every subscriber (HTTP live view, recorder,
+	classifier, ...) gets its own read cursor + lag/overrun counters.
+	This header is used by:
+  - Acquisition (producer): publishes each filtered bufferChunk_S.
+  - Anyone who wants to tap the stream without touching the decoder queue.
+
+==============================================================================
+*/
+
+/*
+* FIXED SIZE BROADCAST RING (PRODUCER NEVER WAITS FOR READERS)
+methods:
+* publish     -> producer only, overwrites the oldest slot, never blocks
+* subscribe   -> claim a cursor (starts at the newest item, no backfill)
+* try_read    -> next item for this cursor (Ok / Empty / Overrun)
+* read_newest -> up to max of the newest items, skipping older ones (UI polling)
+* get_stats   -> lag / dropped / overrun per subscriber
+data:
+* each slot carries a sequence word: odd = being written, 2k = holds item k
+* published_ -> number of items published so far (item k lives in slot (k-1) % capacity)
+notes:
+- a slow reader can't hold the producer up: if it falls more than capacity
+  behind, its cursor jumps forward and the skipped items are counted as dropped
+- slot reads are seqlock style: copy, then re-check the sequence word; if the
+  producer lapped us mid-copy the read is thrown away (Overrun)
+- T must be trivially copyable (a torn copy is discarded, never used)
+- each cursor must be read by ONE thread at a time (wrap it in a mutex if
+  e.g. several HTTP worker threads share it). The producer never takes that mutex.
+- the decoder keeps its own lossless SpscRingBuffer_C; this ring is the fan-out tap
+*/
+#pragma once
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <type_traits>
+
+inline constexpr std::size_t EEG_STREAM_CAPACITY = 64; // ~8 s of chunks at 250 Hz / 32 scans
+inline constexpr std::size_t MAX_STREAM_SUBSCRIBERS = 8;
+
+enum StreamRead_E {
+    StreamRead_Ok = 0,
+    StreamRead_Empty,   // nothing new yet
+    StreamRead_Overrun  // fell behind; cursor moved forward, call again
+};
+
+struct StreamSubscriberStats_S {
+    std::string name;
+    uint64_t lag = 0;      // items published but not yet read by this subscriber
+    uint64_t reads = 0;    // items delivered
+    uint64_t dropped = 0;  // items skipped (overrun or read_newest skip)
+    uint64_t overruns = 0; // times the producer lapped this subscriber
+};
+
+template<typename T>
+class BroadcastRingBuffer_C {
+    static_assert(std::is_trivially_copyable_v<T>, "BroadcastRingBuffer_C needs a trivially copyable T");
+public:
+    // Constructor
+    explicit BroadcastRingBuffer_C(size_t capacity);
+
+    // producer only
+    void publish(const T& data);
+
+    // returns subscriber id, or -1 if all MAX_STREAM_SUBSCRIBERS are taken
+    int subscribe(const std::string& name);
+    void unsubscribe(int id);
+
+    StreamRead_E try_read(int id, T* dest);
+    size_t read_newest(int id, T* dest, size_t max);
+
+    uint64_t get_published() const { return published_.load(std::memory_order_acquire); };
+    size_t get_capacity() const { return capacity_; };
+    std::vector<StreamSubscriberStats_S> get_stats() const;
+
+private:
+    static constexpr std::size_t CACHE_LINE_BYTES = 64;
+
+    struct alignas(CACHE_LINE_BYTES) Slot_S {
+        std::atomic<uint64_t> seq{0};
+        T data;
+    };
+
+    // written by the owning reader only; atomics so get_stats() can peek from anywhere
+    struct alignas(CACHE_LINE_BYTES) Cursor_S {
+        std::atomic<bool> inUse{false};
+        std::atomic<uint64_t> next{1}; // item number this reader wants next
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> overruns{0};
+        std::string name;
+    };
+
+    void skip_to(Cursor_S& c, uint64_t next);
+    void resync(Cursor_S& c);
+
+    size_t const capacity_;
+    std::vector<Slot_S> slots_;
+
+    alignas(CACHE_LINE_BYTES) std::atomic<uint64_t> published_{0};
+
+    std::array<Cursor_S, MAX_STREAM_SUBSCRIBERS> cursors_;
+    mutable std::mutex subscribe_mtx_; // (un)subscribe + get_stats only, never on the data path
+};
+
+#include "BroadcastRingBuffer.tpp"
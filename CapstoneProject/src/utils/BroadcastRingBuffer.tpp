@@ -0,0 +1,158 @@
+#include <cassert>
+#include <cstring> // std::memcpy
+
+template<typename T>
+BroadcastRingBuffer_C<T>::BroadcastRingBuffer_C(size_t capacity)
+: capacity_(capacity), slots_(capacity) {
+    assert(capacity_ >= 2); // need at least one slot the producer isn't writing
+}
+
+// producer only. never blocks, whoever is reading
+template<typename T>
+void BroadcastRingBuffer_C<T>::publish(const T& data) {
+    const uint64_t k = published_.load(std::memory_order_relaxed) + 1; // we're the only writer
+    Slot_S& s = slots_[(k - 1) % capacity_];
+
+    // odd = "being written" so a reader mid-copy knows to throw its copy away
+    s.seq.store(2 * k - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&s.data, &data, sizeof(T));
+    s.seq.store(2 * k, std::memory_order_release);
+
+    published_.store(k, std::memory_order_release);
+}
+
+// new subscribers start at the newest item (no backfill of stale data)
+template<typename T>
+int BroadcastRingBuffer_C<T>::subscribe(const std::string& name) {
+    std::lock_guard<std::mutex> lock(subscribe_mtx_);
+    for (size_t i = 0; i < cursors_.size(); i++) {
+        Cursor_S& c = cursors_[i];
+        if (c.inUse.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        c.name = name;
+        c.next.store(published_.load(std::memory_order_acquire) + 1, std::memory_order_relaxed);
+        c.reads.store(0, std::memory_order_relaxed);
+        c.dropped.store(0, std::memory_order_relaxed);
+        c.overruns.store(0, std::memory_order_relaxed);
+        c.inUse.store(true, std::memory_order_release);
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+template<typename T>
+void BroadcastRingBuffer_C<T>::unsubscribe(int id) {
+    if (id < 0 || static_cast<size_t>(id) >= cursors_.size()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(subscribe_mtx_);
+    cursors_[id].inUse.store(false, std::memory_order_release);
+}
+
+// reads the next item for this cursor into dest
+template<typename T>
+StreamRead_E BroadcastRingBuffer_C<T>::try_read(int id, T* dest) {
+    assert(id >= 0 && static_cast<size_t>(id) < cursors_.size());
+    Cursor_S& c = cursors_[id];
+    const uint64_t want = c.next.load(std::memory_order_relaxed);
+    const uint64_t pub = published_.load(std::memory_order_acquire);
+    if (want > pub) {
+        return StreamRead_Empty;
+    }
+    if (pub - want >= capacity_ - 1) {
+        // producer has lapped us (or is about to overwrite the slot we want)
+        resync(c);
+        return StreamRead_Overrun;
+    }
+
+    const Slot_S& s = slots_[(want - 1) % capacity_];
+    const uint64_t seq1 = s.seq.load(std::memory_order_acquire);
+    if (seq1 != 2 * want) {
+        resync(c);
+        return StreamRead_Overrun;
+    }
+    std::memcpy(dest, &s.data, sizeof(T));
+    // copy must complete before we re-check the sequence word
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) != seq1) {
+        // torn: producer started rewriting this slot during our copy
+        resync(c);
+        return StreamRead_Overrun;
+    }
+
+    c.next.store(want + 1, std::memory_order_relaxed);
+    c.reads.fetch_add(1, std::memory_order_relaxed);
+    return StreamRead_Ok;
+}
+
+// for pollers (UI) that only care about the latest data:
+// skips to the newest max items (skipped ones count as dropped), then reads them oldest first
+// returns num of items written to dest
+template<typename T>
+size_t BroadcastRingBuffer_C<T>::read_newest(int id, T* dest, size_t max) {
+    assert(id >= 0 && static_cast<size_t>(id) < cursors_.size());
+    if (max == 0) {
+        return 0;
+    }
+    Cursor_S& c = cursors_[id];
+    const uint64_t pub = published_.load(std::memory_order_acquire);
+    if (pub >= max && c.next.load(std::memory_order_relaxed) + max <= pub) {
+        skip_to(c, pub - max + 1);
+    }
+
+    size_t n = 0;
+    while (n < max) {
+        const StreamRead_E r = try_read(id, dest + n);
+        if (r == StreamRead_Empty) {
+            break;
+        }
+        if (r == StreamRead_Ok) {
+            n++;
+        }
+        // Overrun -> cursor already moved forward, just go again
+    }
+    return n;
+}
+
+template<typename T>
+std::vector<StreamSubscriberStats_S> BroadcastRingBuffer_C<T>::get_stats() const {
+    std::lock_guard<std::mutex> lock(subscribe_mtx_);
+    std::vector<StreamSubscriberStats_S> out;
+    const uint64_t pub = published_.load(std::memory_order_acquire);
+    for (const Cursor_S& c : cursors_) {
+        if (!c.inUse.load(std::memory_order_acquire)) {
+            continue;
+        }
+        StreamSubscriberStats_S st;
+        st.name = c.name;
+        const uint64_t next = c.next.load(std::memory_order_relaxed);
+        st.lag = (pub + 1 > next) ? (pub + 1 - next) : 0;
+        st.reads = c.reads.load(std::memory_order_relaxed);
+        st.dropped = c.dropped.load(std::memory_order_relaxed);
+        st.overruns = c.overruns.load(std::memory_order_relaxed);
+        out.push_back(std::move(st));
+    }
+    return out;
+}
+
+template<typename T>
+void BroadcastRingBuffer_C<T>::skip_to(Cursor_S& c, uint64_t next) {
+    const uint64_t cur = c.next.load(std::memory_order_relaxed);
+    if (next > cur) {
+        c.dropped.fetch_add(next - cur, std::memory_order_relaxed);
+        c.next.store(next, std::memory_order_relaxed);
+    }
+}
+
+// jump to the oldest item the producer can't be touching right now
+// (it may be writing item pub+1, which reuses the slot of item pub+1-capacity)
+template<typename T>
+void BroadcastRingBuffer_C<T>::resync(Cursor_S& c) {
+    c.overruns.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t pub = published_.load(std::memory_order_acquire);
+    const uint64_t oldest = (pub + 2 > capacity_) ? (pub + 2 - capacity_) : 1;
+    const uint64_t cur = c.next.load(std::memory_order_relaxed);
+    skip_to(c, (oldest > cur) ? oldest : cur + 1);
+}
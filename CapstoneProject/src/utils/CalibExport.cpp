@@ -0,0 +1,123 @@
+#include "CalibExport.hpp"
+#include "Filters.hpp"
+#include "SignalQualityAnalyzer.h" // artifact threshold rule (sqa_artifact_thresholds)
+#include "../acq/WindowConfigs.hpp"
+#include <cmath>
+#include <fstream>
+
+void CalibRecorder_C::clear() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    rec_ = CalibRecording_S{};
+    lastTick_ = 0;
+    lastFirstScan_ = 0;
+}
+
+bool CalibRecorder_C::append(const bufferChunk_S& chunk) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (rec_.num_scans() + NUM_SCANS_CHUNK > CALIB_RECORD_MAX_SCANS) return false;
+    // new segment unless these scans directly follow the last ones: tick jump (dropped / not recorded in
+    // between), scans lost in transport, or the device counter not where it should be (no counter = always 0)
+    const bool counterOk = (chunk.first_scan == 0) ? (lastFirstScan_ == 0)
+                                                   : (chunk.first_scan == lastFirstScan_ + NUM_SCANS_CHUNK);
+    if (rec_.segs.empty() || chunk.tick != lastTick_ + 1 || chunk.lost_scans > 0 || !counterOk) {
+        rec_.segs.push_back(CalibRecording_S::Segment_S{ rec_.num_scans(), 0 });
+    }
+    lastTick_ = chunk.tick;
+    lastFirstScan_ = chunk.first_scan;
+    rec_.raw.insert(rec_.raw.end(), chunk.data.begin(), chunk.data.end());
+    rec_.state.insert(rec_.state.end(), NUM_SCANS_CHUNK, static_cast<uint8_t>(chunk.ui_state));
+    rec_.label.insert(rec_.label.end(), NUM_SCANS_CHUNK, static_cast<uint8_t>(chunk.label));
+    rec_.segs.back().len += NUM_SCANS_CHUNK;
+    return true;
+}
+
+std::size_t CalibRecorder_C::get_num_scans() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return rec_.num_scans();
+}
+
+CalibRecording_S CalibRecorder_C::take() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    CalibRecording_S out = std::move(rec_);
+    rec_ = CalibRecording_S{};
+    lastTick_ = 0;
+    lastFirstScan_ = 0;
+    return out;
+}
+
+// amplitude + step part of SignalQualityAnalyzer_C::check_artifact_and_flag_window, with the thresholds
+// sqa_artifact_thresholds gave for this window
+static bool window_is_bad(const float* w, std::size_t nCh, const std::array<float, NUM_CH_CHUNK>& ampThresh,
+                          const std::array<float, NUM_CH_CHUNK>& stepThresh) {
+    for (std::size_t ch = 0; ch < nCh; ++ch) {
+        int overAmp = 0, overStep = 0;
+        for (std::size_t s = 0; s < WINDOW_SCANS; ++s) {
+            const float v = w[s * NUM_CH_CHUNK + ch];
+            if (std::fabs(v) > ampThresh[ch]) ++overAmp;
+            if (s > 0 && std::fabs(v - w[(s - 1) * NUM_CH_CHUNK + ch]) > stepThresh[ch]) ++overStep;
+        }
+        if (overAmp >= AMP_PERSIST_SAMPLES || overStep >= STEP_PERSIST_SAMPLES) return true;
+    }
+    return false;
+}
+
+long export_calib_windows(const CalibRecording_S& rec, const FilterCoeffSet_S& set, const std::string& path,
+                          std::size_t nChLog, unsigned nThreads, std::string& err) {
+    std::ofstream csv(path, std::ios::out | std::ios::trunc);
+    if (!csv.is_open()) {
+        err = "failed to open " + path;
+        return -1;
+    }
+    csv << "window_idx,ui_state,is_trimmed,is_bad,sample_idx";
+    for (std::size_t ch = 0; ch < nChLog; ++ch) csv << ",eeg" << (ch + 1);
+    csv << ",testfreq_e,testfreq_hz,fs_hz\n";
+
+    long nWin = 0;
+    std::vector<float> x;
+    // same robust baseline as online, fed the exported (zero-phase) scans in order up to each window's end
+    RobustBaseline_C baseline;
+    std::array<float, NUM_CH_CHUNK> ampThresh{}, stepThresh{};
+    for (const CalibRecording_S::Segment_S& seg : rec.segs) {
+        x.assign(rec.raw.begin() + seg.start * NUM_CH_CHUNK, rec.raw.begin() + (seg.start + seg.len) * NUM_CH_CHUNK);
+        const std::size_t nOut = EegFilterBank_C::process_session_zero_phase(set, x, nThreads);
+
+        // output scan m came from raw scan seg.start + m*DECIMATION -> take its state/label
+        auto st_at = [&](std::size_t m) { return rec.state[seg.start + m * DECIMATION]; };
+        auto lb_at = [&](std::size_t m) { return rec.label[seg.start + m * DECIMATION]; };
+
+        std::size_t fed = 0; // scans of this segment in the baseline
+        std::size_t m = 0;
+        while (m < nOut) {
+            // run of constant ui state + label
+            std::size_t end = m;
+            while (end < nOut && st_at(end) == st_at(m) && lb_at(end) == lb_at(m)) ++end;
+
+            const UIState_E st = static_cast<UIState_E>(st_at(m));
+            const TestFreq_E lb = static_cast<TestFreq_E>(lb_at(m));
+            const bool calib = (st == UIState_Active_Calib || st == UIState_NoSSVEP_Test);
+            if (calib && lb != TestFreq_None) {
+                const int tf_hz = TestFreqEnumToInt(lb);
+                for (std::size_t w = m; w + WINDOW_SCANS <= end; w += WINDOW_HOP_SCANS) {
+                    const float* win = x.data() + w * NUM_CH_CHUNK;
+                    baseline.push_scans(x.data() + fed * NUM_CH_CHUNK, w + WINDOW_SCANS - fed, fed > 0);
+                    fed = w + WINDOW_SCANS;
+                    sqa_artifact_thresholds(baseline, ampThresh, stepThresh);
+                    const bool bad = window_is_bad(win, nChLog, ampThresh, stepThresh);
+                    ++nWin;
+                    for (std::size_t s = 0; s < WINDOW_SCANS; ++s) {
+                        csv << nWin << "," << static_cast<int>(st) << ",0," << (bad ? 1 : 0) << "," << s;
+                        for (std::size_t ch = 0; ch < nChLog; ++ch) csv << "," << win[s * NUM_CH_CHUNK + ch];
+                        csv << "," << static_cast<int>(lb) << "," << tf_hz << "," << PIPELINE_FS_HZ << "\n";
+                    }
+                }
+            }
+            m = end;
+        }
+    }
+    csv.flush();
+    if (!csv) {
+        err = "write failed: " + path;
+        return -1;
+    }
+    return nWin;
+}
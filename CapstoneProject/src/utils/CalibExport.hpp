@@ -0,0 +1,65 @@
+#pragma once
+#include "Types.h"
+#include "FilterCoeffs.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* CALIB TRAINING EXPORT (offline, zero phase)
+- producer records the raw scans of a calib session (chunk.data before the filter bank, only while the ui
+  is in calib/instructions) + ui state / label per scan
+- at finalize the consumer take()s the recording and it goes through EegFilterBank_C::process_session_zero_phase
+  in one pass (forward-backward bandpass, channels split over threads) and gets cut into windows the same way
+  the online path does: WINDOW_SCANS long, WINDOW_HOP_SCANS apart, only where ui state + label stay constant
+- written to eeg_windows.csv with the same columns as the online logger, but whole windows (is_trimmed=0):
+  no group delay and no startup transient means nothing at the ends needs throwing away
+- a gap in chunk ticks (we stopped recording in between), scans lost in transport (chunk.lost_scans) or a
+  jump in the device scan counter starts a new segment; segments are filtered separately so we never
+  filter across a discontinuity, and no window spans one
+- is_bad here = amplitude/step checks with the online threshold rule (sqa_artifact_thresholds over a
+  RobustBaseline_C fed the exported scans up to each window's end). That baseline starts with the recording,
+  the online one with the app, so the first ROBUST_WARMUP_SEC use the fixed thresholds here and flags can
+  differ a bit early on. Kurtosis/entropy aren't checked offline (they need the online rolling window stats)
+*/
+
+inline constexpr std::size_t CALIB_RECORD_MAX_SCANS = 60 * 60 * ACQ_FS_HZ; // 1 h cap (~29 MB at 8 ch)
+
+struct CalibRecording_S {
+    struct Segment_S {
+        std::size_t start = 0; // first scan
+        std::size_t len = 0;   // scans
+    };
+    std::vector<float> raw;        // interleaved, NUM_CH_CHUNK stride
+    std::vector<uint8_t> state;    // UIState_E per scan
+    std::vector<uint8_t> label;    // TestFreq_E per scan (TestFreq_NoSSVEP = 99 fits)
+    std::vector<Segment_S> segs;
+
+    std::size_t num_scans() const { return raw.size() / NUM_CH_CHUNK; };
+};
+
+// zero-phase filter every segment, cut windows, write csv (nChLog columns). returns windows written,
+// -1 + err if the file couldn't be written
+long export_calib_windows(const CalibRecording_S& rec, const FilterCoeffSet_S& set, const std::string& path,
+                          std::size_t nChLog, unsigned nThreads, std::string& err);
+
+// producer appends, consumer take()s at finalize / clear()s on a new session
+class CalibRecorder_C {
+public:
+    CalibRecorder_C() = default;
+
+    void clear();
+    // appends chunk.data (NUM_SCANS_CHUNK raw scans, call before the filter bank) with the chunk's
+    // ui state + label; false once the cap is hit
+    bool append(const bufferChunk_S& chunk);
+    std::size_t get_num_scans() const;
+    // hands the recording over and starts an empty one
+    CalibRecording_S take();
+
+private:
+    mutable std::mutex mtx_; // producer append vs consumer take/clear, once per chunk
+    CalibRecording_S rec_;
+    uint64_t lastTick_ = 0;
+    uint64_t lastFirstScan_ = 0; // device counter of the last chunk (0 = backend has none)
+};
@@ -0,0 +1,99 @@
+#include "Fft.hpp"
+#include <cassert>
+#include <cmath>
+#include <utility> // std::swap
+
+using cf = std::complex<float>;
+
+// plain complex multiply (std::complex operator* does inf/nan recovery -> slow without fast-math)
+static inline cf cmul(const cf& a, const cf& b) {
+    return cf(a.real() * b.real() - a.imag() * b.imag(),
+              a.real() * b.imag() + a.imag() * b.real());
+}
+
+void RealFft_C::init(std::size_t n) {
+    assert(n >= 4 && (n & (n - 1)) == 0); // power of 2
+    n_ = n;
+    m_ = n / 2;
+    const double pi = 3.14159265358979323846;
+
+    tw_.resize(m_ / 2);
+    for (std::size_t j = 0; j < m_ / 2; ++j) {
+        const double a = -2.0 * pi * double(j) / double(m_);
+        tw_[j] = cf(float(std::cos(a)), float(std::sin(a)));
+    }
+    twSplit_.resize(m_ + 1);
+    for (std::size_t k = 0; k <= m_; ++k) {
+        const double a = -2.0 * pi * double(k) / double(n_);
+        twSplit_[k] = cf(float(std::cos(a)), float(std::sin(a)));
+    }
+
+    std::size_t bits = 0;
+    while ((std::size_t(1) << bits) < m_) bits++;
+    bitrev_.resize(m_);
+    for (std::size_t i = 0; i < m_; ++i) {
+        uint32_t r = 0;
+        for (std::size_t b = 0; b < bits; ++b) {
+            r |= uint32_t((i >> b) & 1u) << (bits - 1 - b);
+        }
+        bitrev_[i] = r;
+    }
+    scratch_.assign(m_, cf(0.0f, 0.0f));
+}
+
+// in-place complex FFT of size m_ (no scaling)
+void RealFft_C::fft_complex(cf* a, bool inverse) const {
+    for (std::size_t i = 0; i < m_; ++i) {
+        const std::size_t j = bitrev_[i];
+        if (i < j) std::swap(a[i], a[j]);
+    }
+    for (std::size_t len = 2; len <= m_; len <<= 1) {
+        const std::size_t half = len / 2;
+        const std::size_t step = m_ / len;
+        for (std::size_t i = 0; i < m_; i += len) {
+            for (std::size_t j = 0; j < half; ++j) {
+                cf w = tw_[j * step];
+                if (inverse) w = std::conj(w);
+                const cf u = a[i + j];
+                const cf v = cmul(a[i + j + half], w);
+                a[i + j] = u + v;
+                a[i + j + half] = u - v;
+            }
+        }
+    }
+}
+
+// z[m] = x[2m] + i*x[2m+1] -> Z = FFT(z) -> split into even/odd spectra -> X[k] = E[k] + W^k O[k]
+void RealFft_C::forward(const float* in, cf* out) {
+    for (std::size_t i = 0; i < m_; ++i) {
+        scratch_[i] = cf(in[2 * i], in[2 * i + 1]);
+    }
+    fft_complex(scratch_.data(), false);
+
+    for (std::size_t k = 0; k <= m_; ++k) {
+        const cf zk  = scratch_[k == m_ ? 0 : k];
+        const cf zmk = std::conj(scratch_[k == 0 ? 0 : m_ - k]);
+        const cf e = (zk + zmk) * 0.5f;
+        const cf d = (zk - zmk) * 0.5f;
+        const cf o(d.imag(), -d.real()); // d / i
+        out[k] = e + cmul(twSplit_[k], o);
+    }
+}
+
+// undo the split: E[k] = (X[k] + conj(X[m-k]))/2, O[k] = (X[k] - conj(X[m-k]))/2 * conj(W^k), Z = E + iO
+void RealFft_C::inverse(const cf* in, float* out) {
+    for (std::size_t k = 0; k < m_; ++k) {
+        const cf xk  = in[k];
+        const cf xmk = std::conj(in[m_ - k]);
+        const cf e = (xk + xmk) * 0.5f;
+        const cf o = cmul((xk - xmk) * 0.5f, std::conj(twSplit_[k]));
+        scratch_[k] = e + cf(-o.imag(), o.real()); // e + i*o
+    }
+    fft_complex(scratch_.data(), true);
+
+    const float scale = 1.0f / float(m_);
+    for (std::size_t i = 0; i < m_; ++i) {
+        out[2 * i]     = scratch_[i].real() * scale;
+        out[2 * i + 1] = scratch_[i].imag() * scale;
+    }
+}
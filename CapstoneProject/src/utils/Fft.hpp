@@ -0,0 +1,36 @@
+#pragma once
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* BUILT-IN REAL FFT (no external deps)
+- radix-2, iterative, size n = power of 2 (>= 4)
+- real input of n samples is packed into an n/2 complex FFT, then split
+  into the n/2+1 unique bins (the rest are conjugate mirrors)
+- inverse() scales by 1/n so inverse(forward(x)) == x
+- tables (twiddles, bit reversal) are built once in init(); forward/inverse don't allocate
+- not thread-safe (shared scratch): one instance per thread
+*/
+class RealFft_C {
+public:
+    RealFft_C() = default;
+    explicit RealFft_C(std::size_t n) { init(n); };
+
+    void init(std::size_t n);
+    std::size_t size() const { return n_; };
+    std::size_t num_bins() const { return m_ + 1; }; // n/2 + 1
+
+    void forward(const float* in, std::complex<float>* out);   // out: n/2+1 bins
+    void inverse(const std::complex<float>* in, float* out);   // in: n/2+1 bins, out: n samples
+
+private:
+    void fft_complex(std::complex<float>* a, bool inverse) const;
+
+    std::size_t n_ = 0; // real size
+    std::size_t m_ = 0; // complex size (n/2)
+    std::vector<std::complex<float>> tw_;       // e^{-2*pi*i*j/m}, j < m/2
+    std::vector<std::complex<float>> twSplit_;  // e^{-2*pi*i*k/n}, k <= m
+    std::vector<uint32_t> bitrev_;
+    std::vector<std::complex<float>> scratch_;
+};
@@ -0,0 +1,198 @@
+#include "FilterCoeffs.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+#include <sstream>
+
+// ==================== tiny JSON reader (just enough for coeff files) ====================
+// JsonUtils.hpp only does flat key lookups; coeff files need nested arrays of numbers.
+namespace {
+
+struct JVal_S {
+    enum Type_E { Null, Bool, Num, Str, Arr, Obj } type = Null;
+    bool b = false;
+    double num = 0.0;
+    std::string str;
+    std::vector<JVal_S> arr;
+    std::vector<std::pair<std::string, JVal_S>> obj; // (vector: ok with incomplete JVal_S, map isn't guaranteed)
+
+    const JVal_S* get(const char* key) const {
+        if (type != Obj) return nullptr;
+        for (const auto& kv : obj) {
+            if (kv.first == key) return &kv.second;
+        }
+        return nullptr;
+    }
+};
+
+class JParser_C {
+public:
+    explicit JParser_C(const std::string& s) : s_(s) {}
+
+    bool parse(JVal_S& out, std::string& err) {
+        if (!value(out, 0)) { err = err_.empty() ? "bad json" : err_; return false; }
+        ws();
+        if (p_ != s_.size()) { err = "trailing characters at offset " + std::to_string(p_); return false; }
+        return true;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 16;
+
+    void ws() { while (p_ < s_.size() && std::isspace((unsigned char)s_[p_])) ++p_; }
+    bool fail(const char* msg) { err_ = std::string(msg) + " at offset " + std::to_string(p_); return false; }
+
+    bool value(JVal_S& v, int depth) {
+        if (depth > MAX_DEPTH) return fail("nesting too deep");
+        ws();
+        if (p_ >= s_.size()) return fail("unexpected end");
+        const char c = s_[p_];
+        if (c == '{') return object(v, depth);
+        if (c == '[') return array(v, depth);
+        if (c == '"') { v.type = JVal_S::Str; return string(v.str); }
+        if (s_.compare(p_, 4, "true") == 0)  { v.type = JVal_S::Bool; v.b = true;  p_ += 4; return true; }
+        if (s_.compare(p_, 5, "false") == 0) { v.type = JVal_S::Bool; v.b = false; p_ += 5; return true; }
+        if (s_.compare(p_, 4, "null") == 0)  { v.type = JVal_S::Null; p_ += 4; return true; }
+        return number(v);
+    }
+
+    bool object(JVal_S& v, int depth) {
+        v.type = JVal_S::Obj;
+        ++p_; ws();
+        if (p_ < s_.size() && s_[p_] == '}') { ++p_; return true; }
+        for (;;) {
+            ws();
+            std::string key;
+            if (p_ >= s_.size() || s_[p_] != '"' || !string(key)) return fail("expected key");
+            ws();
+            if (p_ >= s_.size() || s_[p_] != ':') return fail("expected ':'");
+            ++p_;
+            v.obj.emplace_back(std::move(key), JVal_S{});
+            if (!value(v.obj.back().second, depth + 1)) return false;
+            ws();
+            if (p_ < s_.size() && s_[p_] == ',') { ++p_; continue; }
+            if (p_ < s_.size() && s_[p_] == '}') { ++p_; return true; }
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    bool array(JVal_S& v, int depth) {
+        v.type = JVal_S::Arr;
+        ++p_; ws();
+        if (p_ < s_.size() && s_[p_] == ']') { ++p_; return true; }
+        for (;;) {
+            v.arr.emplace_back();
+            if (!value(v.arr.back(), depth + 1)) return false;
+            ws();
+            if (p_ < s_.size() && s_[p_] == ',') { ++p_; continue; }
+            if (p_ < s_.size() && s_[p_] == ']') { ++p_; return true; }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    // no unicode escapes needed for ids/names; \uXXXX is kept as-is
+    bool string(std::string& out) {
+        ++p_; // opening quote
+        while (p_ < s_.size() && s_[p_] != '"') {
+            if (s_[p_] == '\\' && p_ + 1 < s_.size()) {
+                const char e = s_[++p_];
+                out += (e == 'n') ? '\n' : (e == 't') ? '\t' : e;
+            } else {
+                out += s_[p_];
+            }
+            ++p_;
+        }
+        if (p_ >= s_.size()) return fail("unterminated string");
+        ++p_; // closing quote
+        return true;
+    }
+
+    bool number(JVal_S& v) {
+        const char* begin = s_.c_str() + p_;
+        char* end = nullptr;
+        v.num = std::strtod(begin, &end);
+        if (end == begin) return fail("expected value");
+        v.type = JVal_S::Num;
+        p_ += static_cast<std::size_t>(end - begin);
+        return true;
+    }
+
+    const std::string& s_;
+    std::size_t p_ = 0;
+    std::string err_;
+};
+
+bool read_floats(const JVal_S* a, std::vector<float>& out) {
+    if (a == nullptr || a->type != JVal_S::Arr) return false;
+    out.clear();
+    out.reserve(a->arr.size());
+    for (const JVal_S& x : a->arr) {
+        if (x.type != JVal_S::Num) return false;
+        out.push_back(static_cast<float>(x.num));
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================ API ================================
+bool parse_filter_coeff_sets(const std::string& json, std::vector<FilterCoeffSet_S>& out, std::string& err) {
+    out.clear();
+    JVal_S root;
+    if (!JParser_C(json).parse(root, err)) return false;
+
+    const JVal_S* fs = root.get("fs");
+    const JVal_S* sets = root.get("sets");
+    if (sets == nullptr || sets->type != JVal_S::Arr) { err = "missing \"sets\" array"; return false; }
+
+    for (const JVal_S& js : sets->arr) {
+        FilterCoeffSet_S set;
+        const JVal_S* id = js.get("id");
+        const JVal_S* type = js.get("type");
+        if (id == nullptr || id->type != JVal_S::Str) { err = "set without \"id\""; return false; }
+        set.id = id->str;
+        if (const JVal_S* name = js.get("name"); name != nullptr && name->type == JVal_S::Str) set.name = name->str;
+        set.fs = (fs != nullptr && fs->type == JVal_S::Num) ? fs->num : 0.0;
+
+        const std::string t = (type != nullptr && type->type == JVal_S::Str) ? type->str : "FIR";
+        if (t == "FIR") {
+            set.kind = FilterKind_FIR;
+            if (!read_floats(js.get("b"), set.b) || set.b.empty()) { err = set.id + ": bad or empty \"b\""; return false; }
+        } else if (t == "SOS" || t == "IIR") {
+            set.kind = FilterKind_SOS;
+            const JVal_S* sos = js.get("sos");
+            if (sos == nullptr || sos->type != JVal_S::Arr || sos->arr.empty()) { err = set.id + ": bad or empty \"sos\""; return false; }
+            std::vector<float> row;
+            for (const JVal_S& r : sos->arr) {
+                if (!read_floats(&r, row) || row.size() != 6) { err = set.id + ": each sos row needs 6 numbers"; return false; }
+                std::array<float, 6> sec{};
+                for (std::size_t i = 0; i < 6; ++i) sec[i] = row[i];
+                set.sos.push_back(sec);
+            }
+        } else {
+            err = set.id + ": unknown type \"" + t + "\"";
+            return false;
+        }
+        out.push_back(std::move(set));
+    }
+    return true;
+}
+
+bool load_filter_coeff_sets(const std::string& path, std::vector<FilterCoeffSet_S>& out, std::string& err) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) { err = "can't open " + path; return false; }
+    std::ostringstream ss;
+    ss << f.rdbuf();
+    return parse_filter_coeff_sets(ss.str(), out, err);
+}
+
+bool load_filter_coeff_set(const std::string& path, const std::string& id, FilterCoeffSet_S& out, std::string& err) {
+    std::vector<FilterCoeffSet_S> sets;
+    if (!load_filter_coeff_sets(path, sets, err)) return false;
+    for (FilterCoeffSet_S& s : sets) {
+        if (s.id == id) { out = std::move(s); return true; }
+    }
+    err = "no set \"" + id + "\" in " + path;
+    return false;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <string>
+#include <vector>
+
+/* FILTER COEFFICIENT SETS (exported by "filter design/python/FilterDesign.py")
+JSON layout:
+{
+  "fs": 250.0,
+  "sets": [
+    { "id": "fir_blackman_201", "name": "FIR Blackman, 201 taps", "type": "FIR", "b": [ ... ] },
+    { "id": "iir_butter_2",     "name": "IIR Butterworth, order 2", "type": "SOS",
+      "sos": [ [b0, b1, b2, a0, a1, a2], ... ] }
+  ]
+}
+- FIR sets carry taps in "b"; IIR sets carry second-order sections (scipy sos layout) in "sos"
+- loading never throws: returns false + fills err with what went wrong
+*/
+
+enum FilterKind_E {
+    FilterKind_FIR = 0,
+    FilterKind_SOS
+};
+
+struct FilterCoeffSet_S {
+    std::string id;
+    std::string name;
+    FilterKind_E kind = FilterKind_FIR;
+    double fs = 0.0;                          // rate the set was designed for (from the file)
+    std::vector<float> b;                     // FIR taps
+    std::vector<std::array<float, 6>> sos;    // IIR sections [b0 b1 b2 a0 a1 a2]
+};
+
+bool load_filter_coeff_sets(const std::string& path, std::vector<FilterCoeffSet_S>& out, std::string& err);
+bool parse_filter_coeff_sets(const std::string& json, std::vector<FilterCoeffSet_S>& out, std::string& err);
+// convenience: load file and pick one set by id
+bool load_filter_coeff_set(const std::string& path, const std::string& id, FilterCoeffSet_S& out, std::string& err);
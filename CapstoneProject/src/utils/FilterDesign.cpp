@@ -0,0 +1,85 @@
+#include "FilterDesign.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+
+static constexpr double PI = 3.14159265358979323846;
+
+static double sinc(double x) {
+    return (x == 0.0) ? 1.0 : std::sin(PI * x) / (PI * x);
+}
+
+std::vector<float> design_fir_bandpass(double f1Hz, double f2Hz, double fs, std::size_t nTaps) {
+    assert(nTaps > 1 && 0.0 < f1Hz && f1Hz < f2Hz && f2Hz < 0.5 * fs);
+    const double l = f1Hz / (0.5 * fs); // cutoffs relative to nyquist, like firwin
+    const double r = f2Hz / (0.5 * fs);
+    const double alpha = 0.5 * double(nTaps - 1);
+    const double scaleF = 0.5 * (l + r); // firwin scale=True: unity gain at the center of the band
+
+    std::vector<double> h(nTaps);
+    double s = 0.0;
+    for (std::size_t n = 0; n < nTaps; ++n) {
+        const double m = double(n) - alpha;
+        const double x = double(n) / double(nTaps - 1);
+        const double w = 0.42 - 0.5 * std::cos(2.0 * PI * x) + 0.08 * std::cos(4.0 * PI * x); // symmetric blackman
+        h[n] = (r * sinc(r * m) - l * sinc(l * m)) * w;
+        s += h[n] * std::cos(PI * m * scaleF);
+    }
+    std::vector<float> out(nTaps);
+    for (std::size_t n = 0; n < nTaps; ++n) out[n] = static_cast<float>(h[n] / s);
+    return out;
+}
+
+std::vector<SosSection_t> design_butter_bandpass_sos(std::size_t order, double f1Hz, double f2Hz, double fs) {
+    assert(order > 0 && 0.0 < f1Hz && f1Hz < f2Hz && f2Hz < 0.5 * fs);
+    using cplx = std::complex<double>;
+    const double k = 2.0 * fs; // bilinear s = k (z-1)/(z+1)
+    const double w1 = k * std::tan(PI * f1Hz / fs); // prewarped edges
+    const double w2 = k * std::tan(PI * f2Hz / fs);
+    const double bw = w2 - w1;
+    const double w0 = std::sqrt(w1 * w2);
+
+    // butterworth prototype poles -> two bandpass poles each -> z plane
+    std::vector<cplx> complexPoles; // upper half plane only (conjugates implied)
+    std::vector<double> realPoles;
+    for (std::size_t i = 0; i < order; ++i) {
+        const double m = -double(order) + 1.0 + 2.0 * double(i);
+        const cplx p = -std::exp(cplx(0.0, PI * m / (2.0 * double(order))));
+        const cplx a = p * (0.5 * bw);
+        const cplx d = std::sqrt(a * a - w0 * w0);
+        for (const cplx s : { a + d, a - d }) {
+            const cplx z = (k + s) / (k - s);
+            if (std::fabs(z.imag()) < 1e-12) realPoles.push_back(z.real());
+            else if (z.imag() > 0.0) complexPoles.push_back(z);
+        }
+    }
+    std::sort(realPoles.begin(), realPoles.end());
+
+    std::vector<SosSection_t> sos;
+    std::vector<std::array<double, 6>> secs;
+    for (const cplx& p : complexPoles) {
+        secs.push_back({ 1.0, 0.0, -1.0, 1.0, -2.0 * p.real(), std::norm(p) });
+    }
+    for (std::size_t i = 0; i + 1 < realPoles.size(); i += 2) {
+        secs.push_back({ 1.0, 0.0, -1.0, 1.0, -(realPoles[i] + realPoles[i + 1]), realPoles[i] * realPoles[i + 1] });
+    }
+    assert(secs.size() == order);
+
+    // unity gain at the center (analog w0 maps to this digital freq), all of it on the first section
+    const cplx z = std::exp(cplx(0.0, 2.0 * std::atan(w0 / k)));
+    const cplx zi = 1.0 / z;
+    cplx h(1.0, 0.0);
+    for (const auto& c : secs) {
+        h *= (c[0] + c[1] * zi + c[2] * zi * zi) / (c[3] + c[4] * zi + c[5] * zi * zi);
+    }
+    const double g = 1.0 / std::abs(h);
+    for (std::size_t i = 0; i < 3; ++i) secs[0][i] *= g;
+
+    for (const auto& c : secs) {
+        SosSection_t s{};
+        for (std::size_t i = 0; i < 6; ++i) s[i] = static_cast<float>(c[i]);
+        sos.push_back(s);
+    }
+    return sos;
+}
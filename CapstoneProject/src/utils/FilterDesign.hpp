@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "SosIir.hpp" // SosSection_t
+
+/* BANDPASS DESIGN AT RUNTIME (C++ side of "filter design/python/FilterDesign.py")
+- the compiled-in tables (fir_blackman_201_b, iir_butter_2_sos) are only valid at 250 Hz. Builds for
+  other rates (EEG_FS_HZ) design the same filters at startup instead
+- design_fir_bandpass: scipy firwin(nTaps, [f1, f2], pass_zero=False, window="blackman") -> windowed sinc,
+  scaled to unity gain at the band center. Matches the 250 Hz table to float precision
+- design_butter_bandpass_sos: scipy butter(order, [f1, f2], "bandpass") -> prewarp, lowpass prototype ->
+  bandpass, bilinear. One section per pole pair, zeros at z=+1 and z=-1 ([1 0 -1]), unity gain at the
+  center. Section order/gain split differs from scipy's zpk2sos, the response doesn't
+*/
+
+std::vector<float> design_fir_bandpass(double f1Hz, double f2Hz, double fs, std::size_t nTaps);
+std::vector<SosSection_t> design_butter_bandpass_sos(std::size_t order, double f1Hz, double f2Hz, double fs);
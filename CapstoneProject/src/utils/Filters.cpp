@@ -1,8 +1,9 @@
 #include "Filters.hpp"
+#include "FilterDesign.hpp"
 #include "../utils/Logger.hpp"
 
 // from FilterDesign.py
-static constexpr float fir_blackman_201_b[201] = {
+const float fir_blackman_201_b[BP_TAPS] = {
     8.6551515e-35f, -1.3211498e-07f, -8.11674399e-07f, -1.53406191e-06f, -5.02471764e-07f,
     4.41199228e-06f, 1.39520925e-05f, 2.60886511e-05f, 3.61068915e-05f, 3.86300447e-05f,
     3.09207104e-05f, 1.58025434e-05f, 2.28147186e-06f, 2.72994489e-06f, 2.71287165e-05f,
@@ -43,47 +44,10 @@ static constexpr float fir_blackman_201_b[201] = {
     -8.11674399e-07f, -1.3211498e-07f, 8.6551515e-35f
 };
 
-// THESE TAPS ARE NOT GOOD BECAUSE THEY DONT HAVE ZERO DC GAIN
-static constexpr float fir_hamming_201_b[201] = {
-    0.000241931009f, 5.02136622e-05f, -1.31761105e-06f, 0.000135797005f, 0.000377193862f,
-    0.000558852411f, 0.00054991899f, 0.000350214392f, 0.000101717581f, -2.59763771e-06f,
-    0.000142884498f, 0.000467362034f, 0.000756131565f, 0.000795795598f, 0.000537189634f,
-    0.000154345372f, -5.99767023e-05f, 9.54665635e-05f, 0.000561995056f, 0.00103083674f,
-    0.00114856838f, 0.000785590584f, 0.000167102353f, -0.000254618935f, -0.000122303807f,
-    0.000535115033f, 0.00127382678f, 0.00152616832f, 0.00102594707f, 5.34544172e-05f,
-    -0.000713945729f, -0.000678820892f, 0.000202611882f, 0.00131914614f, 0.00179941637f,
-    0.00115527977f, -0.000296420987f, -0.00158648266f, -0.0017678498f, -0.000648885629f,
-    0.000975062376f, 0.00182594617f, 0.00107396521f, -0.00097684496f, -0.00300263972f,
-    -0.0035696041f, -0.0022225176f, 6.60788996e-05f, 0.00149603748f, 0.000734375927f,
-    -0.00201854142f, -0.00503073496f, -0.00621174269f, -0.00467392244f, -0.00152605488f,
-    0.000780704991f, 0.000193508334f, -0.00333958338f, -0.00763998688f, -0.00974624797f,
-    -0.00809395424f, -0.00383727244f, -0.000226523066f, -0.000333484826f, -0.00469883703f,
-    -0.0106815281f, -0.014163483f, -0.0125370887f, -0.00683003291f, -0.00127447281f,
-    -0.000403446412f, -0.00563707751f, -0.0138947387f, -0.0194821161f, -0.0181491539f,
-    -0.0104667716f, -0.0018998054f, 0.000820368752f, -0.00532735409f, -0.0169402213f, -0.0260368181f,
-    -0.0255816033f, -0.01495093f, -0.00122026553f, 0.00520519551f, -0.0019483596f, -0.0194540496f,
-    -0.0356017757f, -0.0377476212f, -0.0217617259f, 0.00329564933f, 0.0194554356f, 0.0114843852f,
-    -0.0211122695f, -0.0599952922f, -0.0758661628f, -0.0449757984f, 0.0350676593f, 0.140088588f,
-    0.228976712f, 0.263723617f, 0.228976712f, 0.140088588f, 0.0350676593f, -0.0449757984f,
-    -0.0758661628f, -0.0599952922f, -0.0211122695f, 0.0114843852f, 0.0194554356f, 0.00329564933f,
-    -0.0217617259f, -0.0377476212f, -0.0356017757f, -0.0194540496f, -0.0019483596f, 0.00520519551f,
-    -0.00122026553f, -0.01495093f, -0.0255816033f, -0.0260368181f, -0.0169402213f, -0.00532735409f,
-    0.000820368752f, -0.0018998054f, -0.0104667716f, -0.0181491539f, -0.0194821161f, -0.0138947387f,
-    -0.00563707751f, -0.000403446412f, -0.00127447281f, -0.00683003291f, -0.0125370887f,
-    -0.014163483f, -0.0106815281f, -0.00469883703f, -0.000333484826f, -0.000226523066f,
-    -0.00383727244f, -0.00809395424f, -0.00974624797f, -0.00763998688f, -0.00333958338f,
-    0.000193508334f, 0.000780704991f, -0.00152605488f, -0.00467392244f, -0.00621174269f,
-    -0.00503073496f, -0.00201854142f, 0.000734375927f, 0.00149603748f, 6.60788996e-05f,
-    -0.0022225176f, -0.0035696041f, -0.00300263972f, -0.00097684496f, 0.00107396521f, 0.00182594617f,
-    0.000975062376f, -0.000648885629f, -0.0017678498f, -0.00158648266f, -0.000296420987f,
-    0.00115527977f, 0.00179941637f, 0.00131914614f, 0.000202611882f, -0.000678820892f,
-    -0.000713945729f, 5.34544172e-05f, 0.00102594707f, 0.00152616832f, 0.00127382678f,
-    0.000535115033f, -0.000122303807f, -0.000254618935f, 0.000167102353f, 0.000785590584f,
-    0.00114856838f, 0.00103083674f, 0.000561995056f, 9.54665635e-05f, -5.99767023e-05f,
-    0.000154345372f, 0.000537189634f, 0.000795795598f, 0.000756131565f, 0.000467362034f,
-    0.000142884498f, -2.59763771e-06f, 0.000101717581f, 0.000350214392f, 0.00054991899f,
-    0.000558852411f, 0.000377193862f, 0.000135797005f, -1.31761105e-06f, 5.02136622e-05f,
-    0.000241931009f
+// butter(2, [2, 35], btype="bandpass", fs=250, output="sos") -> [b0 b1 b2 a0 a1 a2]
+const SosSection_t iir_butter_2_sos[BP_IIR_SECTIONS] = {
+    SosSection_t{ 0.106693092f, 0.0f, -0.106693092f, 1.0f, -0.890661325f, 0.337352863f },
+    SosSection_t{ 1.0f,         0.0f, -1.0f,         1.0f, -1.9295388f,   0.93223404f  },
 };
 
 static constexpr float sg_21_3_b[21] = {
@@ -121,18 +85,29 @@ EegFilterBank_C::EegFilterBank_C() {
     static bool didCheck = false;
     if (!didCheck) {
         didCheck = true;
-        log_fir_dc_gain_once(fir_hamming_201_b, 201, "fir_hamming_201_b (2-35 Hz?)");
-        // optional: compare
-        log_fir_dc_gain_once(fir_blackman_201_b, 201, "fir_blackman_201_b (2-35 Hz?)");
+        log_fir_dc_gain_once(fir_blackman_201_b, 201, "fir_blackman_201_b (5-25 Hz)");
         log_fir_dc_gain_once(sg_21_3_b, 21, "sg_21_3_b (smoother)");
     }
 
+    // until a coeff file gets loaded: blackman 201 taps (5-25 Hz), or the butterworth biquads (2-35 Hz) for low latency
+    FilterCoeffSet_S startup;
+#ifdef EEG_BANDPASS_IIR
+    builtin_filter_coeff_set("iir_butter_2", startup);
+#else
+    builtin_filter_coeff_set("fir_blackman_201", startup);
+#endif
+    bp_[0].init(startup);
     for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
-        bandpass_[ch].init_from_taps(fir_blackman_201_b); // currently Hamming 201 taps 2-35 Hz
         smooth_[ch].init_from_taps(sg_21_3_b);
-        dc_[ch].a = 0.995f;                 // try 0.995–0.999
+        dc_[ch].a = static_cast<float>(1.0 - 0.005 * 250.0 / FILTER_DESIGN_FS_HZ); // 0.995 @250 Hz (~0.2 Hz corner), try 0.995–0.999
         dc_[ch].reset(0.0f);
     }
+    lineNotch_.init(LINE_FREQ_HZ, LINE_HARMONICS, FILTER_DESIGN_FS_HZ, NUM_CH_CHUNK);
+    LOG_ALWAYS("line notch: " << LINE_FREQ_HZ << " Hz nominal, " << lineNotch_.get_num_harmonics() << " harmonic(s)");
+    if (DECIMATION > 1) {
+        LOG_ALWAYS("decimating " << ACQ_FS_HZ << " -> " << PIPELINE_FS_HZ << " Hz after the bandpass ("
+                   << NUM_SCANS_CHUNK_OUT << " scans per chunk out)");
+    }
 }
 
 // Preprocessing pipeline
@@ -144,17 +119,305 @@ void EegFilterBank_C::process_chunk(bufferChunk_S& chunk) {
     remove_common_mode_noise(chunk);
 
     // 2) frequency filtering
+    // 2a) Simple DC blocker
     for (std::size_t s = 0; s < nS; ++s) {
         for (std::size_t ch = 0; ch < nCh; ++ch) {
-            const std::size_t idx = s * nCh + ch;
-            float x = chunk.data[idx];
-            // 2a) Simple DC blocker
+            float& x = chunk.data[s * nCh + ch];
             x = dc_[ch].process(x);
-            // 2b) Bandpass FIR
-            x = bandpass_[ch].process(x);
-            chunk.data[idx] = x;
         }
     }
+    // 2b) Adaptive line noise notch (tracks mains freq, before the bandpass so residual reporting sees the raw line)
+    lineNotch_.process_interleaved(chunk.data.data(), nS);
+    // 2c) Bandpass FIR, every channel of a scan in one go (stays interleaved), + decimation
+    apply_bandpass(chunk);
+}
+
+// ======================= BANDPASS ENGINE + HOT SWAP =========================
+bool builtin_filter_coeff_set(const std::string& id, FilterCoeffSet_S& out) {
+    out = FilterCoeffSet_S{};
+    out.fs = FILTER_DESIGN_FS_HZ;
+    constexpr bool tablesFit = (ACQ_FS_HZ == 250);
+    if (id == "fir_blackman_201") {
+        out.kind = FilterKind_FIR;
+        if (tablesFit) out.b.assign(fir_blackman_201_b, fir_blackman_201_b + BP_TAPS);
+        else out.b = design_fir_bandpass(BP_FIR_LO_HZ, BP_FIR_HI_HZ, FILTER_DESIGN_FS_HZ, BP_TAPS_AT_RATE);
+    } else if (id == "iir_butter_2") {
+        out.kind = FilterKind_SOS;
+        if (tablesFit) out.sos.assign(iir_butter_2_sos, iir_butter_2_sos + BP_IIR_SECTIONS);
+        else out.sos = design_butter_bandpass_sos(2, BP_IIR_LO_HZ, BP_IIR_HI_HZ, FILTER_DESIGN_FS_HZ);
+    } else {
+        return false;
+    }
+    out.id = id + (tablesFit ? " (built-in)" : " (built-in, designed @" + std::to_string(ACQ_FS_HZ) + " Hz)");
+    out.name = out.id;
+    return true;
+}
+
+void BandpassEngine_S::init(const FilterCoeffSet_S& set) {
+    if (set.kind == FilterKind_SOS) {
+        init_sos(set.sos.data(), set.sos.size());
+    } else {
+        init_fir(set.b.data(), set.b.size());
+    }
+    id = set.id;
+    coeffs = set;
+}
+
+void BandpassEngine_S::init_fir(const float* taps, std::size_t n) {
+    kind = FilterKind_FIR;
+    nTaps = n;
+    warmupScans = n;                        // delay line full
+    groupDelaySamples = 0.5 * double(n - 1);
+    direct.init(taps, n, NUM_CH_CHUNK); // best SIMD path for this CPU
+    if (BP_FFT_FITS_CHUNK) fft.init(taps, n, NUM_CH_CHUNK, NUM_SCANS_CHUNK);
+
+    // go FFT only if it beats the direct kernel we actually have
+    const FirSimdPath_E path = direct.get_path();
+    const std::size_t lanes = (path == FirSimd_AVX2) ? 8 : (path == FirSimd_Scalar) ? 1 : 4;
+    // decimating: direct only computes the kept outputs, fft still makes all of them
+    const double directCost = direct_fir_cost_per_sample(n, direct.is_symmetric(), lanes) / double(DECIMATION);
+    const double fftCost = BP_FFT_FITS_CHUNK ? overlap_save_cost_per_sample(n, NUM_SCANS_CHUNK) : 0.0;
+    useFft = BP_FFT_FITS_CHUNK && fftCost < directCost;
+    if (BP_FFT_FITS_CHUNK) {
+        LOG_ALWAYS("bandpass FIR (" << n << " taps): " << (useFft ? "fft overlap-save" : FirSimdPath_to_string(path))
+                   << (direct.is_symmetric() ? " (symmetric taps)" : "")
+                   << " [cost/sample direct=" << directCost << " fft=" << fftCost << "]");
+    } else {
+        LOG_ALWAYS("bandpass FIR (" << n << " taps): " << FirSimdPath_to_string(path)
+                   << (direct.is_symmetric() ? " (symmetric taps)" : "")
+                   << " [no fft, " << NUM_SCANS_CHUNK << " scan chunks aren't a power of two]");
+    }
+}
+
+void BandpassEngine_S::init_sos(const SosSection_t* sos, std::size_t nSec) {
+    kind = FilterKind_SOS;
+    nTaps = nSec;
+    useFft = false;
+    iir.init(sos, nSec, NUM_CH_CHUNK);
+    groupDelaySamples = sos_group_delay_samples(sos, nSec, BP_DELAY_REF_HZ, FILTER_DESIGN_FS_HZ);
+
+    // no delay line to fill; wait for the slowest pole to decay to ~1e-4
+    warmupScans = sos_settle_samples(sos, nSec, 1e-4);
+    LOG_ALWAYS("bandpass IIR (" << nSec << " sections): " << FirSimdPath_to_string(iir.get_path())
+               << " [group delay " << groupDelaySamples << " samples @ " << BP_DELAY_REF_HZ << " Hz, warmup "
+               << warmupScans << " scans]");
+}
+
+std::size_t BandpassEngine_S::process(float* data, std::size_t nScans, std::size_t decim) {
+    if (kind == FilterKind_FIR && !useFft) {
+        if (decim > 1) return direct.process_interleaved_decim(data, nScans, decim);
+        direct.process_interleaved(data, nScans);
+        return nScans;
+    }
+    if (kind == FilterKind_SOS) {
+        iir.process_interleaved(data, nScans);
+    } else {
+        fft.process_interleaved(data, nScans);
+    }
+    if (decim <= 1) return nScans;
+
+    // full rate output -> keep every decim-th scan (nOut <= sc, in place is fine)
+    std::size_t nOut = 0;
+    for (std::size_t sc = 0; sc < nScans; ++sc) {
+        if (decimPhase == 0) {
+            std::copy_n(data + sc * NUM_CH_CHUNK, NUM_CH_CHUNK, data + nOut * NUM_CH_CHUNK);
+            ++nOut;
+        }
+        decimPhase = (decimPhase + 1 == decim) ? 0 : decimPhase + 1;
+    }
+    return nOut;
+}
+
+const char* BandpassEngine_S::engine_name() const {
+    if (kind == FilterKind_SOS) {
+        switch (iir.get_path()) {
+            case FirSimd_AVX2: return "iir sos avx2";
+            case FirSimd_SSE:  return "iir sos sse";
+            case FirSimd_NEON: return "iir sos neon";
+            default:           return "iir sos scalar";
+        }
+    }
+    if (useFft) return "fir fft overlap-save";
+    switch (direct.get_path()) {
+        case FirSimd_AVX2: return "fir avx2";
+        case FirSimd_SSE:  return "fir sse";
+        case FirSimd_NEON: return "fir neon";
+        default:           return "fir scalar";
+    }
+}
+
+void EegFilterBank_C::apply_bandpass(bufferChunk_S& chunk) {
+    constexpr std::size_t nS = NUM_SAMPLES_CHUNK / NUM_CH_CHUNK;
+    const int active = activeBp_.load(std::memory_order_relaxed); // only we write it
+
+    if (swapState_.load(std::memory_order_acquire) == Swap_Warming) {
+        // standby was built by the loader (acquire above makes its writes visible).
+        // run it on the same input until its delay line is full -> no transient when we flip
+        BandpassEngine_S& standby = bp_[1 - active];
+        std::copy(chunk.data.begin(), chunk.data.end(), warmBuf_.begin());
+        const std::size_t nOut = standby.process(warmBuf_.data(), nS, DECIMATION);
+        warmScans_ += nS;
+        if (warmScans_ >= standby.warmupScans) {
+            std::copy_n(warmBuf_.begin(), nOut * NUM_CH_CHUNK, chunk.data.begin());
+            chunk.numScans = nOut;
+            activeBp_.store(1 - active, std::memory_order_release);
+            swaps_.fetch_add(1, std::memory_order_relaxed);
+            swapState_.store(Swap_Idle, std::memory_order_release);
+            statusChanged_.store(true, std::memory_order_release);
+            return;
+        }
+    }
+    chunk.numScans = bp_[active].process(chunk.data.data(), nS, DECIMATION);
+}
+
+bool EegFilterBank_C::request_bandpass_swap(const std::string& path, const std::string& id) {
+    int expected = Swap_Idle;
+    if (!swapState_.compare_exchange_strong(expected, Swap_Building, std::memory_order_acq_rel)) {
+        return false; // one at a time
+    }
+    if (loader_.joinable()) loader_.join(); // previous loader is done (state was Idle)
+    statusChanged_.store(true, std::memory_order_release);
+    loader_ = std::thread(&EegFilterBank_C::load_standby, this, path, id);
+    return true;
+}
+
+void EegFilterBank_C::load_standby(std::string path, std::string id) {
+    logger::tlabel = "filter loader";
+    FilterCoeffSet_S set;
+    std::string err;
+    const bool builtin = path.empty() || path == "builtin";
+    if (builtin && !builtin_filter_coeff_set(id, set)) {
+        err = "no built-in set \"" + id + "\"";
+    } else if (!builtin && !load_filter_coeff_set(path, id, set, err)) {
+        // err filled
+    } else if (set.kind == FilterKind_SOS && !sos_is_stable(set.sos.data(), set.sos.size())) {
+        err = id + ": unstable sos (pole on/outside the unit circle)";
+    } else if (set.fs != 0.0 && std::fabs(set.fs - FILTER_DESIGN_FS_HZ) > 1e-6) {
+        err = id + ": designed for fs=" + std::to_string(set.fs) + " Hz, pipeline runs at " + std::to_string(FILTER_DESIGN_FS_HZ);
+    } else if (set.b.size() > MAX_LOADED_FIR_TAPS) {
+        err = id + ": too many taps (" + std::to_string(set.b.size()) + ")";
+    }
+
+    BandpassEngine_S built;
+    if (err.empty()) {
+        built.init(set); // heavy part (fft partitions etc), no lock held
+    }
+    {
+        // producer doesn't touch the standby while we're in Swap_Building; lock is for status readers
+        std::lock_guard<std::mutex> lock(statusMtx_);
+        if (err.empty()) {
+            bp_[1 - activeBp_.load(std::memory_order_acquire)] = std::move(built);
+            warmScans_ = 0;
+        }
+        lastError_ = err;
+    }
+    if (err.empty()) {
+        LOG_ALWAYS("bandpass swap: built " << id << ", warming up");
+        swapState_.store(Swap_Warming, std::memory_order_release); // hands standby + warmScans_ to the producer
+    } else {
+        LOG_ALWAYS("bandpass swap failed: " << err);
+        swapState_.store(Swap_Idle, std::memory_order_release);
+    }
+    statusChanged_.store(true, std::memory_order_release);
+}
+
+BandpassStatus_S EegFilterBank_C::get_bandpass_status() const {
+    BandpassStatus_S st;
+    const int state = swapState_.load(std::memory_order_acquire);
+    // only fields set by init() are read here; the loader rebuilds engines under the same lock
+    std::lock_guard<std::mutex> lock(statusMtx_);
+    const BandpassEngine_S& a = bp_[activeBp_.load(std::memory_order_acquire)];
+    st.active_id = a.id;
+    st.taps = a.nTaps;
+    st.engine = a.engine_name();
+    st.group_delay_ms = 1000.0 * a.groupDelaySamples / FILTER_DESIGN_FS_HZ;
+    st.swap_in_progress = (state != Swap_Idle);
+    st.swaps = swaps_.load(std::memory_order_relaxed);
+    st.last_error = lastError_;
+    st.coeffs = a.coeffs;
+    return st;
+}
+
+// ========================= OFFLINE ZERO-PHASE ==============================
+// odd reflection of pad samples at each end (scipy filtfilt "odd" padding): keeps value + slope continuous
+// at the edges, so neither pass starts on a step
+static void filtfilt_channel(const FilterCoeffSet_S& set, std::size_t pad, float* x, std::size_t n, std::vector<float>& work) {
+    pad = std::min(pad, n - 1);
+    const std::size_t len = n + 2 * pad;
+    work.resize(len);
+    for (std::size_t i = 0; i < pad; ++i) {
+        work[i] = 2.0f * x[0] - x[pad - i];
+        work[pad + n + i] = 2.0f * x[n - 1] - x[n - 2 - i];
+    }
+    std::copy_n(x, n, work.begin() + pad);
+
+    auto pass = [&]() {
+        if (set.kind == FilterKind_SOS) {
+            MultiChSos_C iir;
+            iir.init(set.sos.data(), set.sos.size(), 1);
+            iir.process_interleaved(work.data(), len);
+        } else {
+            MultiChFir_C fir;
+            fir.init(set.b.data(), set.b.size(), 1);
+            fir.process_interleaved(work.data(), len);
+        }
+    };
+    pass();
+    std::reverse(work.begin(), work.end());
+    pass();
+    std::reverse(work.begin(), work.end());
+    std::copy_n(work.begin() + pad, n, x);
+}
+
+std::size_t EegFilterBank_C::process_session_zero_phase(const FilterCoeffSet_S& set, std::vector<float>& data, unsigned nThreads) {
+    constexpr std::size_t nCh = NUM_CH_CHUNK;
+    const std::size_t nS = data.size() / nCh;
+    if (nS < 2) return 0;
+
+    // 1) CAR + line notch, same as online (the notch only touches a ~0.4 Hz band, its phase doesn't matter here)
+    for (std::size_t s = 0; s < nS; ++s) {
+        float mean = 0.0f;
+        for (std::size_t ch = 0; ch < nCh; ++ch) mean += data[s * nCh + ch];
+        mean /= static_cast<float>(nCh);
+        for (std::size_t ch = 0; ch < nCh; ++ch) data[s * nCh + ch] -= mean;
+    }
+    AdaptiveLineNotch_C notch;
+    notch.init(LINE_FREQ_HZ, LINE_HARMONICS, FILTER_DESIGN_FS_HZ, nCh);
+    notch.process_interleaved(data.data(), nS);
+
+    // 2) per channel: remove the mean (instead of the DC blocker, which isn't zero phase), then filtfilt.
+    // pad like scipy (3x filter length), IIR: at least until the slowest pole has settled
+    const std::size_t pad = (set.kind == FilterKind_SOS)
+        ? std::max<std::size_t>(3 * (2 * set.sos.size() + 1), sos_settle_samples(set.sos.data(), set.sos.size(), 1e-4))
+        : 3 * set.b.size();
+    auto worker = [&](std::size_t first, std::size_t step) {
+        std::vector<float> x(nS), work;
+        for (std::size_t ch = first; ch < nCh; ch += step) {
+            double sum = 0.0;
+            for (std::size_t s = 0; s < nS; ++s) sum += data[s * nCh + ch];
+            const float mean = static_cast<float>(sum / double(nS));
+            for (std::size_t s = 0; s < nS; ++s) x[s] = data[s * nCh + ch] - mean;
+            filtfilt_channel(set, pad, x.data(), nS, work);
+            for (std::size_t s = 0; s < nS; ++s) data[s * nCh + ch] = x[s]; // each thread owns its columns
+        }
+    };
+    const std::size_t nWorkers = std::clamp<std::size_t>(nThreads, 1, nCh);
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < nWorkers; ++t) pool.emplace_back(worker, t, nWorkers);
+    worker(0, nWorkers);
+    for (auto& th : pool) th.join();
+
+    // 3) decimate (the zero-phase bandpass is the anti-alias filter)
+    const std::size_t nOut = (nS + DECIMATION - 1) / DECIMATION;
+    for (std::size_t m = 1; m < nOut; ++m) {
+        std::copy_n(data.begin() + m * DECIMATION * nCh, nCh, data.begin() + m * nCh);
+    }
+    data.resize(nOut * nCh);
+    return nOut;
+}
+
+EegFilterBank_C::~EegFilterBank_C() {
+    if (loader_.joinable()) loader_.join();
 }
 
 // per sample cross channel mean subtraction (CAR)
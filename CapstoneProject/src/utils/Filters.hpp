@@ -7,12 +7,23 @@
 #include "../utils/Logger.hpp"
 #include <cstddef>
 #include <algorithm>
+#include "FirSimd.hpp"
+#include "OverlapSaveFir.hpp"
+#include "SosIir.hpp"
+#include "LineNotch.hpp"
+#include "FilterCoeffs.hpp"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
 
 /* ALL PREPROCESSING LIVES HERE */
 /* MUTATES CHUNKS IN PLACE:
-1) Bandpass FIR Filter from 0.1 to 35Hz
+1) Bandpass FIR Filter from 5 to 25Hz (IIR build: 2 to 35Hz)
 2) DC removal
 3) Artifact rejection
+4) Decimation by DECIMATION (EEG_DECIMATION from cmake): the bandpass doubles as the anti-alias filter
+   (nothing above ~40 Hz survives it, 125 Hz output has nyquist 62.5), chunk.numScans shrinks to NUM_SCANS_CHUNK_OUT
 */
 
 // EEG signals are typically <100uV. Artifacts produce the huge swings, so we want to look out for those.
@@ -20,6 +31,32 @@ static constexpr float MAX_SPIKE_AMP_UV = 175;
 // Point-to-point jumps are also likely artifactual, can't be real change in EEG
 static constexpr float MAX_BTWN_SAMPLE_STEP_UV = 100;
 
+// from FilterDesign.py (defined in Filters.cpp). Built-in default until a coeff file is loaded.
+// tables are for 250 Hz; other EEG_FS_HZ builds design the same filters at startup (FilterDesign.hpp)
+static constexpr double BP_FIR_LO_HZ = 5.0;  // what fir_blackman_201_b actually is (firwin fit to ~1e-9), not 2-35
+static constexpr double BP_FIR_HI_HZ = 25.0;
+static constexpr double BP_IIR_LO_HZ = 2.0;
+static constexpr double BP_IIR_HI_HZ = 35.0;
+static constexpr std::size_t BP_TAPS = 201;
+static constexpr std::size_t BP_TAPS_AT_RATE = (BP_TAPS - 1) * ACQ_FS_HZ / 250 + 1; // same transition width in Hz
+extern const float fir_blackman_201_b[BP_TAPS];
+// low latency alternative: butter(2, [2, 35], "bandpass", output="sos"), ~3 samples group delay vs 100
+static constexpr std::size_t BP_IIR_SECTIONS = 2;
+extern const SosSection_t iir_butter_2_sos[BP_IIR_SECTIONS];
+static constexpr double BP_DELAY_REF_HZ = 10.0;            // group delay reported at a typical SSVEP freq
+static constexpr double FILTER_DESIGN_FS_HZ = double(ACQ_FS_HZ); // coeff sets must be designed for this rate
+static constexpr std::size_t MAX_LOADED_FIR_TAPS = 4096;  // sanity cap on loaded sets
+
+// mains: set from cmake (EEG_LINE_FREQ_HZ / EEG_LINE_HARMONICS), fundamental counts as harmonic 1
+#ifndef EEG_LINE_FREQ_HZ
+#define EEG_LINE_FREQ_HZ 60
+#endif
+#ifndef EEG_LINE_HARMONICS
+#define EEG_LINE_HARMONICS 2
+#endif
+static constexpr double LINE_FREQ_HZ = EEG_LINE_FREQ_HZ;
+static constexpr std::size_t LINE_HARMONICS = EEG_LINE_HARMONICS;
+
 struct DcBlocker1P {
     // y[n] = x[n] - x[n-1] + a*y[n-1]
     // a close to 1 => lower cutoff (slower drift removed)
@@ -41,12 +78,15 @@ struct DcBlocker1P {
 //
 //   y[n] = Σ b[k] · x[n−k]
 //
-// Delay line mapping:
-//   state[0] = x[n], state[1] = x[n−1], ...
+// Delay line is double length (2N) so nothing ever gets shifted:
+//   each sample is written twice, at state[pos] and state[pos+N], and pos walks
+//   backwards, so state[pos .. pos+N) is always [x[n], x[n−1], ..., x[n−N+1]]
+//   -> one contiguous dot product with taps, no wrap check inside it.
 template<std::size_t N>
 struct FirFilter_T {
-    std::array<float, N> taps{};   // coefficients (filter taps)
-    std::array<float, N> state{};  // delay line
+    std::array<float, N> taps{};       // coefficients (filter taps)
+    std::array<float, 2 * N> state{};  // mirrored delay line
+    std::size_t pos = 0;               // state[pos] = newest sample
 
     FirFilter_T() = default;
 
@@ -54,43 +94,130 @@ struct FirFilter_T {
     void init_from_taps(const float (&coeffs)[N]) {
         for (std::size_t i = 0; i < N; ++i) {
             taps[i]  = coeffs[i];
-            state[i] = 0.0f;
         }
+        reset();
+    }
+
+    void reset() {
+        state.fill(0.0f);
+        pos = 0;
     }
 
     // process new sample x in chunk
     inline float process(float x) {
-        // Shift state (simple FIR delay line)
-        for (std::size_t i = N - 1; i > 0; --i) {
-            state[i] = state[i - 1];
-        }
-        state[0] = x; // get output for state like [C,B,A(...)] where A is oldest
+        pos = (pos == 0) ? N - 1 : pos - 1;
+        state[pos] = x;
+        state[pos + N] = x;
 
+        const float* s = state.data() + pos;
         float y = 0.0f;
-        // 
         for (std::size_t i = 0; i < N; ++i) {
-            y += taps[i] * state[i];
+            y += taps[i] * s[i];
         }
         return y;
     }
+
+    // filter n contiguous samples of ONE channel (in == out is fine)
+    inline void process_block(const float* in, float* out, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = process(in[i]);
+        }
+    }
+};
+
+// built-in sets, usable as swap targets with file "" / "builtin": "fir_blackman_201", "iir_butter_2"
+// (names are the 250 Hz designs; at other rates you get the same filter with BP_TAPS_AT_RATE taps / same order)
+bool builtin_filter_coeff_set(const std::string& id, FilterCoeffSet_S& out);
+
+// overlap-save runs one radix-2 fft block per chunk -> only an option when the chunk is a power of two
+// (375 / 625 / 750 Hz builds have 48 / 80 / 96 scan chunks and always take the direct kernel)
+inline constexpr bool BP_FFT_FITS_CHUNK = (NUM_SCANS_CHUNK & (NUM_SCANS_CHUNK - 1)) == 0;
+
+// One bandpass implementation:
+// FIR -> direct SIMD or FFT overlap-save (picked by the cost model), linear phase, (N-1)/2 delay
+// SOS -> IIR biquad cascade, nonlinear phase but only a few samples of delay + ~10 flops/sample/section
+struct BandpassEngine_S {
+    std::string id;
+    FilterCoeffSet_S coeffs;          // what it was built from (offline path re-runs the same set)
+    FilterKind_E kind = FilterKind_FIR;
+    MultiChFir_C direct;
+    OverlapSaveFir_C fft;
+    bool useFft = false;
+    MultiChSos_C iir;
+    std::size_t nTaps = 0;            // FIR taps, or SOS sections
+    std::size_t warmupScans = 0;      // scans until the output has no startup transient
+    double groupDelaySamples = 0.0;   // at BP_DELAY_REF_HZ, input rate
+    std::size_t decimPhase = 0;       // fft/iir paths: input scans since the last kept output
+
+    void init(const FilterCoeffSet_S& set);
+    void init_fir(const float* taps, std::size_t n);
+    void init_sos(const SosSection_t* sos, std::size_t nSec);
+    // filters nScans in place and keeps every decim-th output scan (compacted to the front); returns scans kept.
+    // direct FIR only computes the kept outputs, fft/iir need every output anyway and just drop the rest
+    std::size_t process(float* data, std::size_t nScans, std::size_t decim = 1);
+    const char* engine_name() const;
+};
+
+struct BandpassStatus_S {
+    std::string active_id;
+    std::string engine;      // "fir avx2", "fir fft overlap-save", "iir sos avx2", ...
+    std::size_t taps = 0;    // taps or sections
+    double group_delay_ms = 0.0;
+    bool swap_in_progress = false;
+    std::string last_error;  // from the last load attempt ("" if it worked)
+    unsigned swaps = 0;      // completed swaps
+    FilterCoeffSet_S coeffs; // active set
 };
 
 class EegFilterBank_C {
 public:
     EegFilterBank_C();
+    ~EegFilterBank_C();
     // Entry point: preprocessing pipeline
     void process_chunk(bufferChunk_S& chunk);
+
+    // HOT SWAP (any thread): loads set `id` from a FilterDesign.py json file (or a built-in set) on a loader thread,
+    // builds it into the standby engine, then the producer warms it up on live data and flips
+    // to it at a chunk boundary. Never blocks process_chunk. false if a swap is already running.
+    bool request_bandpass_swap(const std::string& path, const std::string& id);
+    BandpassStatus_S get_bandpass_status() const;
+    bool consume_status_changed() { return statusChanged_.exchange(false, std::memory_order_acq_rel); };
+    // producer only: group delay of the bandpass that's live right now (what filtering adds to sample age)
+    double get_latency_ms() const { return 1000.0 * bp_[activeBp_.load(std::memory_order_relaxed)].groupDelaySamples / FILTER_DESIGN_FS_HZ; };
+    // producer only (reads notch state right after process_chunk)
+    const AdaptiveLineNotch_C& get_line_notch() const { return lineNotch_; };
+
+    // OFFLINE (whole recording at once, e.g. calib export): CAR -> line notch -> bandpass run forward AND
+    // backward (zero phase: no group delay, no startup transient, magnitude |H|^2) -> decimation.
+    // data = raw interleaved scans (NUM_CH_CHUNK stride), overwritten with the result at PIPELINE_FS_HZ;
+    // returns the scans left. Channels are independent after CAR + notch -> split over nThreads
+    static std::size_t process_session_zero_phase(const FilterCoeffSet_S& set, std::vector<float>& data, unsigned nThreads);
+
 private:
-    static constexpr std::size_t BP_TAPS = 201;
-    using BandpassFilter = FirFilter_T<BP_TAPS>;
     using SmoothFilter   = FirFilter_T<21>;   // Savitzky–Golay, 21-point
 
     // todo: read ch from statestore instead of using num_ch_chunk
-    std::array<BandpassFilter, NUM_CH_CHUNK> bandpass_; // one for each channel of data
+    // double-buffered bandpass: producer runs bp_[activeBp_], loader builds the other one
+    enum SwapState_E { Swap_Idle = 0, Swap_Building, Swap_Warming };
+    std::array<BandpassEngine_S, 2> bp_;
+    std::atomic<int> activeBp_{0};         // flipped by the producer only
+    std::atomic<int> swapState_{Swap_Idle};
+    std::size_t warmScans_ = 0;            // producer only
+    std::array<float, NUM_SAMPLES_CHUNK> warmBuf_{};
+    std::thread loader_;
+    // loader + get_bandpass_status(). the producer reads status too, but only after consume_status_changed()
+    // (a swap / failed load), and the loader only holds it for the move, never across the engine init
+    mutable std::mutex statusMtx_;
+    std::string lastError_;
+    std::atomic<unsigned> swaps_{0};
+    std::atomic<bool> statusChanged_{true};
+
     std::array<SmoothFilter,   NUM_CH_CHUNK> smooth_;
     DcBlocker1P dc_[NUM_CH_CHUNK];
+    AdaptiveLineNotch_C lineNotch_;
 
     // Preprocessing pipeline:
     void apply_bandpass(bufferChunk_S& chunk);
     void remove_common_mode_noise(bufferChunk_S& chunk);
+    void load_standby(std::string path, std::string id); // loader thread body
 };
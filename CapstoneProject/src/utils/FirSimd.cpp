@@ -0,0 +1,281 @@
+#include "FirSimd.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define FIR_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define FIR_TARGET_AVX2 // MSVC lets us use the intrinsics without /arch
+    #else
+        #define FIR_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define FIR_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+static constexpr std::size_t LANE_PAD = 8;
+
+// ============================ KERNELS ===============================
+// s points at the newest scan; row k (stride floats apart) holds x[n-k] for every channel
+
+static void kernel_scalar(const float* taps, std::size_t nTaps, bool symmetric,
+                          const float* s, std::size_t stride, float* out) {
+    for (std::size_t ch = 0; ch < stride; ++ch) {
+        float acc = 0.0f;
+        if (symmetric) {
+            const std::size_t half = nTaps / 2;
+            for (std::size_t k = 0; k < half; ++k) {
+                acc += taps[k] * (s[k * stride + ch] + s[(nTaps - 1 - k) * stride + ch]);
+            }
+            if (nTaps & 1) {
+                acc += taps[half] * s[half * stride + ch];
+            }
+        } else {
+            for (std::size_t k = 0; k < nTaps; ++k) {
+                acc += taps[k] * s[k * stride + ch];
+            }
+        }
+        out[ch] = acc;
+    }
+}
+
+#if defined(FIR_SIMD_X86)
+// SSE is baseline on x86-64, so no target attribute needed
+static void kernel_sse(const float* taps, std::size_t nTaps, bool symmetric,
+                       const float* s, std::size_t stride, float* out) {
+    for (std::size_t g = 0; g < stride; g += 4) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps(); // 2 accumulators to hide add latency
+        if (symmetric) {
+            const std::size_t half = nTaps / 2;
+            std::size_t k = 0;
+            for (; k + 1 < half; k += 2) {
+                const __m128 p0 = _mm_add_ps(_mm_loadu_ps(s + k * stride + g),
+                                             _mm_loadu_ps(s + (nTaps - 1 - k) * stride + g));
+                const __m128 p1 = _mm_add_ps(_mm_loadu_ps(s + (k + 1) * stride + g),
+                                             _mm_loadu_ps(s + (nTaps - 2 - k) * stride + g));
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_set1_ps(taps[k]), p0));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_set1_ps(taps[k + 1]), p1));
+            }
+            for (; k < half; ++k) {
+                const __m128 p = _mm_add_ps(_mm_loadu_ps(s + k * stride + g),
+                                            _mm_loadu_ps(s + (nTaps - 1 - k) * stride + g));
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_set1_ps(taps[k]), p));
+            }
+            if (nTaps & 1) {
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_set1_ps(taps[half]), _mm_loadu_ps(s + half * stride + g)));
+            }
+        } else {
+            for (std::size_t k = 0; k < nTaps; ++k) {
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_set1_ps(taps[k]), _mm_loadu_ps(s + k * stride + g)));
+            }
+        }
+        _mm_storeu_ps(out + g, _mm_add_ps(acc0, acc1));
+    }
+}
+
+FIR_TARGET_AVX2
+static void kernel_avx2(const float* taps, std::size_t nTaps, bool symmetric,
+                        const float* s, std::size_t stride, float* out) {
+    for (std::size_t g = 0; g < stride; g += 8) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        if (symmetric) {
+            const std::size_t half = nTaps / 2;
+            std::size_t k = 0;
+            for (; k + 1 < half; k += 2) {
+                const __m256 p0 = _mm256_add_ps(_mm256_loadu_ps(s + k * stride + g),
+                                                _mm256_loadu_ps(s + (nTaps - 1 - k) * stride + g));
+                const __m256 p1 = _mm256_add_ps(_mm256_loadu_ps(s + (k + 1) * stride + g),
+                                                _mm256_loadu_ps(s + (nTaps - 2 - k) * stride + g));
+                acc0 = _mm256_fmadd_ps(_mm256_set1_ps(taps[k]), p0, acc0);
+                acc1 = _mm256_fmadd_ps(_mm256_set1_ps(taps[k + 1]), p1, acc1);
+            }
+            for (; k < half; ++k) {
+                const __m256 p = _mm256_add_ps(_mm256_loadu_ps(s + k * stride + g),
+                                               _mm256_loadu_ps(s + (nTaps - 1 - k) * stride + g));
+                acc0 = _mm256_fmadd_ps(_mm256_set1_ps(taps[k]), p, acc0);
+            }
+            if (nTaps & 1) {
+                acc1 = _mm256_fmadd_ps(_mm256_set1_ps(taps[half]), _mm256_loadu_ps(s + half * stride + g), acc1);
+            }
+        } else {
+            for (std::size_t k = 0; k < nTaps; ++k) {
+                acc0 = _mm256_fmadd_ps(_mm256_set1_ps(taps[k]), _mm256_loadu_ps(s + k * stride + g), acc0);
+            }
+        }
+        _mm256_storeu_ps(out + g, _mm256_add_ps(acc0, acc1));
+    }
+}
+#endif // FIR_SIMD_X86
+
+#if defined(FIR_SIMD_NEON)
+static void kernel_neon(const float* taps, std::size_t nTaps, bool symmetric,
+                        const float* s, std::size_t stride, float* out) {
+    for (std::size_t g = 0; g < stride; g += 4) {
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        if (symmetric) {
+            const std::size_t half = nTaps / 2;
+            std::size_t k = 0;
+            for (; k + 1 < half; k += 2) {
+                const float32x4_t p0 = vaddq_f32(vld1q_f32(s + k * stride + g),
+                                                 vld1q_f32(s + (nTaps - 1 - k) * stride + g));
+                const float32x4_t p1 = vaddq_f32(vld1q_f32(s + (k + 1) * stride + g),
+                                                 vld1q_f32(s + (nTaps - 2 - k) * stride + g));
+                acc0 = vfmaq_n_f32(acc0, p0, taps[k]);
+                acc1 = vfmaq_n_f32(acc1, p1, taps[k + 1]);
+            }
+            for (; k < half; ++k) {
+                const float32x4_t p = vaddq_f32(vld1q_f32(s + k * stride + g),
+                                                vld1q_f32(s + (nTaps - 1 - k) * stride + g));
+                acc0 = vfmaq_n_f32(acc0, p, taps[k]);
+            }
+            if (nTaps & 1) {
+                acc1 = vfmaq_n_f32(acc1, vld1q_f32(s + half * stride + g), taps[half]);
+            }
+        } else {
+            for (std::size_t k = 0; k < nTaps; ++k) {
+                acc0 = vfmaq_n_f32(acc0, vld1q_f32(s + k * stride + g), taps[k]);
+            }
+        }
+        vst1q_f32(out + g, vaddq_f32(acc0, acc1));
+    }
+}
+#endif // FIR_SIMD_NEON
+
+// ========================= RUNTIME DISPATCH =========================
+bool fir_simd_path_supported(FirSimdPath_E p) {
+    switch (p) {
+    case FirSimd_Scalar:
+        return true;
+#if defined(FIR_SIMD_X86)
+    case FirSimd_SSE:
+        return true;
+    case FirSimd_AVX2: {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        if (!osxsave || !fma) return false;
+        if ((_xgetbv(0) & 0x6) != 0x6) return false; // OS saves YMM state
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    #endif
+    }
+#endif
+#if defined(FIR_SIMD_NEON)
+    case FirSimd_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+FirSimdPath_E fir_simd_detect_best_path() {
+    if (fir_simd_path_supported(FirSimd_AVX2)) return FirSimd_AVX2;
+    if (fir_simd_path_supported(FirSimd_NEON)) return FirSimd_NEON;
+    if (fir_simd_path_supported(FirSimd_SSE))  return FirSimd_SSE;
+    return FirSimd_Scalar;
+}
+
+const char* FirSimdPath_to_string(FirSimdPath_E p) {
+    switch (p) {
+        case FirSimd_Scalar: return "scalar";
+        case FirSimd_SSE:    return "sse";
+        case FirSimd_AVX2:   return "avx2";
+        case FirSimd_NEON:   return "neon";
+    }
+    return "unknown";
+}
+
+static MultiChFir_C::Kernel_t kernel_for(FirSimdPath_E p) {
+    switch (p) {
+#if defined(FIR_SIMD_X86)
+        case FirSimd_SSE:  return &kernel_sse;
+        case FirSimd_AVX2: return &kernel_avx2;
+#endif
+#if defined(FIR_SIMD_NEON)
+        case FirSimd_NEON: return &kernel_neon;
+#endif
+        default:           return &kernel_scalar;
+    }
+}
+
+// ============================ FILTER ================================
+void MultiChFir_C::init(const float* taps, std::size_t nTaps, std::size_t nCh) {
+    init(taps, nTaps, nCh, fir_simd_detect_best_path());
+}
+
+void MultiChFir_C::init(const float* taps, std::size_t nTaps, std::size_t nCh, FirSimdPath_E path) {
+    assert(nTaps > 0 && nCh > 0);
+    nTaps_ = nTaps;
+    nCh_ = nCh;
+    nChPad_ = ((nCh + LANE_PAD - 1) / LANE_PAD) * LANE_PAD;
+    taps_.assign(taps, taps + nTaps);
+
+    // exact compare on purpose: FilterDesign.py writes mirrored values
+    symmetric_ = true;
+    for (std::size_t k = 0; k < nTaps / 2; ++k) {
+        if (taps_[k] != taps_[nTaps - 1 - k]) {
+            symmetric_ = false;
+            break;
+        }
+    }
+
+    path_ = fir_simd_path_supported(path) ? path : FirSimd_Scalar;
+    kernel_ = kernel_for(path_);
+    state_.assign(2 * nTaps_ * nChPad_, 0.0f);
+    out_.assign(nChPad_, 0.0f);
+    pos_ = 0;
+    decimPhase_ = 0;
+}
+
+void MultiChFir_C::reset() {
+    std::fill(state_.begin(), state_.end(), 0.0f);
+    pos_ = 0;
+    decimPhase_ = 0;
+}
+
+void MultiChFir_C::process_interleaved(float* data, std::size_t nScans) {
+    const std::size_t rowBytes = nCh_ * sizeof(float);
+    for (std::size_t sc = 0; sc < nScans; ++sc) {
+        float* scan = data + sc * nCh_;
+        // newest scan goes in at row pos_ and its mirror pos_+nTaps_
+        pos_ = (pos_ == 0) ? nTaps_ - 1 : pos_ - 1;
+        std::memcpy(&state_[pos_ * nChPad_], scan, rowBytes);
+        std::memcpy(&state_[(pos_ + nTaps_) * nChPad_], scan, rowBytes);
+
+        kernel_(taps_.data(), nTaps_, symmetric_, &state_[pos_ * nChPad_], nChPad_, out_.data());
+        std::memcpy(scan, out_.data(), rowBytes);
+    }
+}
+
+std::size_t MultiChFir_C::process_interleaved_decim(float* data, std::size_t nScans, std::size_t decim) {
+    const std::size_t rowBytes = nCh_ * sizeof(float);
+    std::size_t nOut = 0;
+    for (std::size_t sc = 0; sc < nScans; ++sc) {
+        const float* scan = data + sc * nCh_;
+        // every scan has to go through the delay line...
+        pos_ = (pos_ == 0) ? nTaps_ - 1 : pos_ - 1;
+        std::memcpy(&state_[pos_ * nChPad_], scan, rowBytes);
+        std::memcpy(&state_[(pos_ + nTaps_) * nChPad_], scan, rowBytes);
+
+        // ...but only every decim-th output gets computed (nOut <= sc, so writing in place is safe)
+        if (decimPhase_ == 0) {
+            kernel_(taps_.data(), nTaps_, symmetric_, &state_[pos_ * nChPad_], nChPad_, out_.data());
+            std::memcpy(data + nOut * nCh_, out_.data(), rowBytes);
+            ++nOut;
+        }
+        decimPhase_ = (decimPhase_ + 1 == decim) ? 0 : decimPhase_ + 1;
+    }
+    return nOut;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/* MULTI-CHANNEL SIMD FIR
+- Filters ALL channels of a scan at once, straight on the time-major interleaved
+  layout of bufferChunk_S::data (8 ch = one AVX register, or two SSE/NEON ones)
+- Same double-length delay line trick as FirFilter_T, but each "sample" is a
+  whole scan (nChPad_ floats), so a tap is one vector load + FMA for every channel
+- Symmetric (linear-phase) taps are folded: b[k]*(x[n-k] + x[n-N+1+k]) -> half the multiplies
+- Kernel is picked at runtime (AVX2+FMA > SSE > scalar on x86, NEON on ARM64)
+- Decimating mode: the delay line still takes every scan, but the dot product only runs for the
+  outputs we keep -> polyphase cost (nTaps/decim MACs per input scan) without splitting the taps
+*/
+
+enum FirSimdPath_E {
+    FirSimd_Scalar = 0,
+    FirSimd_SSE,
+    FirSimd_AVX2,
+    FirSimd_NEON
+};
+
+const char* FirSimdPath_to_string(FirSimdPath_E p);
+FirSimdPath_E fir_simd_detect_best_path();
+bool fir_simd_path_supported(FirSimdPath_E p);
+
+class MultiChFir_C {
+public:
+    MultiChFir_C() = default;
+
+    // taps copied in; picks the best kernel unless told otherwise (unsupported -> scalar)
+    void init(const float* taps, std::size_t nTaps, std::size_t nCh);
+    void init(const float* taps, std::size_t nTaps, std::size_t nCh, FirSimdPath_E path);
+    void reset(); // zero the delay line
+
+    // in place, data is [scan0 ch0..chN-1, scan1 ch0..] with stride nCh
+    void process_interleaved(float* data, std::size_t nScans);
+    // filter + keep every decim-th output scan, compacted to the front of data; returns how many.
+    // phase carries across calls, so chunk sizes don't have to be multiples of decim
+    std::size_t process_interleaved_decim(float* data, std::size_t nScans, std::size_t decim);
+
+    FirSimdPath_E get_path() const { return path_; };
+    bool is_symmetric() const { return symmetric_; };
+    std::size_t get_num_taps() const { return nTaps_; };
+
+    // kernel signature: one output scan from the delay line window starting at s
+    using Kernel_t = void (*)(const float* taps, std::size_t nTaps, bool symmetric,
+                              const float* s, std::size_t stride, float* out);
+
+private:
+    std::size_t nTaps_ = 0;
+    std::size_t nCh_ = 0;
+    std::size_t nChPad_ = 0;       // nCh_ rounded up to 8 lanes (pad lanes stay 0)
+    std::size_t pos_ = 0;          // row of the newest scan in state_
+    std::size_t decimPhase_ = 0;   // input scans since the last kept output (decimating mode)
+    bool symmetric_ = false;
+    FirSimdPath_E path_ = FirSimd_Scalar;
+    Kernel_t kernel_ = nullptr;
+    std::vector<float> taps_;
+    std::vector<float> state_;     // 2*nTaps_ rows of nChPad_ floats
+    std::vector<float> out_;       // one padded output scan
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/* PIPELINE LATENCY ACCOUNTING
+- every stage declares what it adds to the age of a sample by the time a decision is made:
+    device   -> IAcqProvider_S::latency_ms()          (transport/driver buffering before getData returns)
+    chunk    -> first scan of a chunk waits for the other NUM_SCANS_CHUNK-1 scans
+    filter   -> EegFilterBank_C::get_latency_ms()     (bandpass group delay at BP_DELAY_REF_HZ)
+    window   -> sliding_window_t::latency_ms()        (oldest sample in the window vs the newest)
+    classifier -> CLASSIFIER_LATENCY_MS              (algorithmic; its compute time is measured separately)
+  queueing between producer and consumer isn't declared, it shows up in the measured ages
+- producer stamps every chunk with epoch_ms = acquisition time of its first scan (latency_now_ms() clock)
+- consumer measures at each decision: age of the newest sample = now - its stamp + filter delay
+  (filtered output at t reflects input at t - delay), oldest = newest + window span
+- stamps, ages and the declared budget are all wall ms: fake/replay at pacing speed x run device time
+  x times faster, so every device-time span (scan period, chunk fill, filter delay, window span) goes
+  through device_to_wall_ms() before it meets the clock
+- LatencyHistogram_C: 1 ms bins, relaxed atomics -> consumer adds, HTTP reads p50/p99 without a lock
+*/
+
+// steady clock in ms (double), the clock bufferChunk_S::epoch_ms is on
+inline double latency_now_ms() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// device-time span -> wall ms at the acquisition pacing speed (1 for real hardware / realtime pacing)
+inline constexpr double device_to_wall_ms(double deviceMs, double speed) { return deviceMs / speed; }
+
+// wall stamp of scan k in a chunk whose first scan is stamped firstMs (scanWallMs = scan period in wall ms)
+inline constexpr double scan_stamp_ms(double firstMs, std::size_t k, double scanWallMs) { return firstMs + double(k) * scanWallMs; }
+
+struct SampleAges_S {
+    double newest_ms = 0.0;
+    double oldest_ms = 0.0;
+};
+
+// ages at a decision made at nowMs, all wall ms
+inline SampleAges_S sample_ages_ms(double nowMs, double newestStampMs, double filterWallMs, double windowWallMs) {
+    SampleAges_S a;
+    a.newest_ms = nowMs - newestStampMs + filterWallMs;
+    a.oldest_ms = a.newest_ms + windowWallMs;
+    return a;
+}
+
+class LatencyHistogram_C {
+public:
+    static constexpr std::size_t NUM_BINS = 8192; // 1 ms each, last bin catches everything >= 8.191 s
+
+    void add(double ms) {
+        const std::size_t bin = (ms <= 0.0) ? 0 : (ms >= double(NUM_BINS - 1)) ? NUM_BINS - 1 : static_cast<std::size_t>(ms);
+        bins_[bin].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& b : bins_) b.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t get_count() const { return count_.load(std::memory_order_relaxed); };
+
+    // upper edge of the bin holding the p-th fraction (0..1); 0 if empty. racy vs add() by at most a few samples
+    double percentile(double p) const {
+        uint64_t total = 0;
+        for (const auto& b : bins_) total += b.load(std::memory_order_relaxed);
+        if (total == 0) return 0.0;
+        const uint64_t target = static_cast<uint64_t>(p * double(total - 1)) + 1;
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < NUM_BINS; ++i) {
+            acc += bins_[i].load(std::memory_order_relaxed);
+            if (acc >= target) return double(i + 1);
+        }
+        return double(NUM_BINS);
+    }
+
+private:
+    std::array<std::atomic<uint32_t>, NUM_BINS> bins_{};
+    std::atomic<uint64_t> count_{0};
+};
@@ -0,0 +1,177 @@
+#include "LineNotch.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// the three below are per sample at 250 Hz, init() rescales them to fs so the behaviour in Hz / seconds stays put
+static constexpr float LMS_MU = 0.01f;             // notch width ~ mu*fs/(2*pi) = 0.4 Hz at 250 Hz
+static constexpr float RESIDUAL_ALPHA = 1.0f / 500.0f; // ~2 s coherent average
+static constexpr double FLL_GAIN = 0.5;            // fraction of the measured freq error corrected per update
+static constexpr std::size_t TRACK_CHUNKS = 8;     // rotation averaged over this many calls before an update
+static constexpr double TRACK_SNR = 10.0;          // |W|^2 must beat the LMS weight noise (~mu*var(e)) by this much
+static constexpr std::size_t SETTLE_SCANS = 1000;  // ~2/RESIDUAL_ALPHA: var(e) isn't trustworthy before this
+static constexpr double TUNED_FS_HZ = 250.0;
+static constexpr float LINE_POW_BETA = 1.0f / 16.0f; // per call, ~2 s of chunks for the reported line amplitude
+static constexpr double PI = 3.14159265358979323846;
+
+void AdaptiveLineNotch_C::init(double nominalHz, std::size_t nHarmonics, double fs, std::size_t nCh) {
+    assert(nominalHz > 0.0 && fs > 0.0 && nCh > 0);
+    nCh_ = nCh;
+    fs_ = fs;
+    nominalHz_ = nominalHz;
+    mu_ = static_cast<float>(LMS_MU * TUNED_FS_HZ / fs);
+    resAlpha_ = static_cast<float>(RESIDUAL_ALPHA * TUNED_FS_HZ / fs);
+    settleScans_ = static_cast<std::size_t>(double(SETTLE_SCANS) * fs / TUNED_FS_HZ);
+    // only harmonics that are actually below nyquist (with tracking headroom)
+    const std::size_t fit = static_cast<std::size_t>((0.5 * fs) / (nominalHz + LINE_TRACK_RANGE_HZ));
+    nH_ = std::min(nHarmonics, fit);
+
+    refC_.assign(nH_, 0.0f);
+    refS_.assign(nH_, 0.0f);
+    prevC_.assign(nCh_, 0.0f);
+    prevS_.assign(nCh_, 0.0f);
+    reset();
+}
+
+void AdaptiveLineNotch_C::reset() {
+    w0_ = 2.0 * PI * nominalHz_ / fs_;
+    rotC_ = std::cos(w0_);
+    rotS_ = std::sin(w0_);
+    phC_ = 1.0;
+    phS_ = 0.0;
+    wc_.assign(nH_ * nCh_, 0.0f);
+    ws_.assign(nH_ * nCh_, 0.0f);
+    rc_.assign(nH_ * nCh_, 0.0f);
+    rs_.assign(nH_ * nCh_, 0.0f);
+    std::fill(prevC_.begin(), prevC_.end(), 0.0f);
+    std::fill(prevS_.begin(), prevS_.end(), 0.0f);
+    errVar_.assign(nCh_, 0.0f);
+    linePow_.assign(nCh_, 0.0f);
+    scansSeen_ = 0;
+    trackRe_ = trackIm_ = 0.0;
+    trackScans_ = 0;
+    trackCalls_ = 0;
+}
+
+void AdaptiveLineNotch_C::process_interleaved(float* data, std::size_t nScans) {
+    if (nH_ == 0) return;
+    for (std::size_t sc = 0; sc < nScans; ++sc) {
+        // references for every harmonic from the one oscillator: e^{jk theta} = e^{j(k-1) theta} * e^{j theta}
+        refC_[0] = static_cast<float>(phC_);
+        refS_[0] = static_cast<float>(phS_);
+        for (std::size_t k = 1; k < nH_; ++k) {
+            refC_[k] = refC_[k - 1] * refC_[0] - refS_[k - 1] * refS_[0];
+            refS_[k] = refS_[k - 1] * refC_[0] + refC_[k - 1] * refS_[0];
+        }
+
+        // 1) e = x - all harmonic estimates (in place); inner loops over channels vectorize
+        float* e = data + sc * nCh_;
+        for (std::size_t k = 0; k < nH_; ++k) {
+            const float c = refC_[k], s = refS_[k];
+            const float* wc = &wc_[k * nCh_];
+            const float* ws = &ws_[k * nCh_];
+            for (std::size_t ch = 0; ch < nCh_; ++ch) {
+                e[ch] -= wc[ch] * c + ws[ch] * s;
+            }
+        }
+        // 2) LMS update + residual averages from the same error
+        for (std::size_t k = 0; k < nH_; ++k) {
+            const float c = refC_[k], s = refS_[k];
+            float* wc = &wc_[k * nCh_];
+            float* ws = &ws_[k * nCh_];
+            float* rc = &rc_[k * nCh_];
+            float* rs = &rs_[k * nCh_];
+            for (std::size_t ch = 0; ch < nCh_; ++ch) {
+                const float g = mu_ * e[ch];
+                wc[ch] += g * c;
+                ws[ch] += g * s;
+                rc[ch] += resAlpha_ * (e[ch] * c - rc[ch]);
+                rs[ch] += resAlpha_ * (e[ch] * s - rs[ch]);
+            }
+        }
+        for (std::size_t ch = 0; ch < nCh_; ++ch) {
+            errVar_[ch] += resAlpha_ * (e[ch] * e[ch] - errVar_[ch]);
+        }
+
+        // advance oscillator (double so the phase doesn't drift)
+        const double c = phC_ * rotC_ - phS_ * rotS_;
+        phS_ = phS_ * rotC_ + phC_ * rotS_;
+        phC_ = c;
+    }
+    // keep |phasor| = 1
+    const double mag = std::sqrt(phC_ * phC_ + phS_ * phS_);
+    phC_ /= mag;
+    phS_ /= mag;
+
+    // reported line power: |W|^2 doesn't care about the rotation, so it can be smoothed
+    for (std::size_t ch = 0; ch < nCh_; ++ch) {
+        float p = 0.0f;
+        for (std::size_t k = 0; k < nH_; ++k) {
+            const float c = wc_[k * nCh_ + ch], s = ws_[k * nCh_ + ch];
+            p += c * c + s * s;
+        }
+        linePow_[ch] += LINE_POW_BETA * (p - linePow_[ch]);
+    }
+
+    scansSeen_ += nScans;
+    track_frequency(nScans);
+}
+
+void AdaptiveLineNotch_C::track_frequency(std::size_t nScans) {
+    // line = A cos(theta + dw*n + phi) -> fitted W = wc + j ws = A e^{-j(dw*n + phi)}
+    // so sum_ch W_now * conj(W_prev) has angle -dw*nScans (channels weighted by their line power)
+    // only channels where the line clearly stands out of the weight noise count (LMS weight noise ~ mu*var(e))
+    for (std::size_t ch = 0; ch < nCh_; ++ch) {
+        const double c = wc_[ch], s = ws_[ch];
+        const double pc = prevC_[ch], ps = prevS_[ch];
+        if (c * c + s * s > TRACK_SNR * double(mu_) * double(errVar_[ch])) {
+            trackRe_ += c * pc + s * ps;
+            trackIm_ += s * pc - c * ps;
+        }
+        prevC_[ch] = wc_[ch];
+        prevS_[ch] = ws_[ch];
+    }
+    trackScans_ += nScans;
+    if (++trackCalls_ < TRACK_CHUNKS) return;
+    if (scansSeen_ < settleScans_) { // gate above isn't meaningful yet
+        trackRe_ = trackIm_ = 0.0;
+        trackScans_ = 0;
+        trackCalls_ = 0;
+        return;
+    }
+
+    // averaged over TRACK_CHUNKS calls: still unambiguous per call (|dw| * nScans < pi), but less jittery
+    const double accRe = trackRe_, accIm = trackIm_;
+    const double scansPerCall = double(trackScans_) / double(trackCalls_);
+    trackRe_ = trackIm_ = 0.0;
+    trackScans_ = 0;
+    trackCalls_ = 0;
+    if (accRe == 0.0 && accIm == 0.0) return; // no line anywhere
+
+    const double dw = -std::atan2(accIm, accRe) / scansPerCall;
+    const double lo = 2.0 * PI * (nominalHz_ - LINE_TRACK_RANGE_HZ) / fs_;
+    const double hi = 2.0 * PI * (nominalHz_ + LINE_TRACK_RANGE_HZ) / fs_;
+    w0_ = std::clamp(w0_ + FLL_GAIN * dw, lo, hi);
+    rotC_ = std::cos(w0_);
+    rotS_ = std::sin(w0_);
+}
+
+double AdaptiveLineNotch_C::get_freq_hz() const {
+    return w0_ * fs_ / (2.0 * PI);
+}
+
+float AdaptiveLineNotch_C::get_line_uv_rms(std::size_t ch) const {
+    // |W_k| is the amplitude of harmonic k -> rms = sqrt(sum A_k^2 / 2), minus the weight noise bias (mu*var(e) each)
+    const float p = linePow_[ch] - float(nH_) * mu_ * errVar_[ch];
+    return std::sqrt(0.5f * std::max(0.0f, p));
+}
+
+float AdaptiveLineNotch_C::get_residual_uv2(std::size_t ch) const {
+    // coherent average of e*ref = half the residual amplitude -> power A^2/2 = 2|r|^2
+    float p = 0.0f;
+    for (std::size_t k = 0; k < nH_; ++k) {
+        const float c = rc_[k * nCh_ + ch], s = rs_[k * nCh_ + ch];
+        p += 2.0f * (c * c + s * s);
+    }
+    return p;
+}
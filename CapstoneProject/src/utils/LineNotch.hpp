@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/* ADAPTIVE LINE NOISE NOTCH (50/60 Hz + harmonics, multi-channel)
+- adaptive noise canceller with an internal reference: for each harmonic k a unit sin/cos pair at k*f0
+  (one shared oscillator for all channels), per-channel LMS weights fit the line component and we subtract it
+    e = x - sum_k (wc_k cos + ws_k sin);   wc_k += mu*e*cos;   ws_k += mu*e*sin
+  -> a very narrow notch (~0.4 Hz) that follows amplitude/phase changes, ~5 multiplies per harmonic per
+     sample (+4 for the residual tracking)
+- frequency tracking: if f0 is off by df, the fitted weights rotate at 2*pi*df per sample.
+  Every chunk we measure that rotation (fundamental, channels where the line is above the weight noise),
+  average it over a few chunks and nudge f0 (FLL), within +-LINE_TRACK_RANGE_HZ of the nominal
+- only harmonics below fs/2 are used (at 250 Hz: 50,100 or 60,120). Higher ones alias right into the
+  EEG band (180 Hz -> 70 Hz, 240 Hz -> 10 Hz!) so we don't chase them
+- residual line power (what's left at the line freqs after the notch) is tracked per channel with a
+  leaky coherent average of e*ref over ~2 s, so the UI gets it for free without an FFT
+*/
+
+static constexpr double LINE_TRACK_RANGE_HZ = 2.0;
+
+class AdaptiveLineNotch_C {
+public:
+    AdaptiveLineNotch_C() = default;
+
+    // nHarmonics includes the fundamental; clamped to what fits under fs/2
+    void init(double nominalHz, std::size_t nHarmonics, double fs, std::size_t nCh);
+    void reset();
+
+    // in place, data is [scan0 ch0..chN-1, scan1 ch0..] with stride nCh
+    void process_interleaved(float* data, std::size_t nScans);
+
+    double get_freq_hz() const;                 // currently tracked fundamental
+    double get_nominal_hz() const { return nominalHz_; };
+    std::size_t get_num_harmonics() const { return nH_; };
+    float get_line_uv_rms(std::size_t ch) const;   // line amplitude being removed (rms over harmonics)
+    float get_residual_uv2(std::size_t ch) const;  // line power left in the output (sum over harmonics)
+
+private:
+    void track_frequency(std::size_t nScans);
+
+    std::size_t nCh_ = 0;
+    std::size_t nH_ = 0;
+    double fs_ = 0.0;
+    double nominalHz_ = 0.0;
+    float mu_ = 0.0f;            // LMS step, scaled to fs
+    float resAlpha_ = 0.0f;      // residual/err var smoothing, scaled to fs
+    std::size_t settleScans_ = 0;
+    double w0_ = 0.0;            // tracked fundamental, rad/sample
+    double rotC_ = 1.0, rotS_ = 0.0; // e^{j w0}
+    double phC_ = 1.0, phS_ = 0.0;   // oscillator phasor e^{j theta}
+
+    std::vector<float> refC_, refS_;  // nH_: cos/sin of k*theta for the current sample
+    std::vector<float> wc_, ws_;      // nH_ x nCh_ LMS weights
+    std::vector<float> rc_, rs_;      // nH_ x nCh_ residual coherent averages
+    std::vector<float> prevC_, prevS_; // nCh_: fundamental weights at the last call
+    std::vector<float> errVar_;       // nCh_: running var of the output (for the weight noise floor)
+    std::vector<float> linePow_;      // nCh_: smoothed sum_k |W_k|^2
+    std::size_t scansSeen_ = 0;
+    double trackRe_ = 0.0, trackIm_ = 0.0; // rotation accumulated since the last f0 update
+    std::size_t trackScans_ = 0;
+    std::size_t trackCalls_ = 0;
+};
@@ -0,0 +1,63 @@
+/*
+==============================================================================
+	File: MirroredRingBuffer.hpp
+	Desc: Fixed-size circular buffer that always exposes its contents as ONE
+	contiguous, read-only std::span (oldest first), with no snapshot copies.
+	This header is used by:
+  - Decoder (consumer): backing store of sliding_window_t. The SQA, the CSV
+  logger and feature extraction all read the live window straight from here.
+
+==============================================================================
+*/
+
+/*
+* MIRRORED CIRCULAR BUFFER
+methods:
+* push / push_n   -> append at tail (never blocks; returns what fit)
+* discard_n       -> drop oldest (sliding window hop)
+* view            -> contiguous span of everything, oldest first
+* view_trimmed    -> same, minus guard samples at each end
+* get_total_pushed -> items ever pushed (monotonic, survives clear) -> readers can tell how far it moved
+data:
+* arr_ -> 2 x capacity. Every sample is written at idx AND idx + capacity, so
+  [headIdx_, headIdx_ + count_) never wraps, whatever headIdx_ is.
+notes:
+- costs one extra write per sample (a second memcpy per chunk) to make every
+  read contiguous; reads dominate (SQA, logging, features each read the full window)
+- NOT thread safe: owned by one thread (the consumer builds and reads its windows)
+- spans are invalidated by the next push/discard
+*/
+#pragma once
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <vector>
+#include <span>
+
+template<typename T>
+class MirroredRingBuffer_C {
+public:
+    // Constructor
+    explicit MirroredRingBuffer_C(size_t capacity);
+
+    bool push(const T& data);
+    size_t push_n(const T* src, size_t n);
+    size_t discard_n(size_t n);
+    void clear() { headIdx_ = 0; count_ = 0; };
+
+    std::span<const T> view() const { return std::span<const T>(arr_.data() + headIdx_, count_); };
+    std::span<const T> view_trimmed(size_t trimFront, size_t trimBack) const;
+
+    size_t get_count() const { return count_; };
+    size_t get_capacity() const { return capacity_; };
+    uint64_t get_total_pushed() const { return pushed_; };
+    bool isFull() const { return count_ == capacity_; };
+private:
+    size_t const capacity_;
+    size_t headIdx_ = 0; // always < capacity_
+    size_t count_ = 0;
+    uint64_t pushed_ = 0;
+    // data array (2 x capacity: primary half + mirror half)
+    std::vector<T> arr_;
+};
+
+#include "MirroredRingBuffer.tpp"
@@ -0,0 +1,54 @@
+#include <cassert>
+#include <algorithm> // std::copy, std::min
+
+template<typename T>
+MirroredRingBuffer_C<T>::MirroredRingBuffer_C(size_t capacity)
+: capacity_(capacity) {
+    assert(capacity_ > 0);
+    arr_.resize(2 * capacity_);
+}
+
+template<typename T>
+bool MirroredRingBuffer_C<T>::push(const T& data) {
+    return push_n(&data, 1) == 1;
+}
+
+// append up to n items (whatever fits); returns number pushed
+template<typename T>
+size_t MirroredRingBuffer_C<T>::push_n(const T* src, size_t n) {
+    const size_t take = std::min(n, capacity_ - count_);
+    size_t tail = headIdx_ + count_;
+    if (tail >= capacity_) tail -= capacity_;
+
+    // run 1: tail -> end of primary half, run 2: wrapped part at the front
+    // each run lands twice: once in the primary half, once in the mirror half
+    const size_t run1 = std::min(take, capacity_ - tail);
+    std::copy(src, src + run1, arr_.begin() + tail);
+    std::copy(src, src + run1, arr_.begin() + tail + capacity_);
+    std::copy(src + run1, src + take, arr_.begin());
+    std::copy(src + run1, src + take, arr_.begin() + capacity_);
+
+    count_ += take;
+    pushed_ += take;
+    return take;
+}
+
+// drop up to n oldest items; returns number dropped
+template<typename T>
+size_t MirroredRingBuffer_C<T>::discard_n(size_t n) {
+    const size_t take = std::min(n, count_);
+    headIdx_ += take;
+    if (headIdx_ >= capacity_) headIdx_ -= capacity_;
+    count_ -= take;
+    return take;
+}
+
+// special view for labelling in calib mode (guard trimming)
+// empty span if there's nothing left after trimming
+template<typename T>
+std::span<const T> MirroredRingBuffer_C<T>::view_trimmed(size_t trimFront, size_t trimBack) const {
+    if (trimFront + trimBack >= count_) {
+        return {};
+    }
+    return std::span<const T>(arr_.data() + headIdx_ + trimFront, count_ - trimFront - trimBack);
+}
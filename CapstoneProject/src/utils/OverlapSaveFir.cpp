@@ -0,0 +1,98 @@
+#include "OverlapSaveFir.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using cf = std::complex<float>;
+
+void OverlapSaveFir_C::init(const float* taps, std::size_t nTaps, std::size_t nCh, std::size_t blockSize) {
+    assert(nTaps > 0 && nCh > 0);
+    assert(blockSize >= 2 && (blockSize & (blockSize - 1)) == 0);
+    nTaps_ = nTaps;
+    nCh_ = nCh;
+    B_ = blockSize;
+    K_ = (nTaps + B_ - 1) / B_;
+    bins_ = B_ + 1;
+    fft_.init(2 * B_);
+
+    // partition k = taps[kB .. kB+B) zero padded to 2B
+    H_.assign(K_ * bins_, cf(0.0f, 0.0f));
+    std::vector<float> part(2 * B_, 0.0f);
+    for (std::size_t k = 0; k < K_; ++k) {
+        std::fill(part.begin(), part.end(), 0.0f);
+        for (std::size_t i = 0; i < B_ && k * B_ + i < nTaps; ++i) {
+            part[i] = taps[k * B_ + i];
+        }
+        fft_.forward(part.data(), &H_[k * bins_]);
+    }
+
+    fdl_.assign(nCh_ * K_ * bins_, cf(0.0f, 0.0f));
+    inBuf_.assign(nCh_ * 2 * B_, 0.0f);
+    acc_.assign(bins_, cf(0.0f, 0.0f));
+    time_.assign(2 * B_, 0.0f);
+    fdlPos_ = 0;
+}
+
+void OverlapSaveFir_C::reset() {
+    std::fill(fdl_.begin(), fdl_.end(), cf(0.0f, 0.0f));
+    std::fill(inBuf_.begin(), inBuf_.end(), 0.0f);
+    fdlPos_ = 0;
+}
+
+void OverlapSaveFir_C::process_interleaved(float* data, std::size_t nScans) {
+    assert(nScans % B_ == 0);
+    for (std::size_t off = 0; off < nScans; off += B_) {
+        process_block(data + off * nCh_);
+    }
+}
+
+void OverlapSaveFir_C::process_block(float* data) {
+    fdlPos_ = (fdlPos_ == 0) ? K_ - 1 : fdlPos_ - 1; // newest spectrum goes here (walks backwards like the FIR delay lines)
+
+    for (std::size_t ch = 0; ch < nCh_; ++ch) {
+        // slide: [prev | cur] <- [cur | new]
+        float* in = &inBuf_[ch * 2 * B_];
+        std::copy(in + B_, in + 2 * B_, in);
+        for (std::size_t s = 0; s < B_; ++s) {
+            in[B_ + s] = data[s * nCh_ + ch];
+        }
+
+        cf* fdlCh = &fdl_[ch * K_ * bins_];
+        fft_.forward(in, &fdlCh[fdlPos_ * bins_]);
+
+        // Y = sum_k X_{n-k} * H_k  (X_{n-k} sits k slots after fdlPos_)
+        std::fill(acc_.begin(), acc_.end(), cf(0.0f, 0.0f));
+        for (std::size_t k = 0; k < K_; ++k) {
+            std::size_t slot = fdlPos_ + k;
+            if (slot >= K_) slot -= K_;
+            const cf* X = &fdlCh[slot * bins_];
+            const cf* H = &H_[k * bins_];
+            for (std::size_t b = 0; b < bins_; ++b) {
+                // acc += X*H (written out; std::complex * is slow without fast-math)
+                acc_[b] += cf(X[b].real() * H[b].real() - X[b].imag() * H[b].imag(),
+                              X[b].real() * H[b].imag() + X[b].imag() * H[b].real());
+            }
+        }
+
+        fft_.inverse(acc_.data(), time_.data());
+        // first B outputs are circular wrap-around junk; last B are the valid linear conv
+        for (std::size_t s = 0; s < B_; ++s) {
+            data[s * nCh_ + ch] = time_[B_ + s];
+        }
+    }
+}
+
+// ======================= COST MODEL (flops) =========================
+double direct_fir_cost_per_sample(std::size_t nTaps, bool symmetric, std::size_t lanes) {
+    // 1 mul + 1 add per tap; folded: 1 extra add per pair but half the muls
+    const double flops = symmetric ? 1.5 * double(nTaps) : 2.0 * double(nTaps);
+    return flops / double(std::max<std::size_t>(lanes, 1));
+}
+
+double overlap_save_cost_per_sample(std::size_t nTaps, std::size_t blockSize) {
+    const double L = 2.0 * double(blockSize);
+    const double K = std::ceil(double(nTaps) / double(blockSize));
+    const double fft = 2.5 * L * std::log2(L);           // real FFT of L points
+    const double macs = K * (double(blockSize) + 1) * 8.0; // complex MAC = 8 flops
+    return (2.0 * fft + macs) / double(blockSize);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Fft.hpp"
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+/* FFT OVERLAP-SAVE FIR (uniformly partitioned, multi-channel)
+- block size B = the chunk size we get called with (32 scans), so no extra latency
+- taps are cut into K = ceil(N/B) partitions of B, each pre-transformed with a 2B-point real FFT
+- per block, per channel: one forward FFT of [prev B | new B] samples, K complex
+  multiply-adds against a frequency-domain delay line of past input spectra, one inverse
+  FFT; the last B samples are the linear convolution output (overlap-save)
+- output matches the direct-form FIR up to float rounding (FftFirSelfTest checks it)
+- cost per output sample ~ (2 FFTs + K*(B+1) complex MACs) / B instead of N MACs,
+  so it wins for long filters / when the direct form has no SIMD to lean on
+*/
+class OverlapSaveFir_C {
+public:
+    OverlapSaveFir_C() = default;
+
+    // blockSize must be a power of 2; process_interleaved() takes multiples of it
+    void init(const float* taps, std::size_t nTaps, std::size_t nCh, std::size_t blockSize);
+    void reset();
+
+    // in place, time-major interleaved with stride nCh; nScans % blockSize == 0
+    void process_interleaved(float* data, std::size_t nScans);
+
+    std::size_t get_block_size() const { return B_; };
+    std::size_t get_num_partitions() const { return K_; };
+
+private:
+    void process_block(float* data); // one block of B_ scans, all channels
+
+    std::size_t nTaps_ = 0;
+    std::size_t nCh_ = 0;
+    std::size_t B_ = 0;      // block / partition size
+    std::size_t K_ = 0;      // number of partitions
+    std::size_t bins_ = 0;   // B_ + 1
+    std::size_t fdlPos_ = 0; // slot of the newest spectrum in the delay line
+
+    RealFft_C fft_;                              // 2B points
+    std::vector<std::complex<float>> H_;         // K_ x bins_ partition spectra
+    std::vector<std::complex<float>> fdl_;       // nCh_ x K_ x bins_ past input spectra
+    std::vector<float> inBuf_;                   // nCh_ x 2B: [previous block | current block]
+    std::vector<std::complex<float>> acc_;       // bins_
+    std::vector<float> time_;                    // 2B
+};
+
+// rough flop counts per output sample per channel, used to pick direct vs FFT
+// lanes = channels the direct kernel handles per instruction (8 AVX2, 4 SSE/NEON, 1 scalar)
+double direct_fir_cost_per_sample(std::size_t nTaps, bool symmetric, std::size_t lanes);
+double overlap_save_cost_per_sample(std::size_t nTaps, std::size_t blockSize);
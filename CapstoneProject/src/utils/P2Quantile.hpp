@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/* STREAMING QUANTILE (P-square, Jain & Chlamtac 1985)
+- one quantile p of everything pushed so far, without storing the samples: 5 markers (min, p/2, p,
+  (1+p)/2, max) whose heights get nudged with a parabolic fit as their positions drift
+- O(1) per push (a few compares + at most 3 marker updates), 5 heights + positions of memory
+- exact for the first 5 samples, converges to within ~1% of the spread after a few hundred
+- no forgetting: it's the quantile since the last reset()
+*/
+
+class P2Quantile_C {
+public:
+    P2Quantile_C() : P2Quantile_C(0.5) {} // median
+    explicit P2Quantile_C(double p) : p_(p) { reset(); }
+
+    void reset() {
+        count_ = 0;
+        const double p = p_;
+        dn_ = { 0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0 };
+        np_ = { 1.0, 1.0 + 2.0 * p, 1.0 + 4.0 * p, 3.0 + 2.0 * p, 5.0 };
+        n_ = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+    }
+
+    void push(double x) {
+        if (std::isnan(x)) return;
+        if (count_ < 5) {
+            q_[count_++] = x;
+            if (count_ == 5) std::sort(q_.begin(), q_.end());
+            return;
+        }
+        ++count_;
+
+        // which cell x falls in, stretching the ends if it's a new min/max
+        std::size_t k;
+        if (x < q_[0]) {
+            q_[0] = x;
+            k = 0;
+        } else if (x >= q_[4]) {
+            q_[4] = x;
+            k = 3;
+        } else {
+            k = 0;
+            while (k < 3 && x >= q_[k + 1]) ++k;
+        }
+        for (std::size_t i = k + 1; i < 5; ++i) n_[i] += 1.0;
+        for (std::size_t i = 0; i < 5; ++i) np_[i] += dn_[i];
+
+        // move the middle markers back towards where they should be, one position at a time
+        for (std::size_t i = 1; i < 4; ++i) {
+            const double d = np_[i] - n_[i];
+            if ((d >= 1.0 && n_[i + 1] - n_[i] > 1.0) || (d <= -1.0 && n_[i - 1] - n_[i] < -1.0)) {
+                const double s = (d > 0.0) ? 1.0 : -1.0;
+                const double qp = parabolic(i, s);
+                q_[i] = (q_[i - 1] < qp && qp < q_[i + 1]) ? qp : linear(i, s);
+                n_[i] += s;
+            }
+        }
+    }
+
+    double get() const {
+        if (count_ > 5) return q_[2];
+        if (count_ == 0) return 0.0;
+        // up to 5: exact, nearest rank (insertion sort, n <= 5; the markers only track p once they start moving)
+        std::array<double, 5> tmp = q_;
+        const std::size_t n = std::min<std::size_t>(count_, tmp.size());
+        for (std::size_t i = 1; i < n; ++i) {
+            const double v = tmp[i];
+            std::size_t j = i;
+            for (; j > 0 && tmp[j - 1] > v; --j) tmp[j] = tmp[j - 1];
+            tmp[j] = v;
+        }
+        const std::size_t r = std::min(n - 1, static_cast<std::size_t>(std::lround(p_ * double(n - 1))));
+        return tmp[r];
+    }
+    uint64_t get_count() const { return count_; }
+    double get_p() const { return p_; }
+
+private:
+    double parabolic(std::size_t i, double s) const {
+        return q_[i] + s / (n_[i + 1] - n_[i - 1])
+                           * ((n_[i] - n_[i - 1] + s) * (q_[i + 1] - q_[i]) / (n_[i + 1] - n_[i])
+                              + (n_[i + 1] - n_[i] - s) * (q_[i] - q_[i - 1]) / (n_[i] - n_[i - 1]));
+    }
+    double linear(std::size_t i, double s) const {
+        const std::size_t j = (s > 0.0) ? i + 1 : i - 1;
+        return q_[i] + s * (q_[j] - q_[i]) / (n_[j] - n_[i]);
+    }
+
+    double p_;
+    uint64_t count_ = 0;
+    std::array<double, 5> q_{};  // marker heights
+    std::array<double, 5> n_{};  // marker positions (1-based ranks)
+    std::array<double, 5> np_{}; // desired positions
+    std::array<double, 5> dn_{}; // desired position step per push
+};
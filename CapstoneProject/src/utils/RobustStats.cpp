@@ -0,0 +1,59 @@
+#include "RobustStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+RobustBaseline_C::RobustBaseline_C() {
+    p01_.fill(P2Quantile_C(0.01));
+    p99_.fill(P2Quantile_C(0.99));
+}
+
+void RobustBaseline_C::reset() {
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        median_[ch].reset();
+        absDev_[ch].reset();
+        p01_[ch].reset();
+        p99_[ch].reset();
+        stepMedian_[ch].reset();
+        stepAbsDev_[ch].reset();
+    }
+    fedUpTo_ = 0;
+    scans_ = 0;
+    started_ = false;
+}
+
+void RobustBaseline_C::push_scan(const float* row, bool hasPrev) {
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        const float v = row[ch];
+        median_[ch].push(v);
+        absDev_[ch].push(std::abs(double(v) - median_[ch].get()));
+        p01_[ch].push(v);
+        p99_[ch].push(v);
+        if (hasPrev) {
+            const float step = std::abs(v - prev_[ch]);
+            stepMedian_[ch].push(step);
+            stepAbsDev_[ch].push(std::abs(double(step) - stepMedian_[ch].get()));
+        }
+        prev_[ch] = v;
+    }
+    ++scans_;
+}
+
+void RobustBaseline_C::update(std::span<const float> window, uint64_t totalPushed) {
+    const std::size_t winScans = window.size() / NUM_CH_CHUNK;
+    if (winScans == 0) return;
+
+    // scans that weren't fed yet are the newest ones in the window; more than a window -> some never will be
+    const uint64_t newScans = (started_ && totalPushed >= fedUpTo_) ? (totalPushed - fedUpTo_) / NUM_CH_CHUNK : winScans;
+    const bool contiguous = started_ && totalPushed >= fedUpTo_ && newScans <= winScans;
+    const std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(newScans, winScans));
+
+    push_scans(window.data() + (winScans - n) * NUM_CH_CHUNK, n, contiguous);
+    fedUpTo_ = totalPushed;
+    started_ = true;
+}
+
+void RobustBaseline_C::push_scans(const float* rows, std::size_t nScans, bool continues) {
+    for (std::size_t s = 0; s < nScans; ++s) {
+        push_scan(rows + s * NUM_CH_CHUNK, s > 0 || continues);
+    }
+}
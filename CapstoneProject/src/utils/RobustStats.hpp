@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "../acq/WindowConfigs.hpp"
+#include "P2Quantile.hpp"
+
+/* PER-CHANNEL ROBUST BASELINE (SQA)
+- every sample that goes through the SQA window, once (new ones found with get_total_pushed()), feeds
+  P2 estimators per channel: median, p01/p99 of x, median of |x - median| (MAD), and median + MAD of the
+  point-to-point step |x[n] - x[n-1]|
+- MAD is of the deviation from the running median estimate -> slightly off while the median is still
+  settling, fine after a few seconds
+- O(1) per sample, fixed memory; baseline = everything since the analyzer started (no forgetting)
+- 1.4826 * MAD = sigma for gaussian data -> robust z = (x - median) / (1.4826 * MAD)
+*/
+
+inline constexpr float MAD_TO_SIGMA = 1.4826f;
+
+class RobustBaseline_C {
+public:
+    RobustBaseline_C();
+    void reset();
+
+    // window = the full sliding window (WINDOW_SCANS x NUM_CH_CHUNK interleaved), totalPushed = its get_total_pushed()
+    void update(std::span<const float> window, uint64_t totalPushed);
+    // or scans straight in (nScans x NUM_CH_CHUNK interleaved, offline), continues = they follow on from the
+    // last ones fed (steps across the boundary count). Don't mix with update() on the same baseline
+    void push_scans(const float* rows, std::size_t nScans, bool continues);
+
+    uint64_t get_num_scans() const { return scans_; } // scans fed so far (same for every channel)
+    float get_median(std::size_t ch) const { return float(median_[ch].get()); }
+    float get_mad(std::size_t ch) const { return float(absDev_[ch].get()); }
+    float get_p01(std::size_t ch) const { return float(p01_[ch].get()); }
+    float get_p99(std::size_t ch) const { return float(p99_[ch].get()); }
+    float get_step_median(std::size_t ch) const { return float(stepMedian_[ch].get()); }
+    float get_step_mad(std::size_t ch) const { return float(stepAbsDev_[ch].get()); }
+
+private:
+    void push_scan(const float* row, bool hasPrev);
+
+    std::array<P2Quantile_C, NUM_CH_CHUNK> median_{}, absDev_{}, p01_{}, p99_{}, stepMedian_{}, stepAbsDev_{};
+    std::array<float, NUM_CH_CHUNK> prev_{};
+    uint64_t fedUpTo_ = 0; // total pushed (samples) already fed
+    uint64_t scans_ = 0;
+    bool started_ = false;
+};
@@ -1,4 +1,5 @@
 #include "SignalQualityAnalyzer.h"
+#include "Filters.hpp" // LINE_FREQ_HZ / LINE_HARMONICS
 
 // ========================= INLINE STATS HELPERS =====================
 static inline float safe_sqrt(float x) { return std::sqrt(std::max(0.0f, x)); }
@@ -16,62 +17,62 @@ static float median_inplace(std::vector<float>& v) {
     return med;
 }
 
-// Histogram entropy (time-domain). 
-// TODO: replace with spectral entropy later (when we compute ftrs anyways)
-static float hist_entropy_channel(const std::vector<float>& snap, size_t ch,
-                                 int bins = 64, float minv = -200.0f, float maxv = 200.0f) {
-    if (!(maxv > minv) || bins <= 1) return 0.0f;
-    std::vector<int> h((size_t)bins, 0);
-    float inv = 1.0f / (maxv - minv);
-    for (size_t s = 0; s < WINDOW_SCANS; ++s) {
-        float v = snap[s * NUM_CH_CHUNK + ch];
-        float t = (v - minv) * inv;
-        int b = (int)(t * bins);
-        b = std::max(0, std::min(b, bins - 1));
-        h[(size_t)b]++;
-    }
-    float H = 0.0f;
-    float n = (float)WINDOW_SCANS;
-    for (int c : h) {
-        if (c == 0) continue;
-        float p = (float)c / n;
-        H += -p * std::log(p);
-    }
-    return H;
-}
-
-// Excess kurtosis using mean and m2/m4
-static float excess_kurtosis_channel(const std::vector<float>& snap, size_t ch, float mean) {
-    double m2 = 0.0, m4 = 0.0;
-    for (size_t s = 0; s < WINDOW_SCANS; ++s) {
-        double d = (double)snap[s * NUM_CH_CHUNK + ch] - (double)mean;
-        double d2 = d * d;
-        m2 += d2;
-        m4 += d2 * d2;
-    }
-    m2 /= (double)WINDOW_SCANS;
-    m4 /= (double)WINDOW_SCANS;
-    if (m2 < 1e-12) return 0.0f;
-    return (float)(m4 / (m2 * m2) - 3.0);
-}
-
 // ===================== CLASS FUNCTIONS ================================
 SignalQualityAnalyzer_C::SignalQualityAnalyzer_C(StateStore_s* stateStoreRef)
     : stateStoreRef_(stateStoreRef)
-    , hop_sec(static_cast<float>(WINDOW_HOP_SCANS) / 250.0f)
+    , hop_sec(static_cast<float>(WINDOW_HOP_SCANS) / static_cast<float>(PIPELINE_FS_HZ))
     , NEEDED_WIN_(static_cast<size_t>(std::ceil(baseline_window_sec_ / hop_sec)))
     , RollingWinStatsBuf(NEEDED_WIN_)
+    , moments_(MAX_ABS_UV, MAX_STEP_UV)
 {
-    win_snapshot_.reserve(WINDOW_SCANS * NUM_CH_CHUNK);
-    tempWinStats_.reserve(NEEDED_WIN_);
+    ampThresh_.fill(MAX_ABS_UV);
+    stepThresh_.fill(MAX_STEP_UV);
+    for (size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        maxAbsTrack_[ch].init(NEEDED_WIN_);
+        maxStepTrack_[ch].init(NEEDED_WIN_);
+        stdTrack_[ch].init(NEEDED_WIN_);
+        rmsTrack_[ch].init(NEEDED_WIN_);
+        kurtTrack_[ch].init(NEEDED_WIN_);
+        entTrack_[ch].init(NEEDED_WIN_);
+    }
 }
 
 
+// robust z-score thresholds vs this subject's own baseline (rule in sqa_artifact_thresholds)
+void SignalQualityAnalyzer_C::update_thresholds(){
+    adaptiveThresh_ = sqa_artifact_thresholds(robust_, ampThresh_, stepThresh_);
+}
+
+// all from the shared spectrum, no transform of our own
+void SignalQualityAnalyzer_C::spectral_metrics(const SpectralCache_C& spectrum, Stats_s& winStats) const {
+    const double nyq = 0.5 * double(PIPELINE_FS_HZ);
+    const std::size_t k0 = static_cast<std::size_t>(std::ceil(SQA_SPEC_LO_HZ / SPEC_BIN_HZ));
+    const double logK = std::log(double(SPEC_NUM_BINS - k0));
+    for (size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        const std::span<const float> p = spectrum.psd(ch);
+        double total = 0.0, plogp = 0.0;
+        for (std::size_t k = k0; k < p.size(); ++k) total += p[k];
+        if (total > 0.0) {
+            for (std::size_t k = k0; k < p.size(); ++k) {
+                if (p[k] <= 0.0f) continue;
+                const double q = double(p[k]) / total;
+                plogp += q * std::log(q);
+            }
+        }
+        const double totalUv2 = total * SPEC_BIN_HZ;
+        winStats.spec_entropy[ch] = (total > 0.0) ? float(-plogp / logK) : 0.0f;
+        winStats.line_ratio[ch] = (totalUv2 > 0.0)
+            ? float(spectrum.harmonic_power(ch, LINE_FREQ_HZ, LINE_HARMONICS, SQA_LINE_HALF_WIDTH_HZ) / totalUv2) : 0.0f;
+        winStats.alpha_uv2[ch] = spectrum.band_power(ch, SQA_ALPHA_LO_HZ, SQA_ALPHA_HI_HZ);
+        winStats.emg_uv2[ch] = spectrum.band_power(ch, SQA_EMG_LO_HZ, nyq);
+    }
+}
+
 void SignalQualityAnalyzer_C::update_statestore(){
     const size_t numWins = RollingWinStatsBuf.get_count();
     if(numWins==0) {return;}
 
-    Stats_s rolling_avg{};
+    Stats_s rolling_avg{}, rolling_min{}, rolling_med{}, rolling_max{};
     float numWins_inv = 1.0f / (float)numWins;
 
     // this is how we avg across all window history
@@ -79,26 +80,62 @@ void SignalQualityAnalyzer_C::update_statestore(){
         rolling_avg.mean_uv[ch]  = RollingSums_.mean_uv[ch] * numWins_inv;
         rolling_avg.std_uv[ch]   = RollingSums_.std_uv[ch]  * numWins_inv;
         rolling_avg.rms_uv[ch]   = RollingSums_.rms_uv[ch]  * numWins_inv;
+        rolling_avg.mad_uv[ch]   = RollingSums_.mad_uv[ch]  * numWins_inv;
+        rolling_avg.spec_entropy[ch] = RollingSums_.spec_entropy[ch] * numWins_inv;
+        rolling_avg.line_ratio[ch]   = RollingSums_.line_ratio[ch]   * numWins_inv;
+        rolling_avg.alpha_uv2[ch]    = RollingSums_.alpha_uv2[ch]    * numWins_inv;
+        rolling_avg.emg_uv2[ch]      = RollingSums_.emg_uv2[ch]      * numWins_inv;
         rolling_avg.kurt[ch]     = RollingSums_.kurt[ch]    * numWins_inv;
         rolling_avg.entropy[ch]  = RollingSums_.entropy[ch] * numWins_inv;
 
         // these are rolling maxima we maintained
         rolling_avg.max_abs_uv[ch]  = RollingSums_.max_abs_uv[ch];
         rolling_avg.max_step_uv[ch] = RollingSums_.max_step_uv[ch];
+
+        auto spread = [&](auto member, const SlidingQuantile_C& q) {
+            (rolling_min.*member)[ch] = q.min();
+            (rolling_med.*member)[ch] = q.median();
+            (rolling_max.*member)[ch] = q.max();
+        };
+        spread(&Stats_s::std_uv, stdTrack_[ch]);
+        spread(&Stats_s::rms_uv, rmsTrack_[ch]);
+        spread(&Stats_s::kurt, kurtTrack_[ch]);
+        spread(&Stats_s::entropy, entTrack_[ch]);
+        rolling_max.max_abs_uv[ch]  = RollingSums_.max_abs_uv[ch];
+        rolling_max.max_step_uv[ch] = RollingSums_.max_step_uv[ch];
     }
     
     std::lock_guard<std::mutex> lock(stateStoreRef_->signal_stats_mtx);
     stateStoreRef_->SignalStats.num_win_in_rolling = numWins;
     stateStoreRef_->SignalStats.rollingStats = rolling_avg;
+    stateStoreRef_->SignalStats.rollingMin = rolling_min;
+    stateStoreRef_->SignalStats.rollingMedian = rolling_med;
+    stateStoreRef_->SignalStats.rollingMax = rolling_max;
+    RobustStats_s& rb = stateStoreRef_->SignalStats.robust;
+    for (size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        rb.median_uv[ch] = robust_.get_median(ch);
+        rb.mad_uv[ch]    = robust_.get_mad(ch);
+        rb.p01_uv[ch]    = robust_.get_p01(ch);
+        rb.p99_uv[ch]    = robust_.get_p99(ch);
+    }
+    rb.amp_thresh_uv  = ampThresh_;
+    rb.step_thresh_uv = stepThresh_;
+    rb.adaptive       = adaptiveThresh_;
     const float denom = (global_win_acq_ > 0) ? static_cast<float>(global_win_acq_) : 1.0f;
     stateStoreRef_->SignalStats.overall_bad_win_rate = (global_win_acq_ > 0) ? (float)overall_bad_win_num_ / (float)global_win_acq_ : 0.0f;
     stateStoreRef_->SignalStats.current_bad_win_rate = (numWins > 0) ? (float)current_bad_win_num_ / (float)numWins : 0.0f;
     return;
 }
 
-void SignalQualityAnalyzer_C::check_artifact_and_flag_window(sliding_window_t& window){
+void SignalQualityAnalyzer_C::check_artifact_and_flag_window(sliding_window_t& window, SpectralCache_C& spectrum){
     Stats_s winStats {};
-    bool didEvictThisRound = false;
+
+    // read the live window in place (contiguous view, no snapshot copy)
+    const std::span<const float> win_view = window.sliding_window.view();
+    if (win_view.size() < WINDOW_SCANS * NUM_CH_CHUNK) {
+        return; // not enough samples yet
+        // shouldn't reach here if it's placed properly in main (checked before evicting so the rolling trackers stay in step)
+    }
     
     // rolling update (1): evict oldest if full, subtract contributions
     if(RollingWinStatsBuf.get_count() == NEEDED_WIN_){ // RB is full
@@ -114,83 +151,44 @@ void SignalQualityAnalyzer_C::check_artifact_and_flag_window(sliding_window_t& w
             RollingSums_.mean_uv[ch]    -= evicted_.mean_uv[ch];
             RollingSums_.std_uv[ch]     -= evicted_.std_uv[ch];
             RollingSums_.rms_uv[ch]     -= evicted_.rms_uv[ch];
+            RollingSums_.mad_uv[ch]     -= evicted_.mad_uv[ch];
+            RollingSums_.spec_entropy[ch] -= evicted_.spec_entropy[ch];
+            RollingSums_.line_ratio[ch]   -= evicted_.line_ratio[ch];
+            RollingSums_.alpha_uv2[ch]    -= evicted_.alpha_uv2[ch];
+            RollingSums_.emg_uv2[ch]      -= evicted_.emg_uv2[ch];
             RollingSums_.kurt[ch]       -= evicted_.kurt[ch];
             RollingSums_.entropy[ch]    -= evicted_.entropy[ch];
             kurt_sumsq_[ch]             -= (double)evicted_.kurt[ch]    * (double)evicted_.kurt[ch];
             ent_sumsq_[ch]              -= (double)evicted_.entropy[ch] * (double)evicted_.entropy[ch];
             // max_abs/max_step handled separately (see below)
         }
-        didEvictThisRound = true;
     }
 
     // HARD THRESHOLDS -> Any one can set bad window flag...
-    isGreaterThanMaxUvCount_.fill(0);
-    surpassesMaxStepCount_.fill(0);
-
     bool failsMaxTest = 0;
     bool failsStepTest = 0;
     int failsKurtTestCount = 0;
     int failsEntTestCount = 0;
 
-    window.sliding_window.get_data_snapshot(win_snapshot_);
-    if (win_snapshot_.size() < WINDOW_SCANS * NUM_CH_CHUNK) {
-        return; // not enough samples yet
-        // shouldn't reach here if it's placed properly in main
-    }
-
     global_win_acq_++;
 
-    for(size_t ch = 0; ch < NUM_CH_CHUNK; ch++){
-        double sum = 0.0, sumsq = 0.0;
-        float max_abs = 0.0f;
-        float max_step = 0.0f;
-
-        // init prev for each channel (gets updated)
-        float prev = win_snapshot_[0 * NUM_CH_CHUNK + ch];
-
-        for(size_t s = 0; s < WINDOW_SCANS; ++s){
-            // to acquire all for one channel, its the base plus the offset
-            float sample = win_snapshot_[s*NUM_CH_CHUNK + ch];
-
-            // Sums for stats calcs
-            sum += sample;
-            sumsq += (double)sample * (double)sample;
+    // robust baseline first (new samples only, O(1) each) -> thresholds this window's new hop gets counted with
+    const uint64_t totalPushed = window.sliding_window.get_total_pushed();
+    robust_.update(win_view, totalPushed);
+    update_thresholds();
+    moments_.set_thresholds(ampThresh_, stepThresh_);
 
-            // Max abs
-            float av = std::abs(sample);
-            max_abs = std::max(max_abs, av);
-            if(av > MAX_ABS_UV){ // max abs amplitude = 200uv
-                isGreaterThanMaxUvCount_[ch]++;
-            }
-            
-            // Point-to-Point Step
-            if(s>0){ // not the first scan, so we have a prev
-                float step = std::abs(sample - prev);
-                max_step = std::max(max_step, step);
-                if(step > MAX_STEP_UV){
-                    surpassesMaxStepCount_[ch]++;
-                }
-            }
-            // prev for next time
-            prev = sample;
-        }
+    // mean/std/rms/max/step/kurt/entropy + threshold counts, incrementally from the hops that are new (WindowMoments.hpp)
+    moments_.update(win_view, totalPushed, winStats);
+    for (size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) winStats.mad_uv[ch] = robust_.get_mad(ch); // channel's MAD so far
 
-        // one channel complete
-        float chMean = (float)(sum / double(WINDOW_SCANS));
-        float ex2 = (float)(sumsq / (double)WINDOW_SCANS);
-        float var = ex2 - chMean*chMean;
-        float chStdv = safe_sqrt(var);
-        float chRms  = safe_sqrt(ex2);
-
-        winStats.mean_uv[ch]    = chMean;
-        winStats.std_uv[ch]     = chStdv;
-        winStats.rms_uv[ch]     = chRms;
-        winStats.max_abs_uv[ch] = max_abs;
-        winStats.max_step_uv[ch]= max_step;
-        winStats.kurt[ch]    = excess_kurtosis_channel(win_snapshot_, ch, chMean);
-        winStats.entropy[ch] = hist_entropy_channel(win_snapshot_, ch);
-        // don't do MAD for now cuz it's lowkey very computationally expensive, let's see how much processing time we're up to
+    // spectral metrics: lookups into the window's shared FFT (no-op compute if someone already did this window)
+    spectrum.compute(win_view, totalPushed);
+    spectral_metrics(spectrum, winStats);
+    isGreaterThanMaxUvCount_ = moments_.get_amp_counts();
+    surpassesMaxStepCount_ = moments_.get_step_counts();
 
+    for(size_t ch = 0; ch < NUM_CH_CHUNK; ch++){
         if (isGreaterThanMaxUvCount_[ch] >= AMP_PERSIST_SAMPLES)  failsMaxTest = true;
         if (surpassesMaxStepCount_[ch] >= STEP_PERSIST_SAMPLES) failsStepTest = true;
 
@@ -249,40 +247,28 @@ void SignalQualityAnalyzer_C::check_artifact_and_flag_window(sliding_window_t& w
         RollingSums_.mean_uv[ch]    += winStats.mean_uv[ch];
         RollingSums_.std_uv[ch]     += winStats.std_uv[ch];
         RollingSums_.rms_uv[ch]     += winStats.rms_uv[ch];
+        RollingSums_.mad_uv[ch]     += winStats.mad_uv[ch];
+        RollingSums_.spec_entropy[ch] += winStats.spec_entropy[ch];
+        RollingSums_.line_ratio[ch]   += winStats.line_ratio[ch];
+        RollingSums_.alpha_uv2[ch]    += winStats.alpha_uv2[ch];
+        RollingSums_.emg_uv2[ch]      += winStats.emg_uv2[ch];
         RollingSums_.kurt[ch]       += winStats.kurt[ch];
         RollingSums_.entropy[ch]    += winStats.entropy[ch];
         kurt_sumsq_[ch]             += (double)winStats.kurt[ch]    * (double)winStats.kurt[ch];
         ent_sumsq_[ch]              += (double)winStats.entropy[ch] * (double)winStats.entropy[ch];
     }
 
-    // rolling max: cheap approach (HELPER)
-    // maintain rolling max; if we evicted the current max, recompute by scanning hist_ (rare)
-    // (Initialize on ramp-up too)
-    auto recompute_max_if_needed = [&](size_t ch) {
-        float mabs = 0.0f, mstep = 0.0f;
-        RollingWinStatsBuf.get_data_snapshot(tempWinStats_);
-        // iterate through windows n keep max
-        for (const auto& w : tempWinStats_) {
-        mabs  = std::max(mabs,  w.max_abs_uv[ch]);
-        mstep = std::max(mstep, w.max_step_uv[ch]);
-    }
-        RollingSums_.max_abs_uv[ch] = mabs;   // treat these fields as “rolling max”, not sums
-        RollingSums_.max_step_uv[ch] = mstep;
-    };
-
-    // NORMAL UPDATE
+    // rolling max/min/quantiles: trackers are NEEDED_WIN_ long, same windows as RollingWinStatsBuf
+    // (evicted above, this one in) -> the evicted window drops out of them by itself
     for (size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
-        
-        // incorporate new window by max() --> currently could be evicted max
-        RollingSums_.max_abs_uv[ch]  = std::max(RollingSums_.max_abs_uv[ch],  winStats.max_abs_uv[ch]);
-        RollingSums_.max_step_uv[ch] = std::max(RollingSums_.max_step_uv[ch], winStats.max_step_uv[ch]);
-
-        // handle last evicted if there -> recompute max if necessary
-        if(didEvictThisRound){
-            bool evicted_was_max_abs = (evicted_.max_abs_uv[ch] == RollingSums_.max_abs_uv[ch]);
-            bool evicted_was_max_step = (evicted_.max_step_uv[ch] == RollingSums_.max_step_uv[ch]);
-            if (evicted_was_max_abs || evicted_was_max_step) recompute_max_if_needed(ch);
-        }
+        maxAbsTrack_[ch].push(winStats.max_abs_uv[ch]);
+        maxStepTrack_[ch].push(winStats.max_step_uv[ch]);
+        RollingSums_.max_abs_uv[ch]  = maxAbsTrack_[ch].get(); // treat these fields as “rolling max”, not sums
+        RollingSums_.max_step_uv[ch] = maxStepTrack_[ch].get();
+        stdTrack_[ch].push(winStats.std_uv[ch]);
+        rmsTrack_[ch].push(winStats.rms_uv[ch]);
+        kurtTrack_[ch].push(winStats.kurt[ch]);
+        entTrack_[ch].push(winStats.entropy[ch]);
     }
 
     // see if we need to update stats now (enough windows)
@@ -5,7 +5,12 @@
 #include <cmath>
 #include "../acq/WindowConfigs.hpp"
 #include "../shared/StateStore.hpp"
+#include "WindowMoments.hpp"
+#include "SlidingExtrema.hpp"
+#include "RobustStats.hpp"
+#include "SpectralCache.hpp"
 #include <numeric>
+#include <span>
 
 // THIS WILL SERVE FOR 
 // (1) ARTIFACT REMOVAL (BAD SEGMENT REMOVER)
@@ -14,13 +19,16 @@
 // (3) to save to/pull from state store saved sessions to ensure mean value is sufficiently similar to calib session; otherwise add offset
 
     // (a) Max absolute amplitude = 200uV for >= 2 samples on any channel
+    //     (once there's a baseline: robust z-score vs the subject's own median/MAD, 200uV stays the cap)
     
-    // (b) Max point-to-point step = 100uV on any channel
+    // (b) Max point-to-point step = 100uV on any channel (same, vs median/MAD of the steps)
 
     // (c) Excess kurtosis (eye blinks)
 
     // (d) Entropy (eye blinks)
 
+    // (e) Spectral: entropy, mains ratio, alpha + EMG band power from the window's shared FFT (published only for now)
+
 // TODO: add a check for poor electrode contact (e.g. no signal, not enough variation idk)
 
 
@@ -30,6 +38,34 @@ static constexpr float MAX_STEP_UV = 100.0f;    // point-to-point threshold
 static constexpr int   AMP_PERSIST_SAMPLES = 2; // require >=2 samples over MAX_ABS_UV
 static constexpr int   STEP_PERSIST_SAMPLES = 2; // require >=1 big step
 static constexpr int   UI_UPDATE_EVERY_WIN = 10; // for ~3s updates
+// Adaptive amp/step thresholds = median + Z * 1.4826*MAD of the channel's own samples/steps (RobustStats.hpp),
+// clamped to [floor, fixed threshold above]. Fixed ones until ROBUST_WARMUP_SEC of samples went through
+static constexpr float AMP_ROBUST_Z = 8.0f;
+static constexpr float STEP_ROBUST_Z = 8.0f;
+static constexpr float AMP_THRESH_FLOOR_UV = 40.0f;  // very clean / flat channel -> MAD ~0, don't flag every wiggle
+static constexpr float STEP_THRESH_FLOOR_UV = 20.0f;
+static constexpr float ROBUST_WARMUP_SEC = 10.0f;
+
+// the amp/step threshold rule, shared by the online SQA and the offline calib export (CalibExport.cpp):
+// fixed MAX_ABS_UV / MAX_STEP_UV until the baseline has ROBUST_WARMUP_SEC of scans, then per channel
+// |x| > |median| + Z*sigma (sigma = 1.4826*MAD). Counts are on |x| (bandpassed -> median ~0), so that's the
+// z-score test on the side the median is on. Returns whether the adaptive ones are in use
+inline bool sqa_artifact_thresholds(const RobustBaseline_C& rb, std::array<float, NUM_CH_CHUNK>& ampThresh,
+                                    std::array<float, NUM_CH_CHUNK>& stepThresh) {
+    static constexpr uint64_t WARMUP_SCANS = static_cast<uint64_t>(ROBUST_WARMUP_SEC * PIPELINE_FS_HZ);
+    if (rb.get_num_scans() < WARMUP_SCANS) {
+        ampThresh.fill(MAX_ABS_UV);
+        stepThresh.fill(MAX_STEP_UV);
+        return false;
+    }
+    for (size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        const float amp  = std::abs(rb.get_median(ch)) + AMP_ROBUST_Z * MAD_TO_SIGMA * rb.get_mad(ch);
+        const float step = rb.get_step_median(ch) + STEP_ROBUST_Z * MAD_TO_SIGMA * rb.get_step_mad(ch);
+        ampThresh[ch]  = std::clamp(amp,  AMP_THRESH_FLOOR_UV,  MAX_ABS_UV);
+        stepThresh[ch] = std::clamp(step, STEP_THRESH_FLOOR_UV, MAX_STEP_UV);
+    }
+    return true;
+}
 // Enable kurt/entropy only after we have a baseline
 static constexpr size_t MIN_BASELINE_WINS = 20;     // ~6.4s with hop (0.32s)
 // Z-score thresholds relative to rolling baseline
@@ -38,6 +74,12 @@ static constexpr float ENT_Z  = 3.5f;               // “how many std below mea
 static constexpr float EPS_STD = 1e-6f;             // avoid divide-by-zero
 static constexpr int MIN_CH_FAIL_KURT = 2;
 static constexpr int MIN_CH_FAIL_ENT  = 2;
+// spectral metrics (SpectralCache_C)
+static constexpr double SQA_SPEC_LO_HZ = 1.0;   // entropy / total power from here to nyquist (skip DC + drift)
+static constexpr double SQA_ALPHA_LO_HZ = 8.0;
+static constexpr double SQA_ALPHA_HI_HZ = 13.0;
+static constexpr double SQA_EMG_LO_HZ = 30.0;   // to nyquist; the bandpass takes most of it, what's left is still a muscle tell
+static constexpr double SQA_LINE_HALF_WIDTH_HZ = 1.0;
 
 
 
@@ -45,14 +87,16 @@ static constexpr int MIN_CH_FAIL_ENT  = 2;
 class SignalQualityAnalyzer_C {
 public:
     explicit SignalQualityAnalyzer_C(StateStore_s* stateStoreRef);
-    void check_artifact_and_flag_window(sliding_window_t& window);
+    // spectrum = the consumer's shared window FFT; computed here if nobody did yet for this window
+    void check_artifact_and_flag_window(sliding_window_t& window, SpectralCache_C& spectrum);
     void update_statestore();
 private:
     void update_stats_with_new_win();
+    void update_thresholds(); // from robust_ into ampThresh_/stepThresh_ (sqa_artifact_thresholds)
+    void spectral_metrics(const SpectralCache_C& spectrum, Stats_s& winStats) const;
 
     StateStore_s* stateStoreRef_{nullptr};
 
-    std::vector<float> win_snapshot_;     // reused buffer (snapshot of RB contents)
     size_t global_win_acq_ = 0; // total windows passed through analyzer
 
     // averages we keep track of with each new window for eventual statestore publishing
@@ -62,7 +106,6 @@ private:
     std::array<double, NUM_CH_CHUNK> ent_sumsq_{};    // Σ ent^2 over rolling buffer
 
     Stats_s evicted_ {}; // keep last evicted from ring buffer for ref
-    std::vector<Stats_s> tempWinStats_; // reused for recompute max
 
     std::array<int, NUM_CH_CHUNK> isGreaterThanMaxUvCount_{};
     std::array<int, NUM_CH_CHUNK> surpassesMaxStepCount_{};
@@ -72,6 +115,13 @@ private:
     float hop_sec;
     size_t NEEDED_WIN_; // = 45 / hop 
     RingBuffer_C<Stats_s> RollingWinStatsBuf;
+    WindowMoments_C moments_; // per-window stats, hop by hop
+    RobustBaseline_C robust_; // per-channel median/MAD/percentiles of every sample, streaming
+    std::array<float, NUM_CH_CHUNK> ampThresh_{}, stepThresh_{};
+    bool adaptiveThresh_ = false;
+    // rolling max/min/quantiles over the same NEEDED_WIN_ windows, per channel (no history rescans)
+    std::array<SlidingMax_C, NUM_CH_CHUNK> maxAbsTrack_{}, maxStepTrack_{};
+    std::array<SlidingQuantile_C, NUM_CH_CHUNK> stdTrack_{}, rmsTrack_{}, kurtTrack_{}, entTrack_{};
 
     // helpers for temp storage
     size_t ui_tick_ = 0;
@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* ROLLING BASELINE TRACKERS (last N values, N fixed at init)
+- SlidingMax_C / SlidingMin_C: monotonic deque. Values that can never be the extremum again (an older
+  one <= a newer one, for max) are dropped on push, so the front is always the answer. Amortized O(1)
+  per push, O(1) get, no rescan when the extremum leaves the window
+- SlidingQuantile_C: window kept sorted (binary search + shift of <= N floats per push, N ~ 141 for the
+  SQA's 45 s) + FIFO of raw values to know which one leaves. Any quantile / min / max in O(1)
+- all storage allocated in init(), nothing after
+*/
+
+template <bool IsMax>
+class SlidingExtremum_C {
+public:
+    SlidingExtremum_C() = default;
+    explicit SlidingExtremum_C(std::size_t window) { init(window); }
+
+    void init(std::size_t window) {
+        assert(window > 0);
+        window_ = window;
+        ring_.assign(window, Entry_S{});
+        reset();
+    }
+    void reset() { head_ = 0; size_ = 0; seq_ = 0; }
+
+    void push(float v) {
+        // front falls out of the last window_ pushes with this one? (first, so the ring never overflows)
+        if (size_ > 0 && ring_[head_].seq + window_ <= seq_) {
+            head_ = (head_ + 1) % window_;
+            --size_;
+        }
+        // drop from the back everything v beats (ties too: the newer one outlives it)
+        while (size_ > 0 && !beats(back().v, v)) --size_;
+        ring_[(head_ + size_) % window_] = Entry_S{v, seq_};
+        ++size_;
+        ++seq_;
+    }
+
+    float get() const { return size_ > 0 ? ring_[head_].v : 0.0f; } // 0 when empty, like the old RollingSums_ init
+    std::size_t get_count() const { return std::min<uint64_t>(seq_, window_); }
+
+private:
+    struct Entry_S {
+        float v = 0.0f;
+        uint64_t seq = 0;
+    };
+    // a strictly beats b -> b stays in front of it
+    static bool beats(float a, float b) { return IsMax ? (a > b) : (a < b); }
+    const Entry_S& back() const { return ring_[(head_ + size_ - 1) % window_]; }
+
+    std::size_t window_ = 1;
+    std::vector<Entry_S> ring_; // deque of (value, push index), at most window_ long
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    uint64_t seq_ = 0;
+};
+
+using SlidingMax_C = SlidingExtremum_C<true>;
+using SlidingMin_C = SlidingExtremum_C<false>;
+
+class SlidingQuantile_C {
+public:
+    SlidingQuantile_C() = default;
+    explicit SlidingQuantile_C(std::size_t window) { init(window); }
+
+    void init(std::size_t window) {
+        assert(window > 0);
+        window_ = window;
+        fifo_.assign(window, 0.0f);
+        sorted_.clear();
+        sorted_.reserve(window);
+        head_ = 0;
+    }
+
+    void push(float v) {
+        if (std::isnan(v)) v = 0.0f; // NaN would break the ordering
+        if (sorted_.size() == window_) {
+            const float old = fifo_[head_];
+            sorted_.erase(std::lower_bound(sorted_.begin(), sorted_.end(), old));
+        }
+        fifo_[head_] = v;
+        head_ = (head_ + 1) % window_;
+        sorted_.insert(std::upper_bound(sorted_.begin(), sorted_.end(), v), v);
+    }
+
+    // q in [0,1], linear between order statistics (numpy's default)
+    float quantile(float q) const {
+        if (sorted_.empty()) return 0.0f;
+        const float pos = std::clamp(q, 0.0f, 1.0f) * float(sorted_.size() - 1);
+        const std::size_t i = static_cast<std::size_t>(pos);
+        if (i + 1 >= sorted_.size()) return sorted_.back();
+        const float f = pos - float(i);
+        return sorted_[i] + f * (sorted_[i + 1] - sorted_[i]);
+    }
+    float median() const { return quantile(0.5f); }
+    float min() const { return sorted_.empty() ? 0.0f : sorted_.front(); }
+    float max() const { return sorted_.empty() ? 0.0f : sorted_.back(); }
+    std::size_t get_count() const { return sorted_.size(); }
+
+private:
+    std::size_t window_ = 1;
+    std::vector<float> fifo_;   // raw values, fifo_[head_] = oldest once full
+    std::vector<float> sorted_; // same values, ascending
+    std::size_t head_ = 0;
+};
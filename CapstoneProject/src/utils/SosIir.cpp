@@ -0,0 +1,209 @@
+#include "SosIir.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define SOS_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define SOS_TARGET_AVX2 // MSVC lets us use the intrinsics without /arch
+    #else
+        #define SOS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define SOS_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+static constexpr std::size_t LANE_PAD = 8;
+static constexpr std::size_t COEFFS_PER_SEC = 5; // b0 b1 b2 a1 a2
+
+// ============================ KERNELS ===============================
+// x = one padded scan (stride floats), filtered in place through every section.
+// z row 2s = z1 of section s, row 2s+1 = z2
+
+static void kernel_scalar(const float* c, std::size_t nSec, float* z, std::size_t stride, float* x) {
+    for (std::size_t ch = 0; ch < stride; ++ch) {
+        float v = x[ch];
+        for (std::size_t s = 0; s < nSec; ++s) {
+            const float* k = c + s * COEFFS_PER_SEC;
+            float& z1 = z[(2 * s) * stride + ch];
+            float& z2 = z[(2 * s + 1) * stride + ch];
+            const float y = k[0] * v + z1;
+            z1 = k[1] * v - k[3] * y + z2;
+            z2 = k[2] * v - k[4] * y;
+            v = y;
+        }
+        x[ch] = v;
+    }
+}
+
+#if defined(SOS_SIMD_X86)
+static void kernel_sse(const float* c, std::size_t nSec, float* z, std::size_t stride, float* x) {
+    for (std::size_t g = 0; g < stride; g += 4) {
+        __m128 v = _mm_loadu_ps(x + g);
+        for (std::size_t s = 0; s < nSec; ++s) {
+            const float* k = c + s * COEFFS_PER_SEC;
+            float* z1p = z + (2 * s) * stride + g;
+            float* z2p = z + (2 * s + 1) * stride + g;
+            const __m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(k[0]), v), _mm_loadu_ps(z1p));
+            const __m128 z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(k[1]), v),
+                                                    _mm_mul_ps(_mm_set1_ps(k[3]), y)),
+                                         _mm_loadu_ps(z2p));
+            const __m128 z2 = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(k[2]), v),
+                                         _mm_mul_ps(_mm_set1_ps(k[4]), y));
+            _mm_storeu_ps(z1p, z1);
+            _mm_storeu_ps(z2p, z2);
+            v = y;
+        }
+        _mm_storeu_ps(x + g, v);
+    }
+}
+
+SOS_TARGET_AVX2
+static void kernel_avx2(const float* c, std::size_t nSec, float* z, std::size_t stride, float* x) {
+    for (std::size_t g = 0; g < stride; g += 8) {
+        __m256 v = _mm256_loadu_ps(x + g);
+        for (std::size_t s = 0; s < nSec; ++s) {
+            const float* k = c + s * COEFFS_PER_SEC;
+            float* z1p = z + (2 * s) * stride + g;
+            float* z2p = z + (2 * s + 1) * stride + g;
+            const __m256 y = _mm256_fmadd_ps(_mm256_set1_ps(k[0]), v, _mm256_loadu_ps(z1p));
+            const __m256 z1 = _mm256_fnmadd_ps(_mm256_set1_ps(k[3]), y,
+                                               _mm256_fmadd_ps(_mm256_set1_ps(k[1]), v, _mm256_loadu_ps(z2p)));
+            const __m256 z2 = _mm256_fnmadd_ps(_mm256_set1_ps(k[4]), y,
+                                               _mm256_mul_ps(_mm256_set1_ps(k[2]), v));
+            _mm256_storeu_ps(z1p, z1);
+            _mm256_storeu_ps(z2p, z2);
+            v = y;
+        }
+        _mm256_storeu_ps(x + g, v);
+    }
+}
+#endif // SOS_SIMD_X86
+
+#if defined(SOS_SIMD_NEON)
+static void kernel_neon(const float* c, std::size_t nSec, float* z, std::size_t stride, float* x) {
+    for (std::size_t g = 0; g < stride; g += 4) {
+        float32x4_t v = vld1q_f32(x + g);
+        for (std::size_t s = 0; s < nSec; ++s) {
+            const float* k = c + s * COEFFS_PER_SEC;
+            float* z1p = z + (2 * s) * stride + g;
+            float* z2p = z + (2 * s + 1) * stride + g;
+            const float32x4_t y = vfmaq_n_f32(vld1q_f32(z1p), v, k[0]);
+            const float32x4_t z1 = vfmsq_n_f32(vfmaq_n_f32(vld1q_f32(z2p), v, k[1]), y, k[3]);
+            const float32x4_t z2 = vfmsq_n_f32(vmulq_n_f32(v, k[2]), y, k[4]);
+            vst1q_f32(z1p, z1);
+            vst1q_f32(z2p, z2);
+            v = y;
+        }
+        vst1q_f32(x + g, v);
+    }
+}
+#endif // SOS_SIMD_NEON
+
+static MultiChSos_C::Kernel_t kernel_for(FirSimdPath_E p) {
+    switch (p) {
+#if defined(SOS_SIMD_X86)
+        case FirSimd_SSE:  return &kernel_sse;
+        case FirSimd_AVX2: return &kernel_avx2;
+#endif
+#if defined(SOS_SIMD_NEON)
+        case FirSimd_NEON: return &kernel_neon;
+#endif
+        default:           return &kernel_scalar;
+    }
+}
+
+// ============================ FILTER ================================
+void MultiChSos_C::init(const SosSection_t* sos, std::size_t nSec, std::size_t nCh) {
+    init(sos, nSec, nCh, fir_simd_detect_best_path());
+}
+
+void MultiChSos_C::init(const SosSection_t* sos, std::size_t nSec, std::size_t nCh, FirSimdPath_E path) {
+    assert(nSec > 0 && nCh > 0);
+    nSec_ = nSec;
+    nCh_ = nCh;
+    nChPad_ = ((nCh + LANE_PAD - 1) / LANE_PAD) * LANE_PAD;
+
+    coeffs_.resize(nSec * COEFFS_PER_SEC);
+    for (std::size_t s = 0; s < nSec; ++s) {
+        const SosSection_t& q = sos[s];
+        assert(q[3] != 0.0f);
+        const float inv = 1.0f / q[3];
+        float* k = &coeffs_[s * COEFFS_PER_SEC];
+        k[0] = q[0] * inv;
+        k[1] = q[1] * inv;
+        k[2] = q[2] * inv;
+        k[3] = q[4] * inv;
+        k[4] = q[5] * inv;
+    }
+
+    path_ = fir_simd_path_supported(path) ? path : FirSimd_Scalar;
+    kernel_ = kernel_for(path_);
+    z_.assign(2 * nSec_ * nChPad_, 0.0f);
+    row_.assign(nChPad_, 0.0f);
+}
+
+void MultiChSos_C::reset() {
+    std::fill(z_.begin(), z_.end(), 0.0f);
+}
+
+void MultiChSos_C::process_interleaved(float* data, std::size_t nScans) {
+    const std::size_t rowBytes = nCh_ * sizeof(float);
+    for (std::size_t sc = 0; sc < nScans; ++sc) {
+        float* scan = data + sc * nCh_;
+        std::memcpy(row_.data(), scan, rowBytes);
+        kernel_(coeffs_.data(), nSec_, z_.data(), nChPad_, row_.data());
+        std::memcpy(scan, row_.data(), rowBytes);
+    }
+}
+
+// ============================ HELPERS ===============================
+bool sos_is_stable(const SosSection_t* sos, std::size_t nSec) {
+    for (std::size_t s = 0; s < nSec; ++s) {
+        const double a0 = sos[s][3];
+        if (a0 == 0.0) return false;
+        const double a1 = sos[s][4] / a0;
+        const double a2 = sos[s][5] / a0;
+        // stability triangle for z^2 + a1 z + a2
+        if (!(std::fabs(a2) < 1.0 && std::fabs(a1) < 1.0 + a2)) return false;
+    }
+    return true;
+}
+
+double sos_group_delay_samples(const SosSection_t* sos, std::size_t nSec, double f_hz, double fs_hz) {
+    const double pi = 3.14159265358979323846;
+    auto phase = [&](double f) {
+        const std::complex<double> zi = std::polar(1.0, -2.0 * pi * f / fs_hz); // z^-1
+        std::complex<double> h(1.0, 0.0);
+        for (std::size_t s = 0; s < nSec; ++s) {
+            const auto& q = sos[s];
+            h *= (double(q[0]) + double(q[1]) * zi + double(q[2]) * zi * zi)
+               / (double(q[3]) + double(q[4]) * zi + double(q[5]) * zi * zi);
+        }
+        return std::arg(h);
+    };
+    // small step; unwrap the difference in case we straddle +-pi
+    const double df = 1e-3;
+    double d = phase(f_hz + df) - phase(f_hz - df);
+    if (d > pi) d -= 2.0 * pi;
+    if (d < -pi) d += 2.0 * pi;
+    return -d / (2.0 * pi * (2.0 * df / fs_hz));
+}
+
+std::size_t sos_settle_samples(const SosSection_t* sos, std::size_t nSec, double tol) {
+    // |p|^2 = a2/a0 for complex pairs, bigger real root otherwise
+    double rMax = 0.0;
+    for (std::size_t s = 0; s < nSec; ++s) {
+        const double a1 = sos[s][4] / sos[s][3];
+        const double a2 = sos[s][5] / sos[s][3];
+        const double disc = a1 * a1 - 4.0 * a2;
+        const double r = (disc < 0.0) ? std::sqrt(a2) : 0.5 * (std::fabs(a1) + std::sqrt(disc));
+        rMax = std::max(rMax, r);
+    }
+    return (rMax > 0.0 && rMax < 1.0) ? static_cast<std::size_t>(std::ceil(std::log(tol) / std::log(rMax))) : 0;
+}
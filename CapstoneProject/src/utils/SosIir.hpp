@@ -0,0 +1,52 @@
+#pragma once
+#include "FirSimd.hpp"   // FirSimdPath_E + runtime detection (same kernels menu)
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/* MULTI-CHANNEL SIMD IIR (cascade of second-order sections)
+- sections in scipy sos layout [b0 b1 b2 a0 a1 a2] (FilterDesign.py exports these), normalized by a0 at init
+- transposed direct form II per section: 2 state floats per channel per section
+    y = b0*x + z1;  z1 = b1*x - a1*y + z2;  z2 = b2*x - a2*y
+- same idea as MultiChFir_C: one scan = one row of nChPad_ floats, every op covers all channels
+  (8 ch = one AVX register), so a section costs 5 FMAs per scan for the whole headset
+- not linear phase, but group delay is a few samples instead of (N-1)/2 for the FIR
+*/
+
+using SosSection_t = std::array<float, 6>;
+
+class MultiChSos_C {
+public:
+    MultiChSos_C() = default;
+
+    // sections copied in; picks the best kernel unless told otherwise (unsupported -> scalar)
+    void init(const SosSection_t* sos, std::size_t nSec, std::size_t nCh);
+    void init(const SosSection_t* sos, std::size_t nSec, std::size_t nCh, FirSimdPath_E path);
+    void reset(); // zero the section states
+
+    // in place, data is [scan0 ch0..chN-1, scan1 ch0..] with stride nCh
+    void process_interleaved(float* data, std::size_t nScans);
+
+    FirSimdPath_E get_path() const { return path_; };
+    std::size_t get_num_sections() const { return nSec_; };
+
+    // kernel signature: one padded scan x (in place) through all sections; z = nSec x 2 rows of stride floats
+    using Kernel_t = void (*)(const float* coeffs, std::size_t nSec, float* z, std::size_t stride, float* x);
+
+private:
+    std::size_t nSec_ = 0;
+    std::size_t nCh_ = 0;
+    std::size_t nChPad_ = 0;       // nCh_ rounded up to 8 lanes (pad lanes stay 0)
+    FirSimdPath_E path_ = FirSimd_Scalar;
+    Kernel_t kernel_ = nullptr;
+    std::vector<float> coeffs_;    // nSec_ x [b0 b1 b2 a1 a2], a0 divided out
+    std::vector<float> z_;         // nSec_ x 2 x nChPad_
+    std::vector<float> row_;       // one padded scan
+};
+
+// all poles inside the unit circle (per section: |a2| < 1 and |a1| < 1 + a2, after /a0); false if a0 == 0
+bool sos_is_stable(const SosSection_t* sos, std::size_t nSec);
+// group delay in samples at f_hz (numeric phase derivative), for latency reporting
+double sos_group_delay_samples(const SosSection_t* sos, std::size_t nSec, double f_hz, double fs_hz);
+// samples until the slowest pole has decayed to tol (startup transient length); 0 if unstable
+std::size_t sos_settle_samples(const SosSection_t* sos, std::size_t nSec, double tol);
@@ -0,0 +1,81 @@
+#include "SpectralCache.hpp"
+#include <algorithm>
+#include <cmath>
+
+SpectralCache_C::SpectralCache_C()
+    : fft_(SPEC_NFFT)
+    , taper_(WINDOW_SCANS)
+    , buf_(SPEC_NFFT, 0.0f)
+    , bins_(SPEC_NUM_BINS)
+    , psd_(NUM_CH_CHUNK * SPEC_NUM_BINS, 0.0f)
+{
+    const double pi = 3.14159265358979323846;
+    double sumW2 = 0.0;
+    for (std::size_t s = 0; s < WINDOW_SCANS; ++s) {
+        const double w = 0.5 - 0.5 * std::cos(2.0 * pi * double(s) / double(WINDOW_SCANS)); // periodic hann
+        taper_[s] = float(w);
+        sumW2 += w * w;
+    }
+    psdScale_ = float(1.0 / (double(PIPELINE_FS_HZ) * sumW2));
+}
+
+bool SpectralCache_C::compute(std::span<const float> window, uint64_t totalPushed) {
+    if (valid_ && key_ == totalPushed) return false;
+    if (window.size() < WINDOW_SCANS * NUM_CH_CHUNK) return false;
+
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        double sum = 0.0;
+        for (std::size_t s = 0; s < WINDOW_SCANS; ++s) sum += window[s * NUM_CH_CHUNK + ch];
+        const float mean = float(sum / double(WINDOW_SCANS));
+        for (std::size_t s = 0; s < WINDOW_SCANS; ++s) buf_[s] = (window[s * NUM_CH_CHUNK + ch] - mean) * taper_[s];
+
+        fft_.forward(buf_.data(), bins_.data());
+
+        // one-sided: everything but DC and nyquist counted twice
+        float* p = psd_.data() + ch * SPEC_NUM_BINS;
+        for (std::size_t k = 0; k < SPEC_NUM_BINS; ++k) {
+            const bool edge = (k == 0) || (k == SPEC_NUM_BINS - 1);
+            p[k] = std::norm(bins_[k]) * psdScale_ * (edge ? 1.0f : 2.0f);
+        }
+    }
+    valid_ = true;
+    key_ = totalPushed;
+    ++numComputed_;
+    return true;
+}
+
+float SpectralCache_C::band_power(std::size_t ch, double loHz, double hiHz) const {
+    const std::size_t k0 = static_cast<std::size_t>(std::ceil(std::max(loHz, 0.0) / SPEC_BIN_HZ));
+    const std::size_t k1 = std::min(SPEC_NUM_BINS - 1, static_cast<std::size_t>(std::floor(std::max(hiHz, 0.0) / SPEC_BIN_HZ)));
+    const float* p = psd_.data() + ch * SPEC_NUM_BINS;
+    double acc = 0.0;
+    for (std::size_t k = k0; k <= k1 && k0 <= k1; ++k) acc += p[k];
+    return float(acc * SPEC_BIN_HZ);
+}
+
+float SpectralCache_C::harmonic_power(std::size_t ch, double hz, std::size_t nHarmonics, double halfWidthHz) const {
+    const double nyq = 0.5 * double(PIPELINE_FS_HZ);
+    float acc = 0.0f;
+    for (std::size_t h = 1; h <= nHarmonics && double(h) * hz < nyq; ++h) {
+        acc += band_power(ch, double(h) * hz - halfWidthHz, double(h) * hz + halfWidthHz);
+    }
+    return acc;
+}
+
+float SpectralCache_C::snr_at(std::size_t ch, double hz, double halfWidthHz, double sideHz) const {
+    const long last = long(SPEC_NUM_BINS) - 1;
+    const long kc = std::lround(hz / SPEC_BIN_HZ);
+    const long kw = long(std::floor(halfWidthHz / SPEC_BIN_HZ));
+    const long ks = std::max(1L, long(std::lround(sideHz / SPEC_BIN_HZ)));
+    const float* p = psd_.data() + ch * SPEC_NUM_BINS;
+    auto sum_bins = [&](long a, long b, double& acc) { // [a,b] clipped, returns how many
+        long n = 0;
+        for (long k = std::max(a, 0L); k <= std::min(b, last); ++k, ++n) acc += p[k];
+        return n;
+    };
+    double in = 0.0, side = 0.0;
+    const long nIn = sum_bins(kc - kw, kc + kw, in);
+    const long nSide = sum_bins(kc - kw - ks, kc - kw - 1, side) + sum_bins(kc + kw + 1, kc + kw + ks, side);
+    if (nIn == 0 || nSide == 0 || side <= 0.0) return 0.0f;
+    return float((in / double(nIn)) / (side / double(nSide)));
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <bit>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "../acq/WindowConfigs.hpp"
+#include "Fft.hpp"
+
+/* SHARED PER-WINDOW SPECTRUM
+- one real FFT per channel per window: mean removed, Hann taper, zero padded to SPEC_NFFT (next power of
+  2 >= WINDOW_SCANS) -> one-sided PSD in uV^2/Hz (Parseval: sum(psd) * bin_hz ~ variance of the window)
+- keyed on the window's get_total_pushed(): compute() on a window that's already in the cache returns
+  straight away, so every reader (SQA spectral metrics, SSVEP features, ...) just calls it first and only
+  the first one pays for the transforms
+- readers get spans/band sums, nothing allocates after construction
+- not thread-safe (RealFft_C scratch): lives in the consumer thread
+*/
+
+inline constexpr std::size_t SPEC_NFFT = std::bit_ceil(WINDOW_SCANS);
+inline constexpr std::size_t SPEC_NUM_BINS = SPEC_NFFT / 2 + 1;
+inline constexpr double SPEC_BIN_HZ = double(PIPELINE_FS_HZ) / double(SPEC_NFFT);
+
+class SpectralCache_C {
+public:
+    SpectralCache_C();
+
+    // window = the full sliding window (WINDOW_SCANS x NUM_CH_CHUNK interleaved), totalPushed = its
+    // get_total_pushed(). Returns true if it actually ran the FFTs (false = cache hit)
+    bool compute(std::span<const float> window, uint64_t totalPushed);
+    void invalidate() { valid_ = false; }
+
+    bool is_valid() const { return valid_; }
+    uint64_t get_key() const { return key_; }
+    uint64_t get_num_computed() const { return numComputed_; }
+
+    // one-sided PSD of channel ch, SPEC_NUM_BINS bins, bin k at k * SPEC_BIN_HZ
+    std::span<const float> psd(std::size_t ch) const {
+        return std::span<const float>(psd_.data() + ch * SPEC_NUM_BINS, SPEC_NUM_BINS);
+    }
+    // uV^2 in the bins whose centre is in [loHz, hiHz]
+    float band_power(std::size_t ch, double loHz, double hiHz) const;
+    // uV^2 within +-halfWidthHz of hz (+ its harmonics up to nHarmonics, below nyquist) -> SSVEP / line power
+    float harmonic_power(std::size_t ch, double hz, std::size_t nHarmonics, double halfWidthHz) const;
+    // mean psd in the bins at hz (+-halfWidthHz) over the mean of the sideHz of bins either side of those (SSVEP SNR)
+    float snr_at(std::size_t ch, double hz, double halfWidthHz, double sideHz) const;
+
+private:
+    RealFft_C fft_;
+    std::vector<float> taper_;              // Hann, WINDOW_SCANS
+    std::vector<float> buf_;                // SPEC_NFFT, zero padded tail stays 0
+    std::vector<std::complex<float>> bins_; // SPEC_NUM_BINS
+    std::vector<float> psd_;                // NUM_CH_CHUNK x SPEC_NUM_BINS
+    float psdScale_ = 0.0f;                 // 1 / (fs * sum(w^2))
+    bool valid_ = false;
+    uint64_t key_ = 0;
+    uint64_t numComputed_ = 0;
+};
@@ -0,0 +1,149 @@
+/*
+==============================================================================
+	File: SpscRingBuffer.hpp
+	Desc: Lock-free single-producer, single-consumer (SPSC) ring buffer for
+	passing chunks between the acquisition (producer) and decoder (consumer)
+	threads. Drop-in replacement for RingBuffer_C on the chunk queue.
+	This header is used by:
+  - Acquisition (producer): pushes bufferChunk_S as they come off the device.
+  - Decoder (consumer): pops chunks to build sliding windows.
+
+==============================================================================
+*/
+
+/*
+* FIXED SIZE LOCK-FREE RING BUFFER (NO MUTEX, NO SEMAPHORE ON THE FAST PATH)
+methods:
+* try_push / try_pop -> wait-free, never block (fast path)
+* push / pop        -> blocking wrappers (slow path only when full/empty)
+* acquire_write_slot / commit -> zero-copy push: producer fills the slot in
+  place (e.g. getData() + filtering straight into it), then publishes it
+* drain
+* close
+* get_stats -> depth / high-water / per-policy drop counters (any thread, approximate)
+overflow policy (what acquire_write_slot/push do when the queue is full):
+* OverflowPolicy_Block      -> producer waits for the consumer (lossless, default)
+* OverflowPolicy_DropOldest -> producer evicts the oldest queued item (bounded latency)
+* OverflowPolicy_DropNewest -> producer gets a scratch slot that commit() throws away
+data:
+* headIdx_ -> owned (written) by the consumer only
+* tailIdx_ -> owned (written) by the producer only
+* each index sits on its own cache line (no false sharing between threads),
+  next to the owner's cached copy of the other side's index so the fast path
+  only touches the peer's line when it looks full/empty
+notes:
+- works for EXACTLY one producer thread and one consumer thread
+- ordering: producer writes slot then publishes tail with release; consumer
+  loads tail with acquire before reading the slot (and vice versa for head)
+- one slot is always left empty to tell full from empty, so storage is capacity+1
+- blocking is optional: a waiter spins briefly, then parks on a semaphore with a
+  bounded timeout. The other side only touches the semaphore when it sees the
+  waiter's flag set, so a steady stream never makes a syscall.
+- DropOldest means the producer also moves headIdx_ (CAS), so the consumer copies
+  the slot then CASes head forward; if the producer evicted it mid-copy the CAS
+  fails and the copy is thrown away. Needs a trivially copyable T for that reason.
+*/
+#pragma once
+#include <semaphore>
+#include <cstddef> // std::size_t
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+#include <cstdint>
+
+enum OverflowPolicy_E {
+    OverflowPolicy_Block = 0,
+    OverflowPolicy_DropOldest,
+    OverflowPolicy_DropNewest
+};
+
+inline const char* OverflowPolicy_to_string(OverflowPolicy_E p) {
+    switch (p) {
+        case OverflowPolicy_Block:      return "block";
+        case OverflowPolicy_DropOldest: return "drop_oldest";
+        case OverflowPolicy_DropNewest: return "drop_newest";
+    }
+    return "unknown";
+}
+
+struct SpscQueueStats_S {
+    OverflowPolicy_E policy = OverflowPolicy_Block;
+    size_t capacity = 0;
+    size_t depth = 0;              // items queued right now
+    size_t high_water = 0;         // max depth seen at commit
+    uint64_t pushed = 0;           // items committed to the consumer
+    uint64_t dropped_oldest = 0;   // DropOldest: queued items evicted
+    uint64_t dropped_newest = 0;   // DropNewest: new items thrown away
+    uint64_t producer_blocks = 0;  // Block: times the producer had to wait for space
+};
+
+template<typename T>
+class SpscRingBuffer_C {
+public:
+    // Constructor
+    explicit SpscRingBuffer_C(size_t capacity, OverflowPolicy_E policy = OverflowPolicy_Block);
+
+    // fast path (wait-free)
+    bool try_push(const T& data);
+    bool try_pop(T* dest);
+
+    // two-phase (zero-copy) push. Slot holds whatever was there before -> caller overwrites every field it uses.
+    // Only one slot may be outstanding; nothing is visible to the consumer until commit().
+    T* try_acquire_write_slot(); // nullptr if full/closed (ignores the overflow policy)
+    T* acquire_write_slot();     // applies the overflow policy when full; nullptr only if closed
+    void commit();
+
+    // push follows the overflow policy (only Block actually blocks); false only once closed
+    bool push(const T& data);
+    bool pop(T* dest);
+    size_t drain(T* dest);
+    void close();
+    bool is_closed() const { return isClosed_.load(std::memory_order_acquire); };
+    size_t get_count() const;
+    size_t get_capacity() const { return capacity_; };
+    OverflowPolicy_E get_policy() const { return policy_; };
+    SpscQueueStats_S get_stats() const;
+
+private:
+    static constexpr std::size_t CACHE_LINE_BYTES = 64;
+    static constexpr int SPIN_ITERS = 256; // spins before parking
+    static constexpr std::chrono::microseconds PARK_TIMEOUT{2000}; // upper bound on a missed wake-up
+
+    size_t next_idx(size_t i) const { return (i + 1 == slots_) ? 0 : i + 1; };
+    bool wait_for_data();
+    bool wait_for_space();
+    void wake_consumer();
+    void wake_producer();
+    void drop_oldest();
+
+    size_t const capacity_;
+    size_t const slots_; // capacity_ + 1
+    OverflowPolicy_E const policy_;
+    std::vector<T> ringBufferArr;
+    T overflowSlot_{}; // DropNewest scratch slot (producer only)
+
+    // consumer-owned cache line
+    alignas(CACHE_LINE_BYTES) std::atomic<size_t> headIdx_{0};
+    size_t cachedTailIdx_ = 0; // consumer's last view of tailIdx_
+
+    // producer-owned cache line
+    alignas(CACHE_LINE_BYTES) std::atomic<size_t> tailIdx_{0};
+    size_t cachedHeadIdx_ = 0; // producer's last view of headIdx_
+    bool scratchOutstanding_ = false; // last acquire handed out overflowSlot_
+    // telemetry: written by the producer only (relaxed), read by anyone via get_stats()
+    std::atomic<size_t> highWater_{0};
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> droppedOldest_{0};
+    std::atomic<uint64_t> droppedNewest_{0};
+    std::atomic<uint64_t> producerBlocks_{0};
+
+    // slow path state (only touched when a side is about to block)
+    alignas(CACHE_LINE_BYTES) std::atomic<bool> isClosed_{false};
+    std::atomic<bool> consumerWaiting_{false};
+    std::atomic<bool> producerWaiting_{false};
+    std::counting_semaphore<> sem_data_parked_{0};
+    std::counting_semaphore<> sem_space_parked_{0};
+};
+
+#include "SpscRingBuffer.tpp"
@@ -0,0 +1,268 @@
+#include <cassert>
+#include <thread>
+#include <utility> // std::move
+
+template<typename T>
+SpscRingBuffer_C<T>::SpscRingBuffer_C(size_t capacity, OverflowPolicy_E policy)
+: capacity_(capacity), slots_(capacity + 1), policy_(policy) {
+    assert(capacity_ > 0);
+    // consumer may copy a slot the producer is evicting (copy gets discarded, but it must be a plain copy)
+    assert(policy_ != OverflowPolicy_DropOldest || std::is_trivially_copyable_v<T>);
+    ringBufferArr.resize(slots_);
+}
+
+// producer only. returns nullptr if full (or closed) without blocking
+template<typename T>
+T* SpscRingBuffer_C<T>::try_acquire_write_slot() {
+    if (isClosed_.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    const size_t tail = tailIdx_.load(std::memory_order_relaxed); // we're the only writer
+    const size_t next = next_idx(tail);
+    if (next == cachedHeadIdx_) {
+        // looks full from our cached view -> refresh from the consumer's line
+        cachedHeadIdx_ = headIdx_.load(std::memory_order_acquire);
+        if (next == cachedHeadIdx_) {
+            return nullptr; // really full
+        }
+    }
+    return &ringBufferArr[tail];
+}
+
+// when full, follows the overflow policy; returns nullptr only if closed
+// (only OverflowPolicy_Block ever waits here)
+template<typename T>
+T* SpscRingBuffer_C<T>::acquire_write_slot() {
+    T* slot = try_acquire_write_slot();
+    if (slot != nullptr || isClosed_.load(std::memory_order_relaxed)) {
+        return slot;
+    }
+
+    switch (policy_) {
+    case OverflowPolicy_DropNewest:
+        // hand out scratch; commit() will throw it away
+        scratchOutstanding_ = true;
+        return &overflowSlot_;
+
+    case OverflowPolicy_DropOldest:
+        drop_oldest();
+        return try_acquire_write_slot(); // space guaranteed now (we're the only one adding items)
+
+    case OverflowPolicy_Block:
+    default:
+        producerBlocks_.fetch_add(1, std::memory_order_relaxed);
+        while (slot == nullptr) {
+            if (!wait_for_space()) {
+                return nullptr;
+            }
+            slot = try_acquire_write_slot();
+        }
+        return slot;
+    }
+}
+
+// publish the slot handed out by the last acquire
+template<typename T>
+void SpscRingBuffer_C<T>::commit() {
+    if (scratchOutstanding_) {
+        // DropNewest overflow: consumer never sees it
+        scratchOutstanding_ = false;
+        droppedNewest_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const size_t tail = next_idx(tailIdx_.load(std::memory_order_relaxed));
+    // slot writes must be visible before the new tail
+    tailIdx_.store(tail, std::memory_order_release);
+    wake_consumer();
+
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    const size_t head = headIdx_.load(std::memory_order_relaxed);
+    const size_t depth = (tail >= head) ? (tail - head) : (slots_ - head + tail);
+    if (depth > highWater_.load(std::memory_order_relaxed)) {
+        highWater_.store(depth, std::memory_order_relaxed);
+    }
+}
+
+// DropOldest only: queue is full, so evict the item at head.
+// If the CAS loses, the consumer just popped it and there's space anyway.
+template<typename T>
+void SpscRingBuffer_C<T>::drop_oldest() {
+    size_t head = headIdx_.load(std::memory_order_acquire);
+    if (next_idx(tailIdx_.load(std::memory_order_relaxed)) == head
+        && headIdx_.compare_exchange_strong(head, next_idx(head), std::memory_order_acq_rel)) {
+        droppedOldest_.fetch_add(1, std::memory_order_relaxed);
+    }
+    cachedHeadIdx_ = headIdx_.load(std::memory_order_acquire);
+}
+
+// producer only. returns false if full (or closed) without blocking
+template<typename T>
+bool SpscRingBuffer_C<T>::try_push(const T& data) {
+    T* slot = try_acquire_write_slot();
+    if (slot == nullptr) {
+        return 0;
+    }
+    *slot = data;
+    commit();
+    return 1;
+}
+
+// consumer only. returns false if empty (or closed) without blocking
+template<typename T>
+bool SpscRingBuffer_C<T>::try_pop(T* dest) {
+    if (isClosed_.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    if (policy_ == OverflowPolicy_DropOldest) {
+        // producer may move head too -> copy, then claim with CAS (retry if it evicted our slot)
+        size_t head = headIdx_.load(std::memory_order_acquire);
+        for (;;) {
+            if (head == cachedTailIdx_) {
+                cachedTailIdx_ = tailIdx_.load(std::memory_order_acquire);
+                if (head == cachedTailIdx_) {
+                    return 0;
+                }
+            }
+            *dest = ringBufferArr[head];
+            if (headIdx_.compare_exchange_strong(head, next_idx(head), std::memory_order_acq_rel)) {
+                break;
+            }
+            // CAS failure reloaded head with the producer's value; our copy may be torn -> go again
+        }
+        wake_producer();
+        return 1;
+    }
+
+    const size_t head = headIdx_.load(std::memory_order_relaxed); // we're the only writer
+    if (head == cachedTailIdx_) {
+        // looks empty from our cached view -> refresh from the producer's line
+        cachedTailIdx_ = tailIdx_.load(std::memory_order_acquire);
+        if (head == cachedTailIdx_) {
+            return 0; // really empty
+        }
+    }
+    *dest = std::move(ringBufferArr[head]);
+    // release the slot back to the producer only after we've moved out of it
+    headIdx_.store(next_idx(head), std::memory_order_release);
+    wake_producer();
+    return 1;
+}
+
+// push under the overflow policy (blocks only for OverflowPolicy_Block); returns false only if closed
+template<typename T>
+bool SpscRingBuffer_C<T>::push(const T& data) {
+    T* slot = acquire_write_slot();
+    if (slot == nullptr) {
+        return 0;
+    }
+    *slot = data;
+    commit();
+    return 1;
+}
+
+// BLOCKING pop: waits for an item; returns false only if closed
+template<typename T>
+bool SpscRingBuffer_C<T>::pop(T* dest) {
+    while (!try_pop(dest)) {
+        if (!wait_for_data()) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// drain: pops as many as currently available items (non-blocking)
+// returns num of items
+template<typename T>
+size_t SpscRingBuffer_C<T>::drain(T* dest) {
+    size_t i = 0;
+    while (try_pop(dest + i)) {
+        i++;
+    }
+    return i;
+}
+
+template<typename T>
+void SpscRingBuffer_C<T>::close() {
+    isClosed_.store(true, std::memory_order_release);
+    // kick anyone parked so they see the closed flag
+    sem_data_parked_.release();
+    sem_space_parked_.release();
+}
+
+template<typename T>
+SpscQueueStats_S SpscRingBuffer_C<T>::get_stats() const {
+    SpscQueueStats_S st;
+    st.policy = policy_;
+    st.capacity = capacity_;
+    st.depth = get_count();
+    st.high_water = highWater_.load(std::memory_order_relaxed);
+    st.pushed = pushed_.load(std::memory_order_relaxed);
+    st.dropped_oldest = droppedOldest_.load(std::memory_order_relaxed);
+    st.dropped_newest = droppedNewest_.load(std::memory_order_relaxed);
+    st.producer_blocks = producerBlocks_.load(std::memory_order_relaxed);
+    return st;
+}
+
+template<typename T>
+size_t SpscRingBuffer_C<T>::get_count() const {
+    // approximate if called from a third thread; exact from producer/consumer
+    const size_t head = headIdx_.load(std::memory_order_acquire);
+    const size_t tail = tailIdx_.load(std::memory_order_acquire);
+    return (tail >= head) ? (tail - head) : (slots_ - head + tail);
+}
+
+// ======================== SLOW PATH (blocking) ========================
+// Spin first (a chunk is usually a few us away once we're close), then park.
+// The waker only releases the semaphore if it sees our flag, so a missed
+// wake-up is possible in a narrow race; PARK_TIMEOUT bounds its cost.
+// returns false if closed
+template<typename T>
+bool SpscRingBuffer_C<T>::wait_for_data() {
+    for (int i = 0; i < SPIN_ITERS; i++) {
+        if (isClosed_.load(std::memory_order_relaxed)) return 0;
+        if (tailIdx_.load(std::memory_order_acquire) != headIdx_.load(std::memory_order_acquire)) return 1;
+        std::this_thread::yield();
+    }
+    consumerWaiting_.store(true, std::memory_order_release);
+    // re-check after advertising so we don't sleep through a push that just landed
+    if (tailIdx_.load(std::memory_order_acquire) == headIdx_.load(std::memory_order_acquire)
+        && !isClosed_.load(std::memory_order_acquire)) {
+        (void)sem_data_parked_.try_acquire_for(PARK_TIMEOUT);
+    }
+    consumerWaiting_.store(false, std::memory_order_relaxed);
+    return !isClosed_.load(std::memory_order_acquire);
+}
+
+template<typename T>
+bool SpscRingBuffer_C<T>::wait_for_space() {
+    for (int i = 0; i < SPIN_ITERS; i++) {
+        if (isClosed_.load(std::memory_order_relaxed)) return 0;
+        if (next_idx(tailIdx_.load(std::memory_order_relaxed)) != headIdx_.load(std::memory_order_acquire)) return 1;
+        std::this_thread::yield();
+    }
+    producerWaiting_.store(true, std::memory_order_release);
+    if (next_idx(tailIdx_.load(std::memory_order_relaxed)) == headIdx_.load(std::memory_order_acquire)
+        && !isClosed_.load(std::memory_order_acquire)) {
+        (void)sem_space_parked_.try_acquire_for(PARK_TIMEOUT);
+    }
+    producerWaiting_.store(false, std::memory_order_relaxed);
+    return !isClosed_.load(std::memory_order_acquire);
+}
+
+// fast path check is a single relaxed load of a flag that's almost always false
+template<typename T>
+void SpscRingBuffer_C<T>::wake_consumer() {
+    if (consumerWaiting_.load(std::memory_order_relaxed)
+        && consumerWaiting_.exchange(false, std::memory_order_acq_rel)) {
+        sem_data_parked_.release();
+    }
+}
+
+template<typename T>
+void SpscRingBuffer_C<T>::wake_producer() {
+    if (producerWaiting_.load(std::memory_order_relaxed)
+        && producerWaiting_.exchange(false, std::memory_order_acq_rel)) {
+        sem_space_parked_.release();
+    }
+}
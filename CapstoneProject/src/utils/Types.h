@@ -32,10 +32,38 @@ using time_point_T = std::chrono::time_point<clock_T>;
 
 /* START CONFIGS */
 
+// DEVICE GEOMETRY (EEG_NUM_CHANNELS / EEG_FS_HZ set from cmake, defaults = Unicorn: 8 ch @ 250 Hz)
+// chunk, window, filter bank, SQA and features are all sized from these at compile time, so a 64 ch / 1 kHz
+// amplifier gets its own build and the 8 ch path keeps its constexpr loops + fixed size arrays
+#ifndef EEG_NUM_CHANNELS
+#define EEG_NUM_CHANNELS 8
+#endif
+#ifndef EEG_FS_HZ
+#define EEG_FS_HZ 250
+#endif
+inline constexpr std::size_t ACQ_FS_HZ = EEG_FS_HZ;
+
 // CHUNKING POLICY
-inline constexpr std::size_t NUM_CH_CHUNK = 8; // Unicorn EEG has 8 channels (EEG1...EEG8)
-inline constexpr std::size_t NUM_SCANS_CHUNK = 32; // ~128ms latency @ 250Hz
+inline constexpr std::size_t NUM_CH_CHUNK = EEG_NUM_CHANNELS; // max channels a chunk carries (device may use fewer, see g_n_eeg_channels)
+inline constexpr std::size_t CHUNK_MS = 128;
+inline constexpr std::size_t NUM_SCANS_CHUNK = CHUNK_MS * ACQ_FS_HZ / 1000; // 32 @250Hz, 64 @500Hz, 128 @1kHz, 48 @375Hz (no fft bandpass)
 inline constexpr std::size_t NUM_SAMPLES_CHUNK = NUM_CH_CHUNK * NUM_SCANS_CHUNK;
+static_assert(NUM_CH_CHUNK > 0, "need at least one channel");
+static_assert(NUM_SCANS_CHUNK * 1000 == CHUNK_MS * ACQ_FS_HZ, "chunk must be a whole number of scans (use a multiple of 125 Hz)");
+
+// SAMPLE RATES
+// headset rate, and the rate everything after the filter bank sees (EEG_DECIMATION set from cmake).
+// after the 5-25 Hz bandpass, 250 Hz is way oversampled -> decimating by 2 halves all window math
+#ifndef EEG_DECIMATION
+#define EEG_DECIMATION 1
+#endif
+inline constexpr std::size_t DECIMATION = EEG_DECIMATION;
+inline constexpr std::size_t PIPELINE_FS_HZ = ACQ_FS_HZ / DECIMATION;
+inline constexpr std::size_t NUM_SCANS_CHUNK_OUT = NUM_SCANS_CHUNK / DECIMATION; // scans per chunk after the filter bank
+inline constexpr double PIPELINE_SCAN_MS = 1000.0 / double(PIPELINE_FS_HZ); // one scan after the filter bank
+inline constexpr double CHUNK_LATENCY_MS = 1000.0 * double(NUM_SCANS_CHUNK - 1) / double(ACQ_FS_HZ); // first scan waits for the rest
+static_assert(NUM_SCANS_CHUNK % DECIMATION == 0, "chunk must hold a whole number of decimated scans");
+static_assert(ACQ_FS_HZ % DECIMATION == 0, "decimated rate must be a whole number of Hz");
 
 /* END CONFIGS */
 
@@ -258,11 +286,16 @@ struct eeg_sample_t {
 */
 struct bufferChunk_S {
 	uint64_t tick = 0;                           // monotic sequence number (0,1,2,3...) assigned by producer so consumers can detect dropped chunks
-	double epoch_ms = 0.0;                       // timestamp of first scan in chunk
+	double epoch_ms = 0.0;                       // acquisition time of first scan in chunk (steady clock ms, latency_now_ms())
 	std::size_t numCh = NUM_CH_CHUNK; 		     // number of enabled channels
-	std::size_t numScans = NUM_SCANS_CHUNK;      // number of scans (time steps) in this chunk (32)
+	std::size_t numScans = NUM_SCANS_CHUNK;      // number of scans (time steps) in this chunk (32, NUM_SCANS_CHUNK_OUT after the filter bank)
 	std::array<float, NUM_SAMPLES_CHUNK> data{}; // interleaved samples: [ch0s0, ch1s0, ch2s0, ..., chN-1s0, ch0s1, ch1s1, ..., chN-1sM-1]
 	bool active_label;                           // obtained from stimulus global state
+	UIState_E ui_state = UIState_None;           // ui state / label / freq when the chunk was acquired (replay: as recorded)
+	TestFreq_E label = TestFreq_None;
+	int freq_hz = 0;
+	uint64_t first_scan = 0;                     // device scan counter of the first scan (0 if the backend has no counter)
+	uint32_t lost_scans = 0;                     // scans the counter skipped right before this chunk (lost in transport)
 }; // bufferChunk_S
 
 struct trainingProto_S {
@@ -313,13 +346,35 @@ struct Stats_s {
     std::array<float, NUM_CH_CHUNK> max_step_uv{};
     std::array<float, NUM_CH_CHUNK> kurt{};
     std::array<float, NUM_CH_CHUNK> entropy{};
+    // spectral (SpectralCache.hpp, the window's shared FFT)
+    std::array<float, NUM_CH_CHUNK> spec_entropy{}; // normalized 0..1 over SQA_SPEC_LO_HZ..nyquist (1 = flat/white)
+    std::array<float, NUM_CH_CHUNK> line_ratio{};   // mains (+harmonics) power / total power
+    std::array<float, NUM_CH_CHUNK> alpha_uv2{};    // 8-13 Hz
+    std::array<float, NUM_CH_CHUNK> emg_uv2{};      // broadband muscle, SQA_EMG_LO_HZ..nyquist
 	bool isBad = false;
 };
 
+// Per-channel robust baseline of the samples (streaming P2 estimators, since the analyzer started)
+// + the artifact thresholds the SQA derives from it
+struct RobustStats_s {
+	std::array<float, NUM_CH_CHUNK> median_uv{};
+	std::array<float, NUM_CH_CHUNK> mad_uv{};
+	std::array<float, NUM_CH_CHUNK> p01_uv{};
+	std::array<float, NUM_CH_CHUNK> p99_uv{};
+	std::array<float, NUM_CH_CHUNK> amp_thresh_uv{};  // |x| over this counts towards AMP_PERSIST_SAMPLES
+	std::array<float, NUM_CH_CHUNK> step_thresh_uv{}; // |step| over this counts towards STEP_PERSIST_SAMPLES
+	bool adaptive = false; // false = not enough baseline yet, fixed MAX_ABS_UV / MAX_STEP_UV
+};
+
 // Running statistic measures of signals (rolling 45s)
 // AFTER bandpass + CAR + artifact rejection
 struct SignalStats_s {
 	Stats_s rollingStats{};
+	// spread of the per-window values over the same 45 s (std/rms/kurt/entropy; max_abs/max_step = rollingStats')
+	Stats_s rollingMin{};
+	Stats_s rollingMedian{};
+	Stats_s rollingMax{};
+	RobustStats_s robust{};
     float current_bad_win_rate = 0.0; // last 45 s
     float overall_bad_win_rate = 0.0; // since start
     size_t num_win_in_rolling = 0;
@@ -0,0 +1,277 @@
+#include "WindowMoments.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define SQA_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define SQA_TARGET_AVX2
+    #else
+        // no fma on purpose: same rounding as the scalar kernel
+        #define SQA_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+using HopAgg_S = WindowMoments_C::HopAgg_S;
+using HopSums_S = WindowMoments_C::HopSums_S;
+
+static constexpr float HIST_INV = 1.0f / (SQA_HIST_MAX_UV - SQA_HIST_MIN_UV);
+
+// ============================ KERNELS ===============================
+// x = first scan of the hop (interleaved, stride NUM_CH_CHUNK). Sums are shifted by that first scan
+// (small numbers -> no cancellation converting to central moments later)
+
+static void hop_scalar_range(const float* x, std::size_t ch0, std::size_t ch1, const float* ampThresh,
+                             const float* stepThresh, HopAgg_S& agg, HopSums_S& sums) {
+    for (std::size_t ch = ch0; ch < ch1; ++ch) {
+        const double ref = x[ch];
+        double s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0;
+        float maxAbs = 0.0f, maxStep = 0.0f, prev = x[ch];
+        int amp = 0, step = 0;
+        auto& hist = agg.hist[ch];
+        hist.fill(0);
+        for (std::size_t s = 0; s < WINDOW_HOP_SCANS; ++s) {
+            const float v = x[s * NUM_CH_CHUNK + ch];
+            const double d = double(v) - ref;
+            const double d2 = d * d;
+            s1 += d;
+            s2 += d2;
+            s3 += d2 * d;
+            s4 += d2 * d2;
+
+            const float av = std::abs(v);
+            maxAbs = std::max(maxAbs, av);
+            amp += (av > ampThresh[ch]);
+            const float st = std::abs(v - prev); // 0 on the first scan
+            maxStep = std::max(maxStep, st);
+            step += (st > stepThresh[ch]);
+            prev = v;
+
+            float t = (v - SQA_HIST_MIN_UV) * HIST_INV;
+            t = (t > 0.0f) ? t : 0.0f; // NaN -> bin 0 too
+            t = (t < 1.0f) ? t : 1.0f;
+            hist[std::min(int(t * float(SQA_HIST_BINS)), SQA_HIST_BINS - 1)]++;
+        }
+        sums.s1[ch] = s1;
+        sums.s2[ch] = s2;
+        sums.s3[ch] = s3;
+        sums.s4[ch] = s4;
+        agg.maxAbs[ch] = maxAbs;
+        agg.maxStep[ch] = maxStep;
+        agg.ampCount[ch] = amp;
+        agg.stepCount[ch] = step;
+    }
+}
+
+static void kernel_scalar(const float* x, const float* ampThresh, const float* stepThresh, HopAgg_S& agg, HopSums_S& sums) {
+    hop_scalar_range(x, 0, NUM_CH_CHUNK, ampThresh, stepThresh, agg, sums);
+}
+
+#if defined(SQA_SIMD_X86)
+// 8 channels per pass, scans in order -> everything lives in registers until the hop is done.
+// Leftover channels (NUM_CH_CHUNK % 8) go through the scalar loop
+SQA_TARGET_AVX2
+static void kernel_avx2(const float* x, const float* ampThresh, const float* stepThresh, HopAgg_S& agg, HopSums_S& sums) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 histMin = _mm256_set1_ps(SQA_HIST_MIN_UV);
+    const __m256 histInv = _mm256_set1_ps(HIST_INV);
+    const __m256 nBins = _mm256_set1_ps(float(SQA_HIST_BINS));
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i lastBin = _mm256_set1_epi32(SQA_HIST_BINS - 1);
+    alignas(32) int32_t bins[8];
+
+    std::size_t g = 0;
+    for (; g + 8 <= NUM_CH_CHUNK; g += 8) {
+        const __m256 first = _mm256_loadu_ps(x + g);
+        const __m256 ampV = _mm256_loadu_ps(ampThresh + g);
+        const __m256 stepV = _mm256_loadu_ps(stepThresh + g);
+        const __m256d refLo = _mm256_cvtps_pd(_mm256_castps256_ps128(first));
+        const __m256d refHi = _mm256_cvtps_pd(_mm256_extractf128_ps(first, 1));
+        __m256d s1Lo = _mm256_setzero_pd(), s2Lo = s1Lo, s3Lo = s1Lo, s4Lo = s1Lo;
+        __m256d s1Hi = s1Lo, s2Hi = s1Lo, s3Hi = s1Lo, s4Hi = s1Lo;
+        __m256 maxAbs = zero, maxStep = zero, prev = first;
+        __m256i ampCnt = _mm256_setzero_si256(), stepCnt = ampCnt;
+        for (std::size_t l = 0; l < 8; ++l) agg.hist[g + l].fill(0);
+
+        for (std::size_t s = 0; s < WINDOW_HOP_SCANS; ++s) {
+            const __m256 v = _mm256_loadu_ps(x + s * NUM_CH_CHUNK + g);
+
+            const __m256d dLo = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), refLo);
+            const __m256d dHi = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), refHi);
+            const __m256d d2Lo = _mm256_mul_pd(dLo, dLo);
+            const __m256d d2Hi = _mm256_mul_pd(dHi, dHi);
+            s1Lo = _mm256_add_pd(s1Lo, dLo);
+            s1Hi = _mm256_add_pd(s1Hi, dHi);
+            s2Lo = _mm256_add_pd(s2Lo, d2Lo);
+            s2Hi = _mm256_add_pd(s2Hi, d2Hi);
+            s3Lo = _mm256_add_pd(s3Lo, _mm256_mul_pd(d2Lo, dLo));
+            s3Hi = _mm256_add_pd(s3Hi, _mm256_mul_pd(d2Hi, dHi));
+            s4Lo = _mm256_add_pd(s4Lo, _mm256_mul_pd(d2Lo, d2Lo));
+            s4Hi = _mm256_add_pd(s4Hi, _mm256_mul_pd(d2Hi, d2Hi));
+
+            // max_ps(a, b) = a > b ? a : b -> new value first, same NaN handling as std::max(old, new)
+            const __m256 av = _mm256_andnot_ps(signMask, v);
+            maxAbs = _mm256_max_ps(av, maxAbs);
+            ampCnt = _mm256_sub_epi32(ampCnt, _mm256_castps_si256(_mm256_cmp_ps(av, ampV, _CMP_GT_OQ)));
+            const __m256 st = _mm256_andnot_ps(signMask, _mm256_sub_ps(v, prev));
+            maxStep = _mm256_max_ps(st, maxStep);
+            stepCnt = _mm256_sub_epi32(stepCnt, _mm256_castps_si256(_mm256_cmp_ps(st, stepV, _CMP_GT_OQ)));
+            prev = v;
+
+            // no scatter in avx2: bins out, bumped per lane
+            __m256 t = _mm256_mul_ps(_mm256_sub_ps(v, histMin), histInv);
+            t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(bins),
+                               _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(t, nBins)), lastBin));
+            for (std::size_t l = 0; l < 8; ++l) agg.hist[g + l][bins[l]]++;
+        }
+
+        _mm256_storeu_pd(sums.s1.data() + g, s1Lo);
+        _mm256_storeu_pd(sums.s1.data() + g + 4, s1Hi);
+        _mm256_storeu_pd(sums.s2.data() + g, s2Lo);
+        _mm256_storeu_pd(sums.s2.data() + g + 4, s2Hi);
+        _mm256_storeu_pd(sums.s3.data() + g, s3Lo);
+        _mm256_storeu_pd(sums.s3.data() + g + 4, s3Hi);
+        _mm256_storeu_pd(sums.s4.data() + g, s4Lo);
+        _mm256_storeu_pd(sums.s4.data() + g + 4, s4Hi);
+        _mm256_storeu_ps(agg.maxAbs.data() + g, maxAbs);
+        _mm256_storeu_ps(agg.maxStep.data() + g, maxStep);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(agg.ampCount.data() + g), ampCnt);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(agg.stepCount.data() + g), stepCnt);
+    }
+    hop_scalar_range(x, g, NUM_CH_CHUNK, ampThresh, stepThresh, agg, sums);
+}
+#endif // SQA_SIMD_X86
+
+// only avx2 gets its own kernel: moments need double lanes, sse/neon would be 2-wide
+static WindowMoments_C::HopKernel_t kernel_for(FirSimdPath_E p) {
+    switch (p) {
+#if defined(SQA_SIMD_X86)
+        case FirSimd_AVX2: return &kernel_avx2;
+#endif
+        default:           return &kernel_scalar;
+    }
+}
+
+// ============================ WINDOW ================================
+WindowMoments_C::WindowMoments_C(float ampThreshUv, float stepThreshUv)
+    : WindowMoments_C(ampThreshUv, stepThreshUv, fir_simd_detect_best_path()) {}
+
+WindowMoments_C::WindowMoments_C(float ampThreshUv, float stepThreshUv, FirSimdPath_E path) {
+    ampThresh_.fill(ampThreshUv);
+    stepThresh_.fill(stepThreshUv);
+    if (!fir_simd_path_supported(path)) path = FirSimd_Scalar;
+    kernel_ = kernel_for(path);
+    path_ = (kernel_ == &kernel_scalar) ? FirSimd_Scalar : path;
+    cLogC_[0] = 0.0;
+    for (std::size_t c = 1; c <= WINDOW_SCANS; ++c) cLogC_[c] = double(c) * std::log(double(c));
+}
+
+void WindowMoments_C::set_thresholds(const std::array<float, NUM_CH_CHUNK>& ampUv,
+                                     const std::array<float, NUM_CH_CHUNK>& stepUv) {
+    ampThresh_ = ampUv;
+    stepThresh_ = stepUv;
+}
+
+void WindowMoments_C::compute_hop(std::span<const float> window, std::size_t pos, HopAgg_S& agg) const {
+    const float* x = window.data() + pos * WINDOW_HOP_SCANS * NUM_CH_CHUNK;
+    HopSums_S sums;
+    kernel_(x, ampThresh_.data(), stepThresh_.data(), agg, sums);
+
+    const double n = double(WINDOW_HOP_SCANS);
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        agg.entryStep[ch] = (pos > 0) ? std::abs(x[ch] - (x - NUM_CH_CHUNK)[ch]) : 0.0f; // unused for the oldest hop
+        const double m = sums.s1[ch] / n;
+        const double s2 = sums.s2[ch], s3 = sums.s3[ch];
+        agg.mean[ch] = double(x[ch]) + m;
+        agg.m2[ch] = s2 - n * m * m;
+        agg.m3[ch] = s3 - 3.0 * m * s2 + 2.0 * n * m * m * m;
+        agg.m4[ch] = sums.s4[ch] - 4.0 * m * s3 + 6.0 * m * m * s2 - 3.0 * n * m * m * m * m;
+    }
+}
+
+void WindowMoments_C::hist_add(const HopAgg_S& agg, int sign) {
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        for (int b = 0; b < SQA_HIST_BINS; ++b) winHist_[ch][b] += sign * int(agg.hist[ch][b]);
+    }
+}
+
+void WindowMoments_C::update(std::span<const float> window, uint64_t totalPushed, Stats_s& out) {
+    constexpr uint64_t hopSamples = WINDOW_HOP_SCANS * NUM_CH_CHUNK;
+    const bool moveOk = valid_ && totalPushed >= lastPushed_ && (totalPushed - lastPushed_) % hopSamples == 0
+                        && (totalPushed - lastPushed_) / NUM_CH_CHUNK < WINDOW_SCANS;
+
+    if (moveOk) {
+        // k hops in, k hops out
+        const std::size_t k = static_cast<std::size_t>((totalPushed - lastPushed_) / hopSamples);
+        for (std::size_t j = 0; j < k; ++j) hist_add(hops_[(head_ + j) % SQA_NUM_HOPS], -1);
+        head_ = (head_ + k) % SQA_NUM_HOPS;
+        for (std::size_t p = SQA_NUM_HOPS - k; p < SQA_NUM_HOPS; ++p) {
+            HopAgg_S& h = hops_[(head_ + p) % SQA_NUM_HOPS];
+            compute_hop(window, p, h);
+            hist_add(h, +1);
+        }
+        lastHopsComputed_ = k;
+    } else {
+        head_ = 0;
+        for (auto& h : winHist_) h.fill(0);
+        for (std::size_t p = 0; p < SQA_NUM_HOPS; ++p) {
+            compute_hop(window, p, hops_[p]);
+            hist_add(hops_[p], +1);
+        }
+        lastHopsComputed_ = SQA_NUM_HOPS;
+    }
+    valid_ = true;
+    lastPushed_ = totalPushed;
+
+    // merge the hops (Pebay: combine two sets' central moments)
+    std::array<double, NUM_CH_CHUNK> mean{}, m2{}, m3{}, m4{};
+    double nA = 0.0;
+    const double nB = double(WINDOW_HOP_SCANS);
+    out.max_abs_uv.fill(0.0f);
+    out.max_step_uv.fill(0.0f);
+    ampCount_.fill(0);
+    stepCount_.fill(0);
+    for (std::size_t p = 0; p < SQA_NUM_HOPS; ++p) {
+        const HopAgg_S& h = hops_[(head_ + p) % SQA_NUM_HOPS];
+        const double n = nA + nB;
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+            const double d = h.mean[ch] - mean[ch];
+            const double dn = d / n;
+            const double dn2 = dn * dn;
+            const double t = d * dn * nA * nB;
+            m4[ch] += h.m4[ch] + t * dn2 * (nA * nA - nA * nB + nB * nB) + 6.0 * dn2 * (nA * nA * h.m2[ch] + nB * nB * m2[ch])
+                      + 4.0 * dn * (nA * h.m3[ch] - nB * m3[ch]);
+            m3[ch] += h.m3[ch] + t * dn * (nA - nB) + 3.0 * dn * (nA * h.m2[ch] - nB * m2[ch]);
+            m2[ch] += h.m2[ch] + t;
+            mean[ch] += nB * dn;
+
+            out.max_abs_uv[ch] = std::max(out.max_abs_uv[ch], h.maxAbs[ch]);
+            out.max_step_uv[ch] = std::max(out.max_step_uv[ch], h.maxStep[ch]);
+            ampCount_[ch] += h.ampCount[ch];
+            stepCount_[ch] += h.stepCount[ch];
+            if (p > 0) {
+                out.max_step_uv[ch] = std::max(out.max_step_uv[ch], h.entryStep[ch]);
+                stepCount_[ch] += (h.entryStep[ch] > stepThresh_[ch]);
+            }
+        }
+        nA = n;
+    }
+
+    const double n = double(WINDOW_SCANS);
+    const double logN = std::log(n);
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        const double var = std::max(0.0, m2[ch] / n);
+        out.mean_uv[ch] = float(mean[ch]);
+        out.std_uv[ch] = float(std::sqrt(var));
+        out.rms_uv[ch] = float(std::sqrt(mean[ch] * mean[ch] + var));
+        out.kurt[ch] = (var < 1e-12) ? 0.0f : float(n * m4[ch] / (m2[ch] * m2[ch]) - 3.0);
+
+        // H = -sum p log p = log n - (1/n) sum c log c
+        double sumCLogC = 0.0;
+        for (int b = 0; b < SQA_HIST_BINS; ++b) sumCLogC += cLogC_[winHist_[ch][b]];
+        out.entropy[ch] = float(logN - sumCLogC / n);
+    }
+}
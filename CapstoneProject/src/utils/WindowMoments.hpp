@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "../acq/WindowConfigs.hpp"
+#include "FirSimd.hpp"
+
+/* STREAMING WINDOW STATISTICS (SQA)
+- consecutive windows overlap by 7/8: only WINDOW_HOP_SCANS scans are new. So per-window stats are kept as
+  per-hop sub-aggregates in a ring (one slot per hop in the window); a new window computes the hop(s) that
+  entered, drops the one(s) that left and merges the rest -> cost ~ 1 hop of scans + NUM_HOPS merges,
+  instead of 3 passes over the whole window
+- per hop and channel: count/mean/M2/M3/M4 (central, merged with Pebay's pairwise formulas -> no
+  E[x^4] - ... cancellation even with a big DC offset), max |x|, max step inside the hop + the step into it
+  from the previous hop, over-threshold counts, entropy histogram bins
+- window histogram = running totals (ints: add the entering hop's bins, subtract the leaving one's, exact);
+  entropy from a c*log(c) table -> no log() per window
+- which hops are new: MirroredRingBuffer_C::get_total_pushed(). Moved by a whole number of hops (< window)
+  -> incremental, anything else (first window, partial refill, big jump) -> all hops recomputed
+- a hop is one pass over the interleaved scans, all channels at once (AVX2: 8 channels per register,
+  moments in double lanes, bins stored out and bumped per lane). Scalar kernel for the rest / other cpus.
+  Same op order in both (no fma) -> bit identical results
+- thresholds are per channel and can move (adaptive SQA thresholds): a hop's counts use the thresholds
+  from when it was computed, so after a change older hops catch up within one window
+*/
+
+inline constexpr std::size_t SQA_NUM_HOPS     = WINDOW_SCANS / WINDOW_HOP_SCANS; // 8
+inline constexpr int         SQA_HIST_BINS    = 64;      // time-domain amplitude histogram for entropy
+inline constexpr float       SQA_HIST_MIN_UV  = -200.0f;
+inline constexpr float       SQA_HIST_MAX_UV  = 200.0f;
+static_assert(WINDOW_SCANS % WINDOW_HOP_SCANS == 0, "window must be a whole number of hops");
+
+class WindowMoments_C {
+public:
+    WindowMoments_C(float ampThreshUv, float stepThreshUv);
+    WindowMoments_C(float ampThreshUv, float stepThreshUv, FirSimdPath_E path); // unsupported -> scalar
+
+    // window = the full sliding window (WINDOW_SCANS x NUM_CH_CHUNK interleaved), totalPushed = its
+    // get_total_pushed(). Fills mean/std/rms/max_abs/max_step/kurt/entropy of out
+    void update(std::span<const float> window, uint64_t totalPushed, Stats_s& out);
+
+    // per channel |x| / |step| thresholds for the counts, from the next computed hop on
+    void set_thresholds(const std::array<float, NUM_CH_CHUNK>& ampUv, const std::array<float, NUM_CH_CHUNK>& stepUv);
+
+    // scans over the thresholds in the last window (|x| > amp, |step| > step)
+    const std::array<int, NUM_CH_CHUNK>& get_amp_counts() const { return ampCount_; }
+    const std::array<int, NUM_CH_CHUNK>& get_step_counts() const { return stepCount_; }
+    std::size_t get_last_hops_computed() const { return lastHopsComputed_; } // NUM_HOPS = full recompute
+    void reset() { valid_ = false; }
+    FirSimdPath_E get_path() const { return path_; }
+
+    struct HopAgg_S {
+        std::array<double, NUM_CH_CHUNK> mean{}, m2{}, m3{}, m4{};
+        std::array<float, NUM_CH_CHUNK> maxAbs{}, maxStep{}, entryStep{}; // entryStep: from the previous hop's last scan
+        std::array<int, NUM_CH_CHUNK> ampCount{}, stepCount{};            // stepCount: inside the hop only
+        std::array<std::array<uint16_t, SQA_HIST_BINS>, NUM_CH_CHUNK> hist{};
+    };
+    // power sums of x - x[first scan], per channel
+    struct HopSums_S {
+        std::array<double, NUM_CH_CHUNK> s1{}, s2{}, s3{}, s4{};
+    };
+    // one pass over the WINDOW_HOP_SCANS scans at x: sums + maxima/counts/bins (not entryStep) of agg
+    using HopKernel_t = void (*)(const float* x, const float* ampThresh, const float* stepThresh, HopAgg_S& agg, HopSums_S& sums);
+
+private:
+
+    std::array<float, NUM_CH_CHUNK> ampThresh_{}, stepThresh_{};
+    FirSimdPath_E path_ = FirSimd_Scalar;
+    HopKernel_t kernel_ = nullptr;
+    std::array<HopAgg_S, SQA_NUM_HOPS> hops_{};  // ring, hops_[head_] = oldest hop of the window
+    std::size_t head_ = 0;
+    std::array<std::array<int, SQA_HIST_BINS>, NUM_CH_CHUNK> winHist_{};
+    std::array<double, WINDOW_SCANS + 1> cLogC_{}; // c * log(c)
+    bool valid_ = false;
+    uint64_t lastPushed_ = 0;
+    std::size_t lastHopsComputed_ = 0;
+
+    std::array<int, NUM_CH_CHUNK> ampCount_{}, stepCount_{};
+
+    // one hop at position pos (0 = oldest) of the window into agg
+    void compute_hop(std::span<const float> window, std::size_t pos, HopAgg_S& agg) const;
+    void hist_add(const HopAgg_S& agg, int sign);
+};
@@ -0,0 +1,182 @@
+#include "../src/utils/CalibExport.hpp"
+#include "../src/utils/Filters.hpp"
+#include "../src/acq/WindowConfigs.hpp"
+#include "../src/utils/Logger.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+/* SELF TEST COMPONENTS:
+1) recorder segments: contiguous chunks stay one segment; a tick jump, chunk.lost_scans > 0, or a scan
+   counter jump without lost_scans (e.g. an old recording) each start a new one; no counter (always 0) is fine
+2) export across a transport loss: windows come out of each segment on its own (count = what each segment
+   fits by itself, fewer than one unbroken segment would give), every window whole
+3) is_bad uses the online (adaptive) threshold rule: clean noise, then a 120 uV 12 Hz burst (under the fixed
+   200 uV, way over the subject's robust baseline) -> exactly the windows with the burst in them are bad
+*/
+
+// calib chunk k: tick, counter and a 10 Hz tone + slow ramp that continues through the lost scans
+static bufferChunk_S make_chunk(uint64_t tick, uint64_t firstScan, uint32_t lost) {
+    bufferChunk_S c;
+    c.tick = tick;
+    c.first_scan = firstScan;
+    c.lost_scans = lost;
+    c.ui_state = UIState_Active_Calib;
+    c.label = TestFreq_10_Hz;
+    for (std::size_t s = 0; s < NUM_SCANS_CHUNK; ++s) {
+        const double t = double(firstScan + s) / double(ACQ_FS_HZ);
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+            c.data[s * NUM_CH_CHUNK + ch] = float(20.0 * std::sin(2.0 * 3.14159265358979 * 10.0 * t) + 5.0 * t + double(ch));
+        }
+    }
+    return c;
+}
+
+static std::vector<std::size_t> seg_lens(const CalibRecording_S& rec) {
+    std::vector<std::size_t> out;
+    for (const auto& s : rec.segs) out.push_back(s.len);
+    return out;
+}
+
+static bool test_segments() {
+    const std::size_t N = NUM_SCANS_CHUNK;
+    CalibRecorder_C rec;
+    bool ok = true;
+
+    // counter jumps by 7 scans and the producer saw it (lost_scans = 7)
+    for (uint64_t k = 0; k < 10; ++k) rec.append(make_chunk(k + 1, k * N, 0));
+    for (uint64_t k = 10; k < 20; ++k) rec.append(make_chunk(k + 1, k * N + 7, k == 10 ? 7 : 0));
+    const CalibRecording_S lost = rec.take();
+    ok = ok && seg_lens(lost) == std::vector<std::size_t>{ 10 * N, 10 * N };
+
+    // counter jump with lost_scans = 0 (nobody flagged it) still splits
+    for (uint64_t k = 0; k < 10; ++k) rec.append(make_chunk(k + 1, 100 + k * N, 0));
+    for (uint64_t k = 10; k < 15; ++k) rec.append(make_chunk(k + 1, 100 + k * N + 3, 0));
+    const CalibRecording_S jumped = rec.take();
+    ok = ok && seg_lens(jumped) == std::vector<std::size_t>{ 10 * N, 5 * N };
+
+    // tick jump (chunk dropped / not recorded), no counter
+    for (uint64_t k = 0; k < 6; ++k) rec.append(make_chunk(k + 1, 0, 0));
+    for (uint64_t k = 8; k < 12; ++k) rec.append(make_chunk(k + 1, 0, 0));
+    const CalibRecording_S ticks = rec.take();
+    ok = ok && seg_lens(ticks) == std::vector<std::size_t>{ 6 * N, 4 * N };
+
+    // no counter, contiguous ticks: one segment
+    for (uint64_t k = 0; k < 12; ++k) rec.append(make_chunk(k + 1, 0, 0));
+    const CalibRecording_S plain = rec.take();
+    ok = ok && seg_lens(plain) == std::vector<std::size_t>{ 12 * N } && rec.get_num_scans() == 0;
+
+    LOG_ALWAYS("recorder segments: lost scans " << lost.segs.size() << ", unflagged counter jump " << jumped.segs.size()
+               << ", tick jump " << ticks.segs.size() << ", no counter " << plain.segs.size()
+               << " (expected 2/2/2/1)" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static std::size_t windows_in(std::size_t rawScans) {
+    const std::size_t n = rawScans / DECIMATION;
+    return n < WINDOW_SCANS ? 0 : (n - WINDOW_SCANS) / WINDOW_HOP_SCANS + 1;
+}
+
+static bool test_export_gap() {
+    const std::size_t N = NUM_SCANS_CHUNK;
+    // two stretches that each fit a few windows but not on a shared hop grid, transport loss in between
+    const std::size_t chunksA = (WINDOW_SCANS * DECIMATION) / N + 7;
+    const std::size_t chunksB = (WINDOW_SCANS * DECIMATION) / N + 5;
+    CalibRecorder_C rec;
+    uint64_t scan = 0;
+    for (std::size_t k = 0; k < chunksA; ++k, scan += N) rec.append(make_chunk(k + 1, scan, 0));
+    scan += 11; // lost
+    for (std::size_t k = 0; k < chunksB; ++k, scan += N) rec.append(make_chunk(chunksA + k + 1, scan, k == 0 ? 11 : 0));
+    const CalibRecording_S r = rec.take();
+
+    FilterCoeffSet_S set;
+    builtin_filter_coeff_set("fir_blackman_201", set);
+    const std::string path = "CalibExportSelfTest_windows.csv";
+    std::string err;
+    const long nWin = export_calib_windows(r, set, path, NUM_CH_CHUNK, 2, err);
+
+    const std::size_t expect = windows_in(chunksA * N) + windows_in(chunksB * N);
+    const std::size_t unbroken = windows_in((chunksA + chunksB) * N);
+
+    // every window in the csv is whole
+    std::map<long, std::size_t> rows;
+    {
+        std::ifstream f(path);
+        std::string line;
+        std::getline(f, line);
+        while (std::getline(f, line)) ++rows[std::atol(line.c_str())];
+    }
+    std::remove(path.c_str());
+    std::size_t partial = 0;
+    for (const auto& [idx, n] : rows) partial += n != WINDOW_SCANS;
+
+    const bool ok = r.segs.size() == 2 && nWin == long(expect) && rows.size() == expect && partial == 0 && expect < unbroken;
+    LOG_ALWAYS("export across transport loss: " << r.segs.size() << " segments, " << nWin << " windows (per segment "
+               << expect << ", one unbroken stretch would give " << unbroken << "), " << partial << " partial"
+               << (ok ? "  OK" : "  FAIL " + err));
+    return ok;
+}
+
+static bool test_adaptive_flags() {
+    const std::size_t N = NUM_SCANS_CHUNK;
+    const std::size_t nChunks = (15 * ACQ_FS_HZ) / N; // 15 s, warmup is 10
+    const std::size_t burst0 = 12 * ACQ_FS_HZ, burstLen = ACQ_FS_HZ / 5;
+    std::mt19937 rng(5);
+    std::normal_distribution<float> nd(0.0f, 10.0f);
+    CalibRecorder_C rec;
+    for (std::size_t k = 0; k < nChunks; ++k) {
+        bufferChunk_S c = make_chunk(k + 1, 0, 0);
+        for (std::size_t s = 0; s < N; ++s) {
+            const std::size_t n = k * N + s;
+            const double t = double(n) / double(ACQ_FS_HZ);
+            const float b = (n >= burst0 && n < burst0 + burstLen) ? float(120.0 * std::sin(2.0 * 3.14159265358979 * 12.0 * t)) : 0.0f;
+            for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) c.data[s * NUM_CH_CHUNK + ch] = nd(rng) + (ch == 0 ? b : 0.0f);
+        }
+        rec.append(c);
+    }
+    FilterCoeffSet_S set;
+    builtin_filter_coeff_set("fir_blackman_201", set);
+    const std::string path = "CalibExportSelfTest_flags.csv";
+    std::string err;
+    const long nWin = export_calib_windows(rec.take(), set, path, NUM_CH_CHUNK, 2, err);
+
+    // window k covers output scans [k*hop, k*hop + WINDOW_SCANS); burst (+ filter ringing) at burst0 / DECIMATION
+    const std::size_t b0 = burst0 / DECIMATION, b1 = (burst0 + burstLen) / DECIMATION;
+    std::size_t bad = 0, wrong = 0;
+    {
+        std::ifstream f(path);
+        std::string line;
+        std::getline(f, line);
+        long lastIdx = 0;
+        while (std::getline(f, line)) {
+            const long idx = std::atol(line.c_str());
+            if (idx == lastIdx) continue;
+            lastIdx = idx;
+            const bool isBad = line[line.find(',', line.find(',', line.find(',') + 1) + 1) + 1] == '1';
+            const std::size_t w0 = std::size_t(idx - 1) * WINDOW_HOP_SCANS, w1 = w0 + WINDOW_SCANS;
+            const bool hasBurst = w0 < b1 && b0 < w1;
+            bad += isBad;
+            wrong += isBad != hasBurst;
+        }
+    }
+    std::remove(path.c_str());
+    const bool ok = nWin > 0 && bad > 0 && wrong == 0;
+    LOG_ALWAYS("adaptive is_bad offline: " << bad << " of " << nWin << " windows bad (120 uV burst, fixed cap 200), "
+               << wrong << " disagree with where the burst is" << (ok ? "  OK" : "  FAIL " + err));
+    return ok;
+}
+
+int main() {
+    logger::tlabel = "CalibExportSelfTest";
+    bool ok = true;
+    ok = test_segments() && ok;
+    ok = test_export_gap() && ok;
+    ok = test_adaptive_flags() && ok;
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}
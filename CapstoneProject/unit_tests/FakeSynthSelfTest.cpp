@@ -0,0 +1,211 @@
+#include "../src/acq/FakeAcquisition.h"
+#include "../src/acq/GaussNoise.hpp"
+#include "../src/utils/Logger.hpp"
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/* SELF TEST COMPONENTS:
+1) GaussNoise_C: avx2 and scalar give the exact same stream, slicing the fills differently doesn't change it,
+   different seeds differ
+2) GaussNoise_C stats over 8M draws vs a true normal: mean, var, skew, kurtosis, tail fractions, lag-1 corr
+3) FakeAcquisition_C: same seed -> identical output; a pure oscillator (line only, no noise) keeps its
+   amplitude + frequency over ~1 h of scans (phasor recurrence doesn't drift)
+4) throughput: old per-sample std::sin + std::normal_distribution vs the block path
+*/
+
+static constexpr double PI = 3.14159265358979323846;
+
+static bool test_paths_and_slicing() {
+    const std::size_t N = 1 << 20;
+    std::vector<float> a(N), b(N), c(N);
+    GaussNoise_C scalar(1234, FirSimd_Scalar);
+    scalar.fill(a.data(), N);
+
+    bool ok = true;
+    if (fir_simd_path_supported(FirSimd_AVX2)) {
+        GaussNoise_C avx(1234, FirSimd_AVX2);
+        avx.fill(b.data(), N);
+        std::size_t diff = 0;
+        for (std::size_t i = 0; i < N; ++i) diff += (a[i] != b[i]);
+        LOG_ALWAYS("avx2 vs scalar: " << diff << " of " << N << " differ" << (diff == 0 ? "  OK" : "  FAIL"));
+        ok = ok && diff == 0;
+    } else {
+        LOG_ALWAYS("avx2 vs scalar: no avx2 on this cpu, skipped");
+    }
+
+    // odd slice sizes (chunks of 8 ch x 32 scans, 7, 1, ...) must give the same stream
+    GaussNoise_C sliced(1234);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> len(1, 300);
+    for (std::size_t off = 0; off < N;) {
+        const std::size_t n = std::min(len(rng), N - off);
+        sliced.fill(c.data() + off, n);
+        off += n;
+    }
+    std::size_t diffSliced = 0;
+    for (std::size_t i = 0; i < N; ++i) diffSliced += (a[i] != c[i]);
+
+    GaussNoise_C other(1235);
+    other.fill(b.data(), N);
+    std::size_t same = 0;
+    for (std::size_t i = 0; i < N; ++i) same += (a[i] == b[i]);
+
+    LOG_ALWAYS("sliced fills: " << diffSliced << " differ, other seed: " << same << " equal"
+               << ((diffSliced == 0 && same < 16) ? "  OK" : "  FAIL"));
+    return ok && diffSliced == 0 && same < 16;
+}
+
+static bool test_stats() {
+    const std::size_t N = 8u << 20;
+    std::vector<float> x(N);
+    GaussNoise_C g(42);
+    g.fill(x.data(), N);
+
+    double m1 = 0, m2 = 0, m3 = 0, m4 = 0, lag = 0;
+    std::size_t over2 = 0, over3 = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        const double v = x[i];
+        m1 += v; m2 += v * v; m3 += v * v * v; m4 += v * v * v * v;
+        if (i > 0) lag += v * double(x[i - 1]);
+        over2 += (std::fabs(v) > 2.0);
+        over3 += (std::fabs(v) > 3.0);
+    }
+    const double n = double(N);
+    const double mean = m1 / n;
+    const double var = m2 / n - mean * mean;
+    const double skew = (m3 / n) / std::pow(var, 1.5);
+    const double kurt = (m4 / n) / (var * var);
+    const double corr = lag / (n - 1) / var;
+    const double p2 = double(over2) / n, p3 = double(over3) / n;
+
+    // ~5 sigma bounds for N = 8M: mean 1.7e-3, var 2.5e-3, skew 4.2e-3, kurt 8.5e-3 (x2 margin), tails
+    const bool ok = std::fabs(mean) < 2e-3 && std::fabs(var - 1.0) < 3e-3 && std::fabs(skew) < 5e-3
+                 && std::fabs(kurt - 3.0) < 2e-2 && std::fabs(p2 - 0.0455003) < 4e-4
+                 && std::fabs(p3 - 0.0026998) < 1e-4 && std::fabs(corr) < 2e-3;
+    LOG_ALWAYS("stats (8M): mean=" << mean << " var=" << var << " skew=" << skew << " kurt=" << kurt
+               << " P(|z|>2)=" << p2 << " P(|z|>3)=" << p3 << " lag1=" << corr << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static FakeAcquisition_C::stimConfigs_S unpaced_cfg() {
+    FakeAcquisition_C::stimConfigs_S cfg{};
+    cfg.pacing = AcqPacing_Unpaced;
+    return cfg;
+}
+
+static bool test_fake_acq() {
+    // same seed, stim + everything on -> identical
+    auto cfg = unpaced_cfg();
+    cfg.dcDrift.enabled = cfg.alpha.enabled = cfg.beta.enabled = cfg.lineNoise.enabled = true;
+    FakeAcquisition_C a(cfg), b(cfg);
+    a.setActiveStimulus(12.0);
+    b.setActiveStimulus(12.0);
+    std::vector<float> xa(NUM_SAMPLES_CHUNK), xb(NUM_SAMPLES_CHUNK);
+    std::size_t diff = 0;
+    for (int k = 0; k < 2000; ++k) {
+        a.getData(NUM_SCANS_CHUNK, xa.data());
+        b.getData(NUM_SCANS_CHUNK, xb.data());
+        for (std::size_t i = 0; i < xa.size(); ++i) diff += (xa[i] != xb[i]);
+    }
+
+    // line only, no noise/artifacts: a pure sinusoid per channel. For x[n] = A sin(w n + p):
+    // A^2 = (x[n]^2 - x[n-1] x[n+1]) / sin^2(w), check it at the start and after ~1 h
+    auto pure = unpaced_cfg();
+    pure.noiseSigma_uV = 0.0;
+    pure.occasionalArtifactsEnabled = false;
+    pure.lineNoise.enabled = true;
+    FakeAcquisition_C p(pure);
+    const double w = 2.0 * PI * pure.lineNoise.freqHz / double(ACQ_FS_HZ);
+    auto amp2 = [&](const std::vector<float>& x, std::size_t ch) {
+        double acc = 0.0;
+        for (std::size_t n = 1; n + 1 < NUM_SCANS_CHUNK; ++n) {
+            const double xm = x[(n - 1) * NUM_CH_CHUNK + ch], x0 = x[n * NUM_CH_CHUNK + ch], xp = x[(n + 1) * NUM_CH_CHUNK + ch];
+            acc += (x0 * x0 - xm * xp) / (std::sin(w) * std::sin(w));
+        }
+        return acc / double(NUM_SCANS_CHUNK - 2);
+    };
+    std::vector<float> x(NUM_SAMPLES_CHUNK);
+    p.getData(NUM_SCANS_CHUNK, x.data());
+    std::array<double, NUM_CH_CHUNK> a0{};
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) a0[ch] = std::sqrt(amp2(x, ch));
+    const std::size_t chunks = (3600 * ACQ_FS_HZ) / NUM_SCANS_CHUNK;
+    for (std::size_t k = 0; k < chunks; ++k) p.getData(NUM_SCANS_CHUNK, x.data());
+    double worstAmp = 0.0, worstRecur = 0.0;
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        worstAmp = std::max(worstAmp, std::fabs(std::sqrt(amp2(x, ch)) - a0[ch]) / a0[ch]);
+        // frequency: x[n+1] + x[n-1] == 2 cos(w) x[n]
+        for (std::size_t n = 1; n + 1 < NUM_SCANS_CHUNK; ++n) {
+            const double r = x[(n + 1) * NUM_CH_CHUNK + ch] + x[(n - 1) * NUM_CH_CHUNK + ch] - 2.0 * std::cos(w) * x[n * NUM_CH_CHUNK + ch];
+            worstRecur = std::max(worstRecur, std::fabs(r) / a0[ch]);
+        }
+    }
+    // float output -> ~1e-6 relative is the floor
+    const bool ok = diff == 0 && worstAmp < 1e-4 && worstRecur < 1e-5;
+    LOG_ALWAYS("fake acq: same seed diff=" << diff << ", after 1 h amp drift=" << worstAmp
+               << " freq residual=" << worstRecur << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+// what synthesize_data_stream used to cost per sample: 4 sin (alpha, beta, line, ssvep + 2f) + normal_distribution
+static void bench() {
+    using clk = std::chrono::steady_clock;
+    const std::size_t nCh = NUM_CH_CHUNK;
+    const std::size_t nScans = (ACQ_FS_HZ * 600) / NUM_SCANS_CHUNK * NUM_SCANS_CHUNK; // ~10 min of data
+    std::vector<float> out(nScans * nCh);
+
+    std::mt19937 rng(1);
+    std::normal_distribution<double> nd(0.0, 1.0);
+    std::array<double, NUM_CH_CHUNK> ph{};
+    auto t0 = clk::now();
+    for (std::size_t i = 0; i < nScans; ++i) {
+        for (std::size_t ch = 0; ch < nCh; ++ch) {
+            const double p = ph[ch];
+            double v = 7.0 * std::sin(p) + 3.5 * std::sin(2.0 * p + 1.0) + 4.0 * std::sin(6.0 * p + 2.0);
+            v += 12.0 * std::sin(1.2 * p) + 4.2 * std::sin(2.4 * p);
+            v += 5.0 * nd(rng);
+            out[i * nCh + ch] = float(v);
+            ph[ch] += 0.2513;
+            if (ph[ch] > 2.0 * PI) ph[ch] -= 2.0 * PI;
+        }
+    }
+    const double oldSec = std::chrono::duration<double>(clk::now() - t0).count();
+
+    auto cfg = unpaced_cfg();
+    cfg.dcDrift.enabled = cfg.alpha.enabled = cfg.beta.enabled = cfg.lineNoise.enabled = true;
+    FakeAcquisition_C acq(cfg);
+    acq.setActiveStimulus(12.0);
+    t0 = clk::now();
+    for (std::size_t i = 0; i < nScans; i += NUM_SCANS_CHUNK) acq.getData(NUM_SCANS_CHUNK, out.data() + i * nCh);
+    const double newSec = std::chrono::duration<double>(clk::now() - t0).count();
+
+    const double n = double(nScans * nCh);
+    LOG_ALWAYS("synthesis, " << nCh << " ch: per-sample sin/normal " << 1e9 * oldSec / n << " ns/sample, "
+               << "FakeAcquisition_C " << 1e9 * newSec / n << " ns/sample (" << oldSec / newSec << "x)");
+
+    std::vector<float> g(1 << 22);
+    for (FirSimdPath_E path : { FirSimd_Scalar, FirSimd_AVX2 }) {
+        if (!fir_simd_path_supported(path)) continue;
+        GaussNoise_C gn(1, path);
+        t0 = clk::now();
+        gn.fill(g.data(), g.size());
+        const double s = std::chrono::duration<double>(clk::now() - t0).count();
+        LOG_ALWAYS("GaussNoise_C " << FirSimdPath_to_string(path) << ": " << 1e9 * s / double(g.size()) << " ns/normal");
+    }
+    t0 = clk::now();
+    for (float& v : g) v = float(nd(rng));
+    const double s = std::chrono::duration<double>(clk::now() - t0).count();
+    LOG_ALWAYS("std::normal_distribution<double>: " << 1e9 * s / double(g.size()) << " ns/normal");
+}
+
+int main() {
+    logger::tlabel = "FakeSynthSelfTest";
+    bool ok = true;
+    ok = test_paths_and_slicing() && ok;
+    ok = test_stats() && ok;
+    ok = test_fake_acq() && ok;
+    bench();
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,489 @@
+#include "../src/utils/Fft.hpp"
+#include "../src/utils/OverlapSaveFir.hpp"
+#include "../src/utils/Filters.hpp"
+#include "../src/utils/FilterCoeffs.hpp"
+#include "../src/utils/FilterDesign.hpp"
+#include "../src/utils/Logger.hpp"
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <random>
+#include <vector>
+
+/* SELF TEST COMPONENTS:
+1) RealFft_C vs a naive O(n^2) DFT, plus inverse(forward(x)) round trip
+2) OverlapSaveFir_C vs direct-form FIR (double precision reference) for a few
+   tap counts / block sizes, including the real bandpass taps (fir_blackman_201_b)
+   -> max |diff| must be within TOL of the output's peak
+3) MultiChSos_C on every supported kernel vs a double precision DF2T cascade (random sections
+   + the built-in butterworth), plus the stability check / group delay helpers
+4) coeff json parsing (good file + a few broken ones) and a live bandpass hot swap:
+   swap to 2x the built-in taps mid-stream -> output must be exactly 2x a bank that never swapped,
+   then swap to the built-in IIR and check the reported group delay dropped
+5) decimating bandpass (direct fir / fft / iir): output == every decim-th scan of the full rate output,
+   with chunk sizes that aren't multiples of decim (phase has to carry over)
+6) offline zero-phase session filter (fir + iir): a 10 Hz tone comes out with no phase shift and
+   gain |H(10)|^2, including the first/last second (no edge transient), and 1 thread == 8 threads exactly
+7) runtime bandpass design (for EEG_FS_HZ != 250): at 250 Hz it reproduces the compiled tables, at 500/1000 Hz
+   the designs keep the same passband / stopband in Hz
+8) bandpass engine choice for this build's chunk size: a long FIR only goes overlap-save when the chunk is a
+   power of two (FftFirSelfTest375 covers the 48 scan chunk build), output == direct form either way
+*/
+
+static constexpr double TOL_REL = 1e-4;
+
+static bool test_fft(std::size_t n) {
+    std::mt19937 rng(n);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    std::vector<float> x(n), back(n);
+    for (auto& v : x) v = u(rng);
+
+    RealFft_C fft(n);
+    std::vector<std::complex<float>> X(fft.num_bins());
+    fft.forward(x.data(), X.data());
+
+    double maxErr = 0.0;
+    const double pi = 3.14159265358979323846;
+    for (std::size_t k = 0; k < fft.num_bins(); ++k) {
+        std::complex<double> ref(0.0, 0.0);
+        for (std::size_t t = 0; t < n; ++t) {
+            const double a = -2.0 * pi * double(k * t) / double(n);
+            ref += double(x[t]) * std::complex<double>(std::cos(a), std::sin(a));
+        }
+        maxErr = std::max(maxErr, std::abs(ref - std::complex<double>(X[k])));
+    }
+    fft.inverse(X.data(), back.data());
+    double maxRt = 0.0;
+    for (std::size_t t = 0; t < n; ++t) maxRt = std::max(maxRt, double(std::fabs(back[t] - x[t])));
+
+    const bool ok = maxErr < 1e-4 * double(n) && maxRt < 1e-5;
+    LOG_ALWAYS("RealFft_C n=" << n << ": max|X-DFT|=" << maxErr << " roundtrip=" << maxRt << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_overlap_save(const std::vector<float>& taps, std::size_t nCh, std::size_t block, const char* name) {
+    const std::size_t nBlocks = 200;
+    const std::size_t nScans = nBlocks * block;
+    std::mt19937 rng(static_cast<unsigned>(taps.size() * 31 + block));
+    std::normal_distribution<float> noise(0.0f, 50.0f);
+
+    std::vector<float> data(nScans * nCh);
+    for (auto& v : data) v = noise(rng);
+    const std::vector<float> in = data;
+
+    OverlapSaveFir_C os;
+    os.init(taps.data(), taps.size(), nCh, block);
+    // feed one block at a time like the pipeline does
+    for (std::size_t b = 0; b < nBlocks; ++b) {
+        os.process_interleaved(data.data() + b * block * nCh, block);
+    }
+
+    double maxDiff = 0.0, peak = 0.0;
+    for (std::size_t ch = 0; ch < nCh; ++ch) {
+        for (std::size_t n = 0; n < nScans; ++n) {
+            double ref = 0.0;
+            for (std::size_t k = 0; k < taps.size() && k <= n; ++k) {
+                ref += double(taps[k]) * double(in[(n - k) * nCh + ch]);
+            }
+            peak = std::max(peak, std::fabs(ref));
+            maxDiff = std::max(maxDiff, std::fabs(ref - double(data[n * nCh + ch])));
+        }
+    }
+    const bool ok = maxDiff <= TOL_REL * peak;
+    LOG_ALWAYS("OverlapSaveFir_C " << name << " taps=" << taps.size() << " block=" << block
+               << " partitions=" << os.get_num_partitions()
+               << ": max|diff|=" << maxDiff << " (peak " << peak << ")" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+// long taps, where overlap-save wins the cost model: the engine may only pick it with power of two chunks
+// (375/625/750 Hz builds), and whichever path it took has to match direct form over whole chunks
+static bool test_engine_choice(const std::vector<float>& taps) {
+    const std::size_t nCh = NUM_CH_CHUNK;
+    const std::size_t nScans = 40 * NUM_SCANS_CHUNK;
+    std::mt19937 rng(static_cast<unsigned>(taps.size()));
+    std::normal_distribution<float> noise(0.0f, 50.0f);
+    std::vector<float> data(nScans * nCh);
+    for (auto& v : data) v = noise(rng);
+    const std::vector<float> in = data;
+
+    BandpassEngine_S bp;
+    bp.init_fir(taps.data(), taps.size());
+    for (std::size_t off = 0; off < nScans; off += NUM_SCANS_CHUNK) bp.process(data.data() + off * nCh, NUM_SCANS_CHUNK);
+
+    double maxDiff = 0.0, peak = 0.0;
+    for (std::size_t ch = 0; ch < nCh; ++ch) {
+        for (std::size_t n = 0; n < nScans; ++n) {
+            double ref = 0.0;
+            for (std::size_t k = 0; k < taps.size() && k <= n; ++k) {
+                ref += double(taps[k]) * double(in[(n - k) * nCh + ch]);
+            }
+            peak = std::max(peak, std::fabs(ref));
+            maxDiff = std::max(maxDiff, std::fabs(ref - double(data[n * nCh + ch])));
+        }
+    }
+    const bool ok = (BP_FFT_FITS_CHUNK || !bp.useFft) && maxDiff <= TOL_REL * peak;
+    LOG_ALWAYS("bandpass engine " << NUM_SCANS_CHUNK << " scan chunks, " << taps.size() << " taps: " << bp.engine_name()
+               << " max|diff|=" << maxDiff << " (peak " << peak << ")" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_sos(const std::vector<SosSection_t>& sos, std::size_t nCh, const char* name) {
+    const std::size_t nScans = 4000;
+    std::mt19937 rng(static_cast<unsigned>(sos.size() * 17 + nCh));
+    std::normal_distribution<float> noise(0.0f, 50.0f);
+    std::vector<float> in(nScans * nCh);
+    for (auto& v : in) v = noise(rng);
+
+    // reference: plain double DF2T, one channel at a time
+    std::vector<double> ref(in.begin(), in.end());
+    for (std::size_t ch = 0; ch < nCh; ++ch) {
+        for (const SosSection_t& q : sos) {
+            double z1 = 0.0, z2 = 0.0;
+            const double b0 = q[0] / double(q[3]), b1 = q[1] / double(q[3]), b2 = q[2] / double(q[3]);
+            const double a1 = q[4] / double(q[3]), a2 = q[5] / double(q[3]);
+            for (std::size_t n = 0; n < nScans; ++n) {
+                const double x = ref[n * nCh + ch];
+                const double y = b0 * x + z1;
+                z1 = b1 * x - a1 * y + z2;
+                z2 = b2 * x - a2 * y;
+                ref[n * nCh + ch] = y;
+            }
+        }
+    }
+    double peak = 0.0;
+    for (double v : ref) peak = std::max(peak, std::fabs(v));
+
+    bool ok = true;
+    for (FirSimdPath_E p : { FirSimd_Scalar, FirSimd_SSE, FirSimd_AVX2, FirSimd_NEON }) {
+        if (!fir_simd_path_supported(p)) continue;
+        MultiChSos_C iir;
+        iir.init(sos.data(), sos.size(), nCh, p);
+        std::vector<float> data = in;
+        for (std::size_t off = 0; off < nScans; off += NUM_SCANS_CHUNK) {
+            iir.process_interleaved(data.data() + off * nCh, std::min<std::size_t>(NUM_SCANS_CHUNK, nScans - off));
+        }
+        double maxDiff = 0.0;
+        for (std::size_t i = 0; i < data.size(); ++i) maxDiff = std::max(maxDiff, std::fabs(ref[i] - double(data[i])));
+        const bool okP = maxDiff <= 1e-3 * peak; // recursive -> float error accumulates a bit more than FIR
+        ok = ok && okP;
+        LOG_ALWAYS("MultiChSos_C " << name << " " << FirSimdPath_to_string(p) << " sections=" << sos.size() << " ch=" << nCh
+                   << ": max|diff|=" << maxDiff << " (peak " << peak << ")" << (okP ? "  OK" : "  FAIL"));
+    }
+    return ok;
+}
+
+static bool test_sos_helpers() {
+    const std::vector<SosSection_t> bw(iir_butter_2_sos, iir_butter_2_sos + BP_IIR_SECTIONS);
+    const double gd = sos_group_delay_samples(bw.data(), bw.size(), 10.0, 250.0);
+    const SosSection_t unstable = { 1.0f, 0.0f, 0.0f, 1.0f, -2.0f, 1.01f };
+    const SosSection_t noA0 = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    const bool ok = sos_is_stable(bw.data(), bw.size()) && !sos_is_stable(&unstable, 1) && !sos_is_stable(&noA0, 1)
+                    && gd > 1.0 && gd < 10.0;
+    LOG_ALWAYS("sos helpers: butterworth group delay @10 Hz=" << gd << " samples" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_coeff_parse() {
+    std::vector<FilterCoeffSet_S> sets;
+    std::string err;
+    bool ok = parse_filter_coeff_sets(
+        "{\"fs\": 250.0, \"sets\": ["
+        " {\"id\": \"a\", \"name\": \"x \\\"y\\\"\", \"type\": \"FIR\", \"b\": [1, -2.5e-1, 3]},"
+        " {\"id\": \"s\", \"type\": \"SOS\", \"sos\": [[1,2,1,1,-0.5,0.25],[1,0,-1,1,0.1,0.2]]}]}", sets, err);
+    ok = ok && sets.size() == 2 && sets[0].b.size() == 3 && sets[0].b[1] == -0.25f && sets[0].name == "x \"y\""
+            && sets[1].kind == FilterKind_SOS && sets[1].sos.size() == 2 && sets[1].sos[0][4] == -0.5f && sets[1].fs == 250.0;
+    for (const char* bad : { "", "{\"sets\": [ {\"id\": \"a\", \"b\": [1,]} ]}", "{\"sets\": [{\"b\": [1]}]}",
+                             "{\"sets\": [{\"id\": \"s\", \"type\": \"SOS\", \"sos\": [[1,2,3]]}]}", "{\"sets\": 3}" }) {
+        std::string e;
+        const bool parsed = parse_filter_coeff_sets(bad, sets, e);
+        ok = ok && !parsed && !e.empty();
+    }
+    LOG_ALWAYS("filter coeff json parse" << (ok ? "  OK" : "  FAIL: " + err));
+    return ok;
+}
+
+static bool test_hot_swap() {
+    const char* path = "FftFirSelfTest_coeffs.json";
+    {
+        std::ofstream f(path);
+        FilterCoeffSet_S bp;
+        builtin_filter_coeff_set("fir_blackman_201", bp);
+        f << "{\"fs\": " << FILTER_DESIGN_FS_HZ << ", \"sets\": [{\"id\": \"bp_x2\", \"type\": \"FIR\", \"b\": [";
+        f.precision(9);
+        for (std::size_t i = 0; i < bp.b.size(); ++i) f << (i ? "," : "") << 2.0f * bp.b[i];
+        f << "]}]}";
+    }
+
+    EegFilterBank_C ref, live;
+    std::mt19937 rng(11);
+    std::normal_distribution<float> noise(0.0f, 50.0f);
+    bufferChunk_S a{}, b{};
+    bool requested = false, swapped = false, ok = true;
+    std::size_t chunksSinceSwap = 0;
+    double maxDiff = 0.0;
+    for (int c = 0; c < 400 && chunksSinceSwap < 20; ++c) {
+        for (auto& v : a.data) v = noise(rng);
+        b = a;
+        if (c == 10) requested = live.request_bandpass_swap(path, "bp_x2");
+        ref.process_chunk(a);
+        live.process_chunk(b);
+        if (swapped) {
+            ++chunksSinceSwap;
+            for (std::size_t i = 0; i < a.data.size(); ++i) {
+                maxDiff = std::max(maxDiff, double(std::fabs(2.0f * a.data[i] - b.data[i])));
+            }
+        } else if (live.get_bandpass_status().swaps == 1) {
+            swapped = true; // first chunk after this one runs the new taps only
+        }
+        if (c >= 10 && !swapped) std::this_thread::sleep_for(std::chrono::milliseconds(1)); // give the loader a moment
+    }
+    const BandpassStatus_S st = live.get_bandpass_status();
+    // bad requests must leave the live filter alone
+    bool rejected = false;
+    if (live.request_bandpass_swap(path, "nope")) {
+        for (int i = 0; i < 1000 && live.get_bandpass_status().last_error.empty(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const BandpassStatus_S st2 = live.get_bandpass_status();
+        rejected = !st2.last_error.empty() && st2.active_id == "bp_x2" && st2.swaps == 1;
+    }
+    std::remove(path);
+
+    // FIR -> built-in IIR: group delay must drop from ~400 ms to ~10 ms
+    bool toIir = live.request_bandpass_swap("builtin", "iir_butter_2");
+    bufferChunk_S c{};
+    for (int i = 0; i < 400 && live.get_bandpass_status().swaps < 2; ++i) {
+        for (auto& v : c.data) v = noise(rng);
+        live.process_chunk(c);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const BandpassStatus_S st3 = live.get_bandpass_status();
+    toIir = toIir && st3.swaps == 2 && st3.group_delay_ms < 20.0 && st.group_delay_ms > 350.0;
+    LOG_ALWAYS("bandpass swap to iir: active=" << st3.active_id << " engine=" << st3.engine
+               << " group delay " << st.group_delay_ms << " -> " << st3.group_delay_ms << " ms" << (toIir ? "  OK" : "  FAIL"));
+
+    ok = requested && swapped && chunksSinceSwap == 20 && maxDiff < 1e-3 && st.active_id == "bp_x2" && rejected && toIir;
+    LOG_ALWAYS("bandpass hot swap: active=" << st.active_id << " engine=" << st.engine
+               << " max|2*ref-live| after swap=" << maxDiff << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_decimation(FilterKind_E kind, bool useFft, std::size_t decim, std::size_t chunk, const char* name) {
+    const std::size_t nCh = NUM_CH_CHUNK;
+    const std::size_t nScans = 94 * NUM_SCANS_CHUNK; // whole fft blocks
+    std::mt19937 rng(static_cast<unsigned>(decim * 100 + chunk));
+    std::normal_distribution<float> noise(0.0f, 50.0f);
+    std::vector<float> in(nScans * nCh);
+    for (auto& v : in) v = noise(rng);
+
+    FilterCoeffSet_S set;
+    builtin_filter_coeff_set(kind == FilterKind_SOS ? "iir_butter_2" : "fir_blackman_201", set);
+    BandpassEngine_S full, dec;
+    full.init(set);
+    dec.init(set);
+    full.useFft = dec.useFft = useFft && kind == FilterKind_FIR; // force the path under test
+
+    std::vector<float> ref = in;
+    for (std::size_t off = 0; off < nScans; off += NUM_SCANS_CHUNK) {
+        full.process(ref.data() + off * nCh, std::min<std::size_t>(NUM_SCANS_CHUNK, nScans - off));
+    }
+
+    // fft engine only takes whole blocks, the others get awkward chunk sizes
+    const std::size_t step = useFft ? NUM_SCANS_CHUNK : chunk;
+    std::vector<float> out;
+    std::vector<float> buf;
+    for (std::size_t off = 0; off < nScans; off += step) {
+        const std::size_t n = std::min(step, nScans - off);
+        buf.assign(in.begin() + off * nCh, in.begin() + (off + n) * nCh);
+        const std::size_t nOut = dec.process(buf.data(), n, decim);
+        out.insert(out.end(), buf.begin(), buf.begin() + nOut * nCh);
+    }
+
+    const std::size_t expected = (nScans + decim - 1) / decim;
+    double maxDiff = 0.0;
+    bool ok = out.size() == expected * nCh;
+    for (std::size_t m = 0; ok && m < expected; ++m) {
+        for (std::size_t ch = 0; ch < nCh; ++ch) {
+            maxDiff = std::max(maxDiff, double(std::fabs(out[m * nCh + ch] - ref[m * decim * nCh + ch])));
+        }
+    }
+    ok = ok && maxDiff < 1e-4;
+    LOG_ALWAYS("decimating bandpass " << name << " decim=" << decim << " chunk=" << step
+               << ": " << out.size() / nCh << "/" << expected << " scans, max|diff|=" << maxDiff << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+// complex response of a coeff set at f_hz
+static std::complex<double> response_at(const FilterCoeffSet_S& set, double f_hz) {
+    const std::complex<double> zi = std::polar(1.0, -2.0 * 3.14159265358979323846 * f_hz / FILTER_DESIGN_FS_HZ);
+    std::complex<double> h(0.0, 0.0);
+    if (set.kind == FilterKind_FIR) {
+        std::complex<double> zk(1.0, 0.0);
+        for (float b : set.b) { h += double(b) * zk; zk *= zi; }
+        return h;
+    }
+    h = 1.0;
+    for (const auto& q : set.sos) {
+        h *= (double(q[0]) + double(q[1]) * zi + double(q[2]) * zi * zi)
+           / (double(q[3]) + double(q[4]) * zi + double(q[5]) * zi * zi);
+    }
+    return h;
+}
+
+static bool test_zero_phase(const char* builtinId) {
+    const std::size_t nCh = NUM_CH_CHUNK;
+    const std::size_t nScans = 20 * ACQ_FS_HZ;
+    const double fs = FILTER_DESIGN_FS_HZ, pi = 3.14159265358979323846;
+    FilterCoeffSet_S set;
+    builtin_filter_coeff_set(builtinId, set);
+
+    // per channel: 10 Hz tone (own phase) + DC offset + slow drift (gets removed), no noise so the phase check is tight
+    std::vector<float> in(nScans * nCh);
+    for (std::size_t n = 0; n < nScans; ++n) {
+        for (std::size_t ch = 0; ch < nCh; ++ch) {
+            const double t = double(n) / fs;
+            in[n * nCh + ch] = static_cast<float>(20.0 * std::sin(2.0 * pi * 10.0 * t + 0.7 * double(ch))
+                                                  + 50.0 * double(ch) + 30.0 * std::sin(2.0 * pi * 0.1 * t));
+        }
+    }
+    // what the tone looks like after CAR (linear, so project the CAR'd input)
+    std::vector<double> car(in.size());
+    for (std::size_t n = 0; n < nScans; ++n) {
+        double m = 0.0;
+        for (std::size_t ch = 0; ch < nCh; ++ch) m += in[n * nCh + ch];
+        m /= double(nCh);
+        for (std::size_t ch = 0; ch < nCh; ++ch) car[n * nCh + ch] = in[n * nCh + ch] - m;
+    }
+
+    std::vector<float> one = in, many = in;
+    const std::size_t n1 = EegFilterBank_C::process_session_zero_phase(set, one, 1);
+    const std::size_t n8 = EegFilterBank_C::process_session_zero_phase(set, many, 8);
+    bool ok = n1 == (nScans + DECIMATION - 1) / DECIMATION && n8 == n1 && one == many;
+
+    // 10 Hz phasor over [from, to) of the output vs of the CAR'd input (output scan m = input scan m*DECIMATION)
+    const double g = std::norm(response_at(set, 10.0)); // |H|^2
+    double worstDeg = 0.0, worstGainErr = 0.0;
+    const std::size_t sec = ACQ_FS_HZ / DECIMATION;
+    for (std::size_t from : { std::size_t(0), n1 / 2, n1 - sec }) {
+        for (std::size_t ch = 0; ch < nCh; ++ch) {
+            std::complex<double> a(0.0, 0.0), b(0.0, 0.0);
+            for (std::size_t m = from; m < from + sec; ++m) {
+                const std::size_t n = m * DECIMATION;
+                const std::complex<double> e = std::polar(1.0, -2.0 * pi * 10.0 * double(n) / fs);
+                a += double(one[m * nCh + ch]) * e;
+                b += car[n * nCh + ch] * e;
+            }
+            worstDeg = std::max(worstDeg, std::fabs(std::arg(a / b)) * 180.0 / pi);
+            worstGainErr = std::max(worstGainErr, std::fabs(std::abs(a) / std::abs(b) - g) / g);
+        }
+    }
+    ok = ok && worstDeg < 3.0 && worstGainErr < 0.05; // odd padding isn't perfect for a tone, edges are off by ~2 deg
+    LOG_ALWAYS("zero-phase session " << builtinId << ": " << n1 << " scans, 10 Hz phase err<=" << worstDeg
+               << " deg, gain err<=" << 100.0 * worstGainErr << "% (|H|^2=" << g << ")"
+               << ", 1 vs 8 threads " << (one == many ? "identical" : "DIFFER") << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static std::complex<double> response_at(const std::vector<float>& b, const std::vector<SosSection_t>& sos, double f_hz, double fs) {
+    FilterCoeffSet_S set;
+    set.kind = b.empty() ? FilterKind_SOS : FilterKind_FIR;
+    set.b = b;
+    set.sos = sos;
+    // response_at() assumes the pipeline rate, rescale f so the normalized freq is right
+    return response_at(set, f_hz * FILTER_DESIGN_FS_HZ / fs);
+}
+
+static bool test_design() {
+    // 250 Hz: same as the tables from FilterDesign.py
+    const std::vector<float> fir = design_fir_bandpass(BP_FIR_LO_HZ, BP_FIR_HI_HZ, 250.0, BP_TAPS);
+    double firDiff = 0.0;
+    for (std::size_t i = 0; i < BP_TAPS; ++i) firDiff = std::max(firDiff, double(std::fabs(fir[i] - fir_blackman_201_b[i])));
+    const std::vector<SosSection_t> tbl(iir_butter_2_sos, iir_butter_2_sos + BP_IIR_SECTIONS);
+    const std::vector<SosSection_t> iir = design_butter_bandpass_sos(2, BP_IIR_LO_HZ, BP_IIR_HI_HZ, 250.0);
+    double iirDiff = 0.0; // sections are split differently than zpk2sos, so compare responses
+    for (double f = 0.5; f < 125.0; f += 0.5) {
+        const double a = std::abs(response_at({}, iir, f, 250.0)), b = std::abs(response_at({}, tbl, f, 250.0));
+        iirDiff = std::max(iirDiff, std::fabs(a - b));
+    }
+    bool ok = firDiff < 1e-6 && iirDiff < 1e-4 && iir.size() == BP_IIR_SECTIONS && sos_is_stable(iir.data(), iir.size());
+    LOG_ALWAYS("bandpass design @250 Hz: max|fir - table|=" << firDiff << " max||H_iir| - |H_table||=" << iirDiff
+               << (ok ? "  OK" : "  FAIL"));
+
+    // higher rates: ~unity at 10 Hz, iir -3 dB at its edges, fir stopband (DC, line) well down
+    for (double fs : { 500.0, 1000.0 }) {
+        const std::size_t taps = std::size_t(200.0 * fs / 250.0) + 1;
+        const std::vector<float> b = design_fir_bandpass(BP_FIR_LO_HZ, BP_FIR_HI_HZ, fs, taps);
+        const std::vector<SosSection_t> sos = design_butter_bandpass_sos(2, BP_IIR_LO_HZ, BP_IIR_HI_HZ, fs);
+        const double fir10 = std::abs(response_at(b, {}, 10.0, fs)), fir60 = std::abs(response_at(b, {}, 60.0, fs));
+        const double fir0 = std::abs(response_at(b, {}, 0.0, fs));
+        const double iir10 = std::abs(response_at({}, sos, 10.0, fs));
+        const double iirLo = std::abs(response_at({}, sos, BP_IIR_LO_HZ, fs)), iirHi = std::abs(response_at({}, sos, BP_IIR_HI_HZ, fs));
+        const bool okFs = std::fabs(fir10 - 1.0) < 1e-2 && fir60 < 1e-3 && fir0 < 1e-3
+                       && std::fabs(iir10 - 1.0) < 2e-2 && std::fabs(iirLo - M_SQRT1_2) < 1e-2 && std::fabs(iirHi - M_SQRT1_2) < 1e-2
+                       && sos_is_stable(sos.data(), sos.size());
+        LOG_ALWAYS("bandpass design @" << fs << " Hz (" << taps << " taps): fir |H| 0/10/60 Hz=" << fir0 << "/" << fir10 << "/" << fir60
+                   << ", iir |H| lo/10/hi=" << iirLo << "/" << iir10 << "/" << iirHi << (okFs ? "  OK" : "  FAIL"));
+        ok = ok && okFs;
+    }
+    return ok;
+}
+
+int main() {
+    logger::tlabel = "FftFirSelfTest";
+    bool ok = true;
+
+    for (std::size_t n : { 4, 8, 64, 256, 1024 }) {
+        ok = test_fft(n) && ok;
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> u(-0.1f, 0.1f);
+    auto random_taps = [&](std::size_t n) {
+        std::vector<float> t(n);
+        for (auto& v : t) v = u(rng);
+        return t;
+    };
+
+    const std::vector<float> bp(fir_blackman_201_b, fir_blackman_201_b + BP_TAPS);
+    ok = test_overlap_save(bp, 8, 32, "blackman") && ok;
+    ok = test_overlap_save(random_taps(21), 8, 32, "random") && ok;
+    ok = test_overlap_save(random_taps(32), 3, 32, "random") && ok;   // exactly one partition
+    ok = test_overlap_save(random_taps(1001), 8, 32, "random") && ok;
+    ok = test_overlap_save(random_taps(64), 5, 16, "random") && ok;
+    ok = test_overlap_save(random_taps(201), 8, 128, "random") && ok;
+    ok = test_overlap_save(random_taps(1), 2, 2, "random") && ok;     // degenerate: scalar gain
+
+    std::uniform_real_distribution<float> ur(-0.9f, 0.9f);
+    auto random_sos = [&](std::size_t n) {
+        std::vector<SosSection_t> v(n);
+        for (auto& q : v) {
+            // poles r*e^{+-jw}, r < 0.95 so it's stable
+            const float r = 0.5f + 0.45f * std::fabs(ur(rng)), w = 3.0f * std::fabs(ur(rng));
+            q = { ur(rng), ur(rng), ur(rng), 1.0f, -2.0f * r * std::cos(w), r * r };
+        }
+        return v;
+    };
+    ok = test_sos(std::vector<SosSection_t>(iir_butter_2_sos, iir_butter_2_sos + BP_IIR_SECTIONS), 8, "butterworth") && ok;
+    ok = test_sos(random_sos(1), 8, "random") && ok;
+    ok = test_sos(random_sos(5), 3, "random") && ok;   // padded lanes
+    ok = test_sos(random_sos(3), 16, "random") && ok;  // two AVX groups
+    ok = test_sos_helpers() && ok;
+    ok = test_engine_choice(random_taps(1001)) && ok;
+    ok = test_coeff_parse() && ok;
+    ok = test_hot_swap() && ok;
+    ok = test_decimation(FilterKind_FIR, false, 2, NUM_SCANS_CHUNK, "fir direct") && ok;
+    ok = test_decimation(FilterKind_FIR, false, 2, 7, "fir direct") && ok;
+    ok = test_decimation(FilterKind_FIR, false, 3, 32, "fir direct") && ok;
+    if (BP_FFT_FITS_CHUNK) ok = test_decimation(FilterKind_FIR, true, 2, NUM_SCANS_CHUNK, "fir fft") && ok;
+    ok = test_decimation(FilterKind_SOS, false, 2, 7, "iir") && ok;
+    ok = test_zero_phase("fir_blackman_201") && ok;
+    ok = test_zero_phase("iir_butter_2") && ok;
+    ok = test_design() && ok;
+
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+#include "../src/utils/Filters.hpp"
+#include "../src/utils/FirSimd.hpp"
+#include "../src/utils/OverlapSaveFir.hpp"
+#include "../src/utils/SosIir.hpp"
+#include "../src/utils/Types.h"
+#include "../src/utils/Logger.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+/* BENCH COMPONENTS:
+- Bandpass stage only (fir_blackman_201_b, 201 taps), 8 interleaved channels,
+  fed chunk by chunk exactly like EegFilterBank_C::process_chunk
+- Baseline: scalar FirFilter_T per channel (de-interleave -> process_block -> re-interleave)
+- Then MultiChFir_C on every kernel this CPU supports (scalar / SSE / AVX2 / NEON)
+- Then OverlapSaveFir_C (FFT, block = one chunk) so the cost model pick can be sanity checked
+- Reports ns per scan, speedup vs baseline, and max |diff| vs baseline (should be ~float eps)
+- Last: MultiChSos_C with the built-in butterworth biquads (different filter, so timing only;
+  FftFirSelfTest checks its output), and the best MultiChFir_C kernel decimating by 2 (per input scan)
+*/
+
+static constexpr std::size_t NUM_CHUNKS = 20000; // 640k scans (~43 min of EEG at 250 Hz)
+static constexpr std::size_t NS = NUM_SCANS_CHUNK;
+static constexpr std::size_t NCH = NUM_CH_CHUNK;
+
+using clk = std::chrono::steady_clock;
+
+static double run_baseline(const std::vector<float>& in, std::vector<float>& out) {
+    std::array<FirFilter_T<BP_TAPS>, NCH> fir;
+    for (auto& f : fir) f.init_from_taps(fir_blackman_201_b);
+    out = in;
+
+    auto t0 = clk::now();
+    std::array<float, NS> x{};
+    for (std::size_t c = 0; c < NUM_CHUNKS; ++c) {
+        float* chunk = out.data() + c * NS * NCH;
+        for (std::size_t ch = 0; ch < NCH; ++ch) {
+            for (std::size_t s = 0; s < NS; ++s) x[s] = chunk[s * NCH + ch];
+            fir[ch].process_block(x.data(), x.data(), NS);
+            for (std::size_t s = 0; s < NS; ++s) chunk[s * NCH + ch] = x[s];
+        }
+    }
+    auto t1 = clk::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(NUM_CHUNKS * NS);
+}
+
+static double run_simd(FirSimdPath_E path, const std::vector<float>& in, std::vector<float>& out) {
+    MultiChFir_C fir;
+    fir.init(fir_blackman_201_b, BP_TAPS, NCH, path);
+    out = in;
+
+    auto t0 = clk::now();
+    for (std::size_t c = 0; c < NUM_CHUNKS; ++c) {
+        fir.process_interleaved(out.data() + c * NS * NCH, NS);
+    }
+    auto t1 = clk::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(NUM_CHUNKS * NS);
+}
+
+static double run_fft(const std::vector<float>& in, std::vector<float>& out) {
+    OverlapSaveFir_C fir;
+    fir.init(fir_blackman_201_b, BP_TAPS, NCH, NS);
+    out = in;
+
+    auto t0 = clk::now();
+    for (std::size_t c = 0; c < NUM_CHUNKS; ++c) {
+        fir.process_interleaved(out.data() + c * NS * NCH, NS);
+    }
+    auto t1 = clk::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(NUM_CHUNKS * NS);
+}
+
+static double run_iir(FirSimdPath_E path, const std::vector<float>& in, std::vector<float>& out) {
+    MultiChSos_C iir;
+    iir.init(iir_butter_2_sos, BP_IIR_SECTIONS, NCH, path);
+    out = in;
+
+    auto t0 = clk::now();
+    for (std::size_t c = 0; c < NUM_CHUNKS; ++c) {
+        iir.process_interleaved(out.data() + c * NS * NCH, NS);
+    }
+    auto t1 = clk::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(NUM_CHUNKS * NS);
+}
+
+static double run_simd_decim(std::size_t decim, const std::vector<float>& in, std::vector<float>& out) {
+    MultiChFir_C fir;
+    fir.init(fir_blackman_201_b, BP_TAPS, NCH);
+    out = in;
+
+    auto t0 = clk::now();
+    for (std::size_t c = 0; c < NUM_CHUNKS; ++c) {
+        fir.process_interleaved_decim(out.data() + c * NS * NCH, NS, decim);
+    }
+    auto t1 = clk::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(NUM_CHUNKS * NS);
+}
+
+int main() {
+    logger::tlabel = "FilterBench";
+
+    // fake EEG-ish input: 50 uV noise + a 10 Hz sine, different per channel
+    std::vector<float> in(NUM_CHUNKS * NS * NCH);
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> noise(0.0f, 50.0f);
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        const std::size_t scan = i / NCH, ch = i % NCH;
+        in[i] = noise(rng) + 20.0f * std::sin(2.0f * 3.14159265f * 10.0f * float(scan) / 250.0f + float(ch));
+    }
+
+    std::vector<float> ref, out;
+    const double nsBase = run_baseline(in, ref);
+    LOG_ALWAYS("FilterBench: " << NUM_CHUNKS * NS << " scans x " << NCH << " ch, " << BP_TAPS << " taps");
+    LOG_ALWAYS("FirFilter_T x" << NCH << " (scalar baseline): " << std::fixed << std::setprecision(1) << nsBase << " ns/scan");
+
+    bool ok = true;
+    auto report = [&](const char* name, double ns) {
+        double maxDiff = 0.0;
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            maxDiff = std::max(maxDiff, double(std::fabs(out[i] - ref[i])));
+        }
+        const bool okP = maxDiff < 1e-3; // uV; summation order differs from the baseline
+        ok = ok && okP;
+        LOG_ALWAYS(std::left << std::setw(20) << name << std::right
+                   << std::fixed << std::setprecision(1) << ns << " ns/scan"
+                   << "  speedup " << std::setprecision(2) << (nsBase / ns) << "x"
+                   << "  max|diff| " << std::scientific << std::setprecision(2) << maxDiff
+                   << (okP ? "" : "  MISMATCH"));
+    };
+
+    for (FirSimdPath_E p : { FirSimd_Scalar, FirSimd_SSE, FirSimd_AVX2, FirSimd_NEON }) {
+        if (!fir_simd_path_supported(p)) {
+            LOG_ALWAYS("MultiChFir_C " << FirSimdPath_to_string(p) << ": not supported here, skipped");
+            continue;
+        }
+        const double ns = run_simd(p, in, out);
+        report((std::string("MultiChFir_C ") + FirSimdPath_to_string(p)).c_str(), ns);
+    }
+    report("OverlapSaveFir_C", run_fft(in, out));
+
+    for (FirSimdPath_E p : { FirSimd_Scalar, FirSimd_SSE, FirSimd_AVX2, FirSimd_NEON }) {
+        if (!fir_simd_path_supported(p)) continue;
+        const double ns = run_iir(p, in, out);
+        LOG_ALWAYS(std::left << std::setw(20) << (std::string("MultiChSos_C ") + FirSimdPath_to_string(p)) << std::right
+                   << std::fixed << std::setprecision(1) << ns << " ns/scan"
+                   << "  speedup " << std::setprecision(2) << (nsBase / ns) << "x"
+                   << "  (" << BP_IIR_SECTIONS << " biquads)");
+    }
+    const double nsDecim = run_simd_decim(2, in, out);
+    LOG_ALWAYS(std::left << std::setw(20) << "MultiChFir_C dec2" << std::right
+               << std::fixed << std::setprecision(1) << nsDecim << " ns/input scan"
+               << "  speedup " << std::setprecision(2) << (nsBase / nsDecim) << "x"
+               << "  (" << FirSimdPath_to_string(fir_simd_detect_best_path()) << ", every 2nd output)");
+    LOG_ALWAYS("runtime pick: " << FirSimdPath_to_string(fir_simd_detect_best_path()));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#include "../src/utils/LatencyStats.hpp"
+#include "../src/utils/Logger.hpp"
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+
+/* SELF TEST COMPONENTS:
+1) empty histogram: count 0, every percentile 0
+2) uniform 0.5 .. 999.5 ms, one sample per 1 ms bin: p50 = 500, p99 = 990, p0 = 1, p100 = 1000 (upper bin edges)
+3) overflow bin: 90 samples at 5.2 ms + 10 way past the last edge (8.2 s, 1e9 ms): p50 = 6, p90 still 6,
+   p99 lands in the last bin (NUM_BINS), negative / zero go to the first bin
+4) reset(): back to empty
+5) sample ages under paced fake/replay (speed 1, 4, 20): chunk stamped the way the producer does, newest scan
+   stamp + filter delay + window span in wall ms -> a decision right at hand-over sees ages >= 0 that match
+   the declared spans / speed (device-time scan spacing put the newest stamp ~93 ms in the future at x4)
+*/
+
+static bool test_empty(const LatencyHistogram_C& h) {
+    const bool ok = h.get_count() == 0 && h.percentile(0.0) == 0.0 && h.percentile(0.5) == 0.0 && h.percentile(1.0) == 0.0;
+    LOG_ALWAYS("empty: count " << h.get_count() << ", p50 " << h.percentile(0.5) << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_uniform(LatencyHistogram_C& h) {
+    for (std::size_t i = 0; i < 1000; ++i) h.add(double(i) + 0.5);
+    const double p0 = h.percentile(0.0), p50 = h.percentile(0.5), p99 = h.percentile(0.99), p100 = h.percentile(1.0);
+    const bool ok = h.get_count() == 1000 && p0 == 1.0 && p50 == 500.0 && p99 == 990.0 && p100 == 1000.0;
+    LOG_ALWAYS("uniform 0..1000 ms: p0 " << p0 << ", p50 " << p50 << ", p99 " << p99 << ", p100 " << p100
+               << " (expected 1/500/990/1000)" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_overflow(LatencyHistogram_C& h) {
+    constexpr double LAST = double(LatencyHistogram_C::NUM_BINS);
+    for (int i = 0; i < 90; ++i) h.add(5.2);
+    for (int i = 0; i < 5; ++i) h.add(LAST + 10.0);
+    for (int i = 0; i < 5; ++i) h.add(1e9);
+    const double p50 = h.percentile(0.5), p90 = h.percentile(0.9), p99 = h.percentile(0.99);
+
+    LatencyHistogram_C low;
+    low.add(-3.0);
+    low.add(0.0);
+    const bool okLow = low.percentile(1.0) == 1.0;
+
+    const bool ok = h.get_count() == 100 && p50 == 6.0 && p90 == 6.0 && p99 == LAST && okLow;
+    LOG_ALWAYS("overflow: p50 " << p50 << ", p90 " << p90 << ", p99 " << p99 << " (last bin " << LAST
+               << "), <= 0 in first bin " << okLow << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_paced_ages(double speed) {
+    // 250 Hz, 32 scan chunks, 201 tap FIR, 1 s window, no transport delay
+    const double scanMs = 4.0, chunkFillMs = 31.0 * scanMs, filterMs = 400.0, windowMs = 249.0 * scanMs;
+    const double tReady = 10000.0;
+    const double epoch = tReady - 0.0 - device_to_wall_ms(chunkFillMs, speed); // producer stamp, first scan
+    const double newest = scan_stamp_ms(epoch, 31, device_to_wall_ms(scanMs, speed));
+    const SampleAges_S a = sample_ages_ms(tReady, newest, device_to_wall_ms(filterMs, speed), device_to_wall_ms(windowMs, speed));
+    const bool ok = a.newest_ms >= 0.0 && a.oldest_ms >= a.newest_ms && std::fabs(newest - tReady) < 1e-9
+                 && std::fabs(a.newest_ms - filterMs / speed) < 1e-9 && std::fabs(a.oldest_ms - (filterMs + windowMs) / speed) < 1e-9;
+    LOG_ALWAYS("paced ages x" << speed << ": newest stamp " << (newest - tReady) << " ms vs hand-over, age newest "
+               << a.newest_ms << " / oldest " << a.oldest_ms << " ms" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+int main() {
+    logger::tlabel = "LatencyStatsSelfTest";
+    static LatencyHistogram_C h; // 32 KB of bins, keep it off the stack
+    bool ok = true;
+    ok = test_empty(h) && ok;
+    ok = test_uniform(h) && ok;
+    h.reset();
+    ok = test_empty(h) && ok;
+    ok = test_overflow(h) && ok;
+    for (double speed : { 1.0, 4.0, 20.0 }) ok = test_paced_ages(speed) && ok;
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}
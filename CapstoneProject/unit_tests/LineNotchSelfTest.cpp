@@ -0,0 +1,109 @@
+#include "../src/utils/LineNotch.hpp"
+#include "../src/utils/Logger.hpp"
+#include <cmath>
+#include <complex>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+/* SELF TEST COMPONENTS:
+Synthetic 8 ch @ 250 Hz: noise + 10 Hz "SSVEP" + mains at an off-nominal frequency with a 2nd harmonic,
+per-channel line amplitude/phase. Feed it chunk by chunk like the pipeline, then over the last few seconds:
+1) tracked f0 must land on the true mains freq (nominal 60 / 50, true 60.4 / 49.7)
+2) line left in the output (output - the line-free input, projected at the exact freq) >= 30 dB down.
+   The notch also eats the noise inside its ~0.4 Hz band, which shows up here too, so the weak line in
+   10 uV noise only has to clear a lower bar
+3) 10 Hz component untouched (within 0.3 dB, noise in the measurement)
+4) reported residual line power is small vs the line power we put in; reported line amplitude ~ true
+5) no mains at all -> f0 stays put, output == input-ish (nothing to cancel)
+*/
+
+static constexpr double FS = 250.0;
+static constexpr std::size_t NCH = 8;
+static constexpr std::size_t CHUNK = 32;
+static constexpr double PI = 3.14159265358979323846;
+
+// |amplitude| of the f_hz component of x[ch] over [from, to) (least-squares sin/cos projection)
+static double amp_at(const std::vector<float>& x, std::size_t ch, double f_hz, std::size_t from, std::size_t to) {
+    std::complex<double> acc(0.0, 0.0);
+    for (std::size_t n = from; n < to; ++n) {
+        acc += double(x[n * NCH + ch]) * std::polar(1.0, -2.0 * PI * f_hz * double(n) / FS);
+    }
+    return 2.0 * std::abs(acc) / double(to - from);
+}
+
+static bool run_case(double nominal, double trueHz, double lineUv, float noiseUv, double minAttenDb, const char* name) {
+    const std::size_t seconds = 30;
+    const std::size_t nScans = static_cast<std::size_t>(seconds * FS) / CHUNK * CHUNK;
+    std::mt19937 rng(static_cast<unsigned>(trueHz * 100));
+    std::normal_distribution<float> noise(0.0f, noiseUv);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+
+    std::vector<double> gain(NCH), phase(NCH);
+    for (std::size_t ch = 0; ch < NCH; ++ch) { gain[ch] = 0.7 + 0.6 * u(rng); phase[ch] = 2.0 * PI * u(rng); }
+
+    std::vector<float> in(nScans * NCH), clean(nScans * NCH);
+    for (std::size_t n = 0; n < nScans; ++n) {
+        const double t = double(n) / FS;
+        for (std::size_t ch = 0; ch < NCH; ++ch) {
+            double v = noise(rng) + 5.0 * std::sin(2.0 * PI * 10.0 * t + double(ch));
+            clean[n * NCH + ch] = static_cast<float>(v);
+            v += lineUv * gain[ch] * std::sin(2.0 * PI * trueHz * t + phase[ch]);
+            v += 0.3 * lineUv * gain[ch] * std::sin(2.0 * PI * 2.0 * trueHz * t + 2.0 * phase[ch]);
+            in[n * NCH + ch] = static_cast<float>(v);
+        }
+    }
+    std::vector<float> out = in;
+    std::vector<float> left(out.size()); // line that made it through
+
+    AdaptiveLineNotch_C notch;
+    notch.init(nominal, 4, FS, NCH); // asks for 4, only 2 fit under nyquist
+    for (std::size_t off = 0; off < nScans; off += CHUNK) {
+        notch.process_interleaved(out.data() + off * NCH, CHUNK);
+    }
+
+    for (std::size_t i = 0; i < out.size(); ++i) left[i] = out[i] - clean[i];
+    const std::size_t from = nScans - static_cast<std::size_t>(5 * FS); // last 5 s
+    double worstAttenDb = 1e9, worstSsvepDb = 0.0, maxResidual = 0.0, worstAmpErr = 0.0;
+    for (std::size_t ch = 0; ch < NCH; ++ch) {
+        if (lineUv > 0.0) {
+            const double a_in = amp_at(in, ch, trueHz, from, nScans);
+            const double a_out = amp_at(left, ch, trueHz, from, nScans);
+            worstAttenDb = std::min(worstAttenDb, 20.0 * std::log10(a_in / a_out));
+            const double lineRms = lineUv * gain[ch] * std::sqrt(0.5 * (1.0 + 0.09));
+            worstAmpErr = std::max(worstAmpErr, std::fabs(notch.get_line_uv_rms(ch) - lineRms) / lineRms);
+        }
+        const double s_in = amp_at(in, ch, 10.0, from, nScans);
+        const double s_out = amp_at(out, ch, 10.0, from, nScans);
+        worstSsvepDb = std::max(worstSsvepDb, std::fabs(20.0 * std::log10(s_out / s_in)));
+        maxResidual = std::max(maxResidual, double(notch.get_residual_uv2(ch)));
+    }
+
+    const double fErr = std::fabs(notch.get_freq_hz() - trueHz);
+    bool ok = notch.get_num_harmonics() == 2 && worstSsvepDb < 0.3;
+    if (lineUv > 0.0) {
+        const double linePower = 0.5 * lineUv * lineUv;
+        ok = ok && fErr < 0.05 && worstAttenDb >= minAttenDb && maxResidual < 0.05 * linePower && worstAmpErr < 0.15;
+    } else {
+        ok = ok && std::fabs(notch.get_freq_hz() - nominal) < 1e-9 && maxResidual < 1.0;
+    }
+    LOG_ALWAYS(name << ": f0 " << nominal << " -> " << notch.get_freq_hz() << " Hz (true " << trueHz << ")"
+               << " harmonics=" << notch.get_num_harmonics()
+               << " line atten>=" << worstAttenDb << " dB"
+               << " ssvep change<=" << worstSsvepDb << " dB"
+               << " residual<=" << maxResidual << " uV^2"
+               << " line amp err<=" << 100.0 * worstAmpErr << "%"
+               << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+int main() {
+    logger::tlabel = "LineNotchSelfTest";
+    bool ok = true;
+    ok = run_case(60.0, 60.4, 20.0, 2.0f,  30.0, "60 Hz mains, off by +0.4") && ok;
+    ok = run_case(50.0, 49.7, 20.0, 2.0f,  30.0, "50 Hz mains, off by -0.3") && ok;
+    ok = run_case(60.0, 60.0, 4.0,  10.0f, 10.0, "60 Hz mains, weak (FakeAcq level)") && ok;
+    ok = run_case(60.0, 60.0, 0.0,  10.0f, 0.0,  "no mains") && ok;
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+#include "../src/acq/ReplayAcquisition.h"
+#include "../src/acq/FakeAcquisition.h"
+#include "../src/acq/WindowConfigs.hpp"
+#include "../src/utils/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+/* SELF TEST COMPONENTS:
+1) record FakeAcquisition_C chunks + changing labels + jittered hand-over times + a scan counter with one
+   transport gap to an .eegrec, load it back and replay it (unpaced): every sample, label, timestamp and
+   counter identical (get_scan_counter too), runs dry at the end, loops if asked (counter keeps counting)
+2) recorder killed mid chunk -> the complete chunks still load; an old EEGREC01 file (no counter) loads
+   with first_scan / lost_scans 0 and replay says it has no counter
+3) eeg_windows.csv style input (overlapping windows, one gap): stitched back into the original stream,
+   2 segments, labels per chunk
+4) pacing: speed x4 replay hands chunks out at the recorded times / 4 (jitter included)
+5) recordings that don't fit the build (rate, channels) are refused
+6) csv rate: fs_hz column wins, else rows per (trimmed) window / per chunk_tick; a csv at another rate
+   (e.g. from an EEG_DECIMATION=2 build) loads with that rate and replay refuses it; fs_hz changing is an error
+*/
+
+static const std::size_t N_CHUNKS = 300;
+static const uint64_t COUNTER_BASE = 5000; // device counter of the first scan
+static const std::size_t GAP_CHUNK = 100;  // 7 scans lost right before this one
+static const uint32_t GAP_SCANS = 7;
+
+static uint64_t counter_for(std::size_t k) {
+    return COUNTER_BASE + k * NUM_SCANS_CHUNK + (k >= GAP_CHUNK ? GAP_SCANS : 0);
+}
+
+static UIState_E state_for(std::size_t k) {
+    static const UIState_E states[] = { UIState_Instructions, UIState_Active_Calib, UIState_NoSSVEP_Test, UIState_Home };
+    return states[(k / 50) % 4];
+}
+static TestFreq_E label_for(std::size_t k) {
+    const UIState_E s = state_for(k);
+    if (s == UIState_Active_Calib) return (k / 50) % 2 ? TestFreq_12_Hz : TestFreq_10_Hz;
+    return s == UIState_NoSSVEP_Test ? TestFreq_NoSSVEP : TestFreq_None;
+}
+
+// fake data + the times it "arrived" (nominal + a few ms of jitter)
+static void make_session(std::vector<float>& data, std::vector<double>& tMs) {
+    FakeAcquisition_C::stimConfigs_S cfg{};
+    cfg.pacing = AcqPacing_Unpaced;
+    cfg.alpha.enabled = cfg.lineNoise.enabled = true;
+    FakeAcquisition_C fake(cfg);
+    data.resize(N_CHUNKS * NUM_SAMPLES_CHUNK);
+    tMs.resize(N_CHUNKS);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> jit(-8.0, 8.0);
+    const double chunkMs = 1000.0 * double(NUM_SCANS_CHUNK) / double(ACQ_FS_HZ);
+    for (std::size_t k = 0; k < N_CHUNKS; ++k) {
+        fake.setActiveStimulus(label_for(k) == TestFreq_12_Hz ? 12.0 : 0.0);
+        fake.getData(NUM_SCANS_CHUNK, data.data() + k * NUM_SAMPLES_CHUNK);
+        tMs[k] = chunkMs * double(k + 1) + (k ? jit(rng) : 0.0);
+    }
+}
+
+static bool write_session(const std::string& path, const std::vector<float>& data, const std::vector<double>& tMs) {
+    AcqRecorder_C rec;
+    std::string err;
+    if (!rec.open(path, NUM_CH_CHUNK, NUM_SCANS_CHUNK, double(ACQ_FS_HZ), err)) {
+        LOG_ALWAYS("recorder open failed: " << err);
+        return false;
+    }
+    for (std::size_t k = 0; k < N_CHUNKS; ++k) {
+        rec.append(data.data() + k * NUM_SAMPLES_CHUNK, NUM_SCANS_CHUNK, k + 1, tMs[k], counter_for(k),
+                   k == GAP_CHUNK ? GAP_SCANS : 0, state_for(k), label_for(k),
+                   label_for(k) == TestFreq_12_Hz ? 12 : (label_for(k) == TestFreq_10_Hz ? 10 : 0));
+    }
+    return rec.get_num_chunks() == N_CHUNKS;
+}
+
+static bool test_binary(const std::vector<float>& data, const std::vector<double>& tMs) {
+    const std::string path = "ReplaySelfTest.eegrec";
+    bool ok = write_session(path, data, tMs);
+
+    ReplayAcquisition_C::replayConfigs_S cfg{};
+    cfg.path = path;
+    cfg.pacing = AcqPacing_Unpaced;
+    ReplayAcquisition_C replay(cfg);
+    ok = ok && replay.unicorn_init() && replay.getNumChannels() == int(NUM_CH_CHUNK) && replay.get_num_chunks() == N_CHUNKS;
+
+    std::vector<float> x(NUM_SAMPLES_CHUNK);
+    std::size_t dataDiff = 0, metaDiff = 0, counterDiff = 0;
+    for (std::size_t k = 0; ok && k < N_CHUNKS; ++k) {
+        if (!replay.getData(NUM_SCANS_CHUNK, x.data())) { ok = false; break; }
+        dataDiff += std::memcmp(x.data(), data.data() + k * NUM_SAMPLES_CHUNK, x.size() * sizeof(float)) != 0;
+        const AcqRecChunk_S& m = replay.get_chunk_meta();
+        metaDiff += m.tick != k + 1 || m.t_ms != tMs[k] || m.ui_state != state_for(k) || m.label != label_for(k);
+        uint64_t counter = 0;
+        counterDiff += !replay.get_scan_counter(counter) || counter != counter_for(k) || m.first_scan != counter_for(k)
+                       || m.lost_scans != (k == GAP_CHUNK ? GAP_SCANS : 0);
+    }
+    const bool dry = !replay.getData(NUM_SCANS_CHUNK, x.data());
+
+    cfg.loop = true;
+    ReplayAcquisition_C looped(cfg);
+    bool wrapped = looped.unicorn_init();
+    for (std::size_t k = 0; wrapped && k <= N_CHUNKS; ++k) wrapped = looped.getData(NUM_SCANS_CHUNK, x.data());
+    uint64_t wrappedCounter = 0;
+    wrapped = wrapped && std::memcmp(x.data(), data.data(), x.size() * sizeof(float)) == 0 && looped.get_chunk_meta().tick == 1
+              && looped.get_scan_counter(wrappedCounter) && wrappedCounter == counter_for(N_CHUNKS - 1) + NUM_SCANS_CHUNK;
+    std::remove(path.c_str());
+
+    ok = ok && dataDiff == 0 && metaDiff == 0 && counterDiff == 0 && dry && wrapped;
+    LOG_ALWAYS("eegrec round trip: " << N_CHUNKS << " chunks, data diff=" << dataDiff << " meta diff=" << metaDiff
+               << " counter diff=" << counterDiff
+               << ", dry at end " << (dry ? "yes" : "NO") << ", loop " << (wrapped ? "yes" : "NO") << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_truncated(const std::vector<float>& data, const std::vector<double>& tMs) {
+    const std::string path = "ReplaySelfTest_trunc.eegrec";
+    bool ok = write_session(path, data, tMs);
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 100); // last chunk cut short
+    AcqRecording_S rec;
+    std::string err;
+    ok = ok && load_acq_recording(path, rec, err) && rec.chunks.size() == N_CHUNKS - 1
+            && std::memcmp(rec.data.data(), data.data(), rec.data.size() * sizeof(float)) == 0;
+    std::remove(path.c_str());
+    LOG_ALWAYS("truncated eegrec: " << rec.chunks.size() << " complete chunks kept" << (ok ? "  OK" : "  FAIL: " + err));
+    return ok;
+}
+
+// what AcqRecorder_C wrote before the counter fields
+static bool test_v1(const std::vector<float>& data, const std::vector<double>& tMs) {
+    const std::string path = "ReplaySelfTest_v1.eegrec";
+    const std::size_t n = 20;
+    {
+        std::ofstream f(path, std::ios::binary);
+        auto put = [&f](const auto& v) { f.write(reinterpret_cast<const char*>(&v), sizeof(v)); };
+        f.write(ACQ_REC_MAGIC_V1, sizeof(ACQ_REC_MAGIC_V1));
+        put(static_cast<uint32_t>(NUM_CH_CHUNK));
+        put(static_cast<uint32_t>(NUM_SCANS_CHUNK));
+        put(double(ACQ_FS_HZ));
+        for (std::size_t k = 0; k < n; ++k) {
+            put(static_cast<uint64_t>(k + 1));
+            put(tMs[k]);
+            put(static_cast<uint8_t>(state_for(k)));
+            put(static_cast<uint8_t>(label_for(k)));
+            put(static_cast<int16_t>(0));
+            put(static_cast<uint32_t>(NUM_SCANS_CHUNK));
+            f.write(reinterpret_cast<const char*>(data.data() + k * NUM_SAMPLES_CHUNK), NUM_SAMPLES_CHUNK * sizeof(float));
+        }
+    }
+    AcqRecording_S rec;
+    std::string err;
+    bool ok = load_acq_recording(path, rec, err) && rec.chunks.size() == n && !rec.hasCounter
+              && std::memcmp(rec.data.data(), data.data(), n * NUM_SAMPLES_CHUNK * sizeof(float)) == 0;
+    for (std::size_t k = 0; ok && k < n; ++k) {
+        const AcqRecChunk_S& c = rec.chunks[k];
+        ok = c.first_scan == 0 && c.lost_scans == 0 && c.t_ms == tMs[k] && c.label == label_for(k);
+    }
+    ReplayAcquisition_C::replayConfigs_S cfg{};
+    cfg.pacing = AcqPacing_Unpaced;
+    ReplayAcquisition_C replay(cfg, rec);
+    std::vector<float> x(NUM_SAMPLES_CHUNK);
+    uint64_t counter = 0;
+    ok = ok && replay.getData(NUM_SCANS_CHUNK, x.data()) && !replay.get_scan_counter(counter);
+    std::remove(path.c_str());
+    LOG_ALWAYS("EEGREC01 file: " << rec.chunks.size() << " chunks, no counter" << (ok ? "  OK" : "  FAIL: " + err));
+    return ok;
+}
+
+static bool test_csv_windows(const std::vector<float>& data) {
+    // csv stores what operator<< prints -> compare against the same rounding
+    std::vector<float> sig(data.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        std::ostringstream o;
+        o << data[i];
+        sig[i] = std::strtof(o.str().c_str(), nullptr);
+    }
+    const std::size_t nScans = sig.size() / NUM_CH_CHUNK;
+    // two runs of windows with a gap in between (like a ui change dropping windows)
+    const std::size_t seg1End = nScans / 2, seg2Start = seg1End + 3 * WINDOW_HOP_SCANS;
+    const std::string path = "ReplaySelfTest_windows.csv";
+    std::vector<float> expect;
+    std::vector<TestFreq_E> expectLabel;
+    {
+        std::ofstream f(path);
+        f << "window_idx,ui_state,is_trimmed,is_bad,sample_idx";
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) f << ",eeg" << (ch + 1);
+        f << ",testfreq_e,testfreq_hz\n";
+        std::size_t idx = 0;
+        for (auto [from, to] : { std::pair<std::size_t, std::size_t>{ 0, seg1End }, { seg2Start, nScans } }) {
+            const TestFreq_E lb = from == 0 ? TestFreq_10_Hz : TestFreq_12_Hz;
+            std::size_t last = from;
+            for (std::size_t w0 = from; w0 + WINDOW_SCANS <= to; w0 += WINDOW_HOP_SCANS) {
+                ++idx;
+                for (std::size_t s = 0; s < WINDOW_SCANS; ++s) {
+                    f << idx << "," << int(UIState_Active_Calib) << ",0,0," << s;
+                    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) f << "," << data[(w0 + s) * NUM_CH_CHUNK + ch];
+                    f << "," << int(lb) << "," << TestFreqEnumToInt(lb) << "\n";
+                }
+                last = w0 + WINDOW_SCANS;
+            }
+            expect.insert(expect.end(), sig.begin() + from * NUM_CH_CHUNK, sig.begin() + last * NUM_CH_CHUNK);
+            expectLabel.insert(expectLabel.end(), last - from, lb);
+        }
+    }
+    AcqRecording_S rec;
+    std::string err;
+    bool ok = load_acq_recording(path, rec, err);
+    std::remove(path.c_str());
+    const std::size_t whole = (expect.size() / NUM_SAMPLES_CHUNK) * NUM_SAMPLES_CHUNK;
+    std::size_t labelDiff = 0;
+    for (const AcqRecChunk_S& c : rec.chunks) labelDiff += c.label != expectLabel[c.firstScan] || c.ui_state != UIState_Active_Calib;
+    ok = ok && rec.nCh == NUM_CH_CHUNK && !rec.hasTiming && rec.segments == 2 && rec.data.size() == whole
+            && rec.fs == double(PIPELINE_FS_HZ)
+            && std::memcmp(rec.data.data(), expect.data(), whole * sizeof(float)) == 0 && labelDiff == 0;
+    LOG_ALWAYS("csv windows: " << rec.num_scans() << " scans stitched (" << rec.segments << " segments, expected "
+               << whole / NUM_CH_CHUNK << "), label diff=" << labelDiff << (ok ? "  OK" : "  FAIL: " + err));
+    return ok;
+}
+
+static bool test_pacing(const std::vector<float>& data, const std::vector<double>& tMs) {
+    using clk = std::chrono::steady_clock;
+    const std::size_t n = 25;
+    const double speed = 4.0;
+    AcqRecording_S rec;
+    rec.nCh = NUM_CH_CHUNK;
+    rec.fs = double(ACQ_FS_HZ);
+    rec.hasTiming = true;
+    rec.data.assign(data.begin(), data.begin() + n * NUM_SAMPLES_CHUNK);
+    for (std::size_t k = 0; k < n; ++k) {
+        AcqRecChunk_S c;
+        c.firstScan = k * NUM_SCANS_CHUNK;
+        c.nScans = NUM_SCANS_CHUNK;
+        c.tick = k + 1;
+        c.t_ms = tMs[k];
+        rec.chunks.push_back(c);
+    }
+    ReplayAcquisition_C::replayConfigs_S cfg{};
+    cfg.pacing = AcqPacing_Speed;
+    cfg.speed = speed;
+    ReplayAcquisition_C replay(cfg, rec);
+    std::vector<float> x(NUM_SAMPLES_CHUNK);
+    replay.getData(NUM_SCANS_CHUNK, x.data());
+    const auto t0 = clk::now();
+    std::vector<double> dev;
+    for (std::size_t k = 1; k < n; ++k) {
+        replay.getData(NUM_SCANS_CHUNK, x.data());
+        const double gotMs = std::chrono::duration<double, std::milli>(clk::now() - t0).count();
+        dev.push_back(std::fabs(gotMs - (tMs[k] - tMs[0]) / speed));
+    }
+    // a single missed wakeup on a loaded box can cost several ms -> judge pacing on the median,
+    // the max only has to catch drift / no pacing at all (that's hundreds of ms by the last chunk)
+    std::sort(dev.begin(), dev.end());
+    const double med = dev[dev.size() / 2], worst = dev.back();
+    const bool ok = med < 2.0 && worst < 30.0;
+    LOG_ALWAYS("pacing x" << speed << ": |handed out - recorded/speed| median " << med << " ms, worst " << worst
+               << " ms over " << n << " chunks" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_mismatch() {
+    AcqRecording_S rec;
+    rec.nCh = NUM_CH_CHUNK;
+    rec.fs = 2.0 * double(ACQ_FS_HZ);
+    rec.data.assign(NUM_SAMPLES_CHUNK, 0.0f);
+    rec.chunks.push_back(AcqRecChunk_S{ 0, NUM_SCANS_CHUNK });
+    ReplayAcquisition_C::replayConfigs_S cfg{};
+    cfg.pacing = AcqPacing_Unpaced;
+    ReplayAcquisition_C wrongRate(cfg, rec);
+    rec.fs = double(ACQ_FS_HZ);
+    rec.nCh = NUM_CH_CHUNK + 1;
+    ReplayAcquisition_C tooWide(cfg, rec);
+    std::vector<float> x(NUM_SAMPLES_CHUNK);
+    const bool ok = !wrongRate.unicorn_init() && !tooWide.unicorn_init() && !wrongRate.getData(NUM_SCANS_CHUNK, x.data());
+    LOG_ALWAYS("mismatched recordings refused" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+// nGroups groups (windows or chunk ticks) of groupLen rows each; fsCol < 0 = no fs_hz column
+static bool load_csv_rate(const std::string& groupCol, std::size_t nGroups, std::size_t groupLen, bool trimmed,
+                          double fsCol, double fsColLater, AcqRecording_S& rec, std::string& err) {
+    const std::string path = "ReplaySelfTest_rate.csv";
+    {
+        std::ofstream f(path);
+        f << groupCol << ",is_trimmed,sample_idx";
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) f << ",eeg" << (ch + 1);
+        f << ",testfreq_e,testfreq_hz" << (fsCol > 0.0 ? ",fs_hz" : "") << "\n";
+        for (std::size_t g = 0; g < nGroups; ++g) {
+            for (std::size_t s = 0; s < groupLen; ++s) {
+                f << (g + 1) << "," << (trimmed ? 1 : 0) << "," << s;
+                for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) f << "," << float(g * groupLen + s + ch);
+                f << "," << int(TestFreq_10_Hz) << ",10";
+                if (fsCol > 0.0) f << "," << (g + 1 == nGroups ? fsColLater : fsCol);
+                f << "\n";
+            }
+        }
+    }
+    const bool ok = load_acq_recording(path, rec, err);
+    std::remove(path.c_str());
+    return ok;
+}
+
+static bool test_csv_rate() {
+    const double fs = double(PIPELINE_FS_HZ);
+    AcqRecording_S rec;
+    std::string err;
+    auto scans = [](double hz, std::size_t ms) { return std::size_t(hz * double(ms) / 1000.0); };
+
+    // trimmed windows, no fs_hz column -> from the window length
+    const bool trimmedOk = load_csv_rate("window_idx", 4, scans(fs, WINDOW_MS - 2 * WINDOW_TRIM_MS), true, -1.0, -1.0, rec, err)
+                           && rec.fs == fs;
+    // chunk file at half the headset rate (decimating build), no fs_hz -> from rows per tick; replay refuses it
+    const double half = 0.5 * double(ACQ_FS_HZ);
+    bool chunkOk = load_csv_rate("chunk_tick", 40, scans(half, CHUNK_MS), false, -1.0, -1.0, rec, err) && rec.fs == half;
+    {
+        ReplayAcquisition_C::replayConfigs_S cfg{};
+        cfg.pacing = AcqPacing_Unpaced;
+        ReplayAcquisition_C replay(cfg, rec);
+        chunkOk = chunkOk && !replay.unicorn_init();
+    }
+    // fs_hz column beats what the window length says
+    const bool colOk = load_csv_rate("window_idx", 4, WINDOW_SCANS, false, half, half, rec, err) && rec.fs == half;
+    // fs_hz that changes mid file
+    const bool changeRefused = !load_csv_rate("window_idx", 4, WINDOW_SCANS, false, fs, half, rec, err);
+
+    const bool ok = trimmedOk && chunkOk && colOk && changeRefused;
+    LOG_ALWAYS("csv rate: trimmed windows " << trimmedOk << ", half rate chunk file found + refused " << chunkOk
+               << ", fs_hz column " << colOk << ", fs_hz changing refused " << changeRefused << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+int main() {
+    logger::tlabel = "ReplaySelfTest";
+    std::vector<float> data;
+    std::vector<double> tMs;
+    make_session(data, tMs);
+
+    bool ok = true;
+    ok = test_binary(data, tMs) && ok;
+    ok = test_truncated(data, tMs) && ok;
+    ok = test_v1(data, tMs) && ok;
+    ok = test_csv_windows(data) && ok;
+    ok = test_pacing(data, tMs) && ok;
+    ok = test_mismatch() && ok;
+    ok = test_csv_rate() && ok;
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}
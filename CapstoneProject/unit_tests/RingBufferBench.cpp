@@ -0,0 +1,313 @@
+#include "../src/utils/RingBuffer.hpp"
+#include "../src/utils/SpscRingBuffer.hpp"
+#include "../src/utils/BroadcastRingBuffer.hpp"
+#include "../src/utils/Types.h"
+#include "../src/utils/Logger.hpp"
+#include <thread>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+/* BENCH COMPONENTS:
+- Contention benchmark: producer and consumer threads hammer the chunk queue
+  back-to-back (no pacing) so every push/pop races the other side
+- Compares the semaphore+mutex RingBuffer_C against the lock-free SpscRingBuffer_C
+  using the real payload (bufferChunk_S, ~1 KB)
+- Third run uses the zero-copy slot API (acquire_write_slot/commit) like the producer does
+- Also checks ordering (ticks must come out in the order they went in)
+- Overflow runs: SpscRingBuffer_C under each OverflowPolicy_E with a consumer that stalls
+  now and then; checks ordering, no torn chunks, and that received + dropped == sent
+- Fan-out run: BroadcastRingBuffer_C with one fast + one deliberately slow subscriber.
+  Producer rate must not depend on the slow one; every tick is either read or counted dropped
+- Paced fan-out: producer publishes half a ring at a time and waits for the fast subscriber only.
+  Fast must see every tick, in order, payload intact, 0 dropped; slow must fall behind, and the
+  gaps it actually sees in the ticks must add up to what its stats say it dropped
+*/
+
+static constexpr std::size_t NUM_CHUNKS = 500000;
+
+// useSlots: producer builds each chunk in place (acquire_write_slot/commit) instead of push(copy)
+template<typename Queue>
+static double run_once(Queue& q, bool& orderOk, bool useSlots = false) {
+    using clk = std::chrono::steady_clock;
+    orderOk = true;
+
+    auto t0 = clk::now();
+    std::thread prod([&]() {
+        bufferChunk_S chunk{};
+        for (std::size_t i = 1; i <= NUM_CHUNKS; ++i) {
+            if constexpr (requires { q.acquire_write_slot(); }) {
+                if (useSlots) {
+                    bufferChunk_S* slot = q.acquire_write_slot();
+                    if (slot == nullptr) break;
+                    slot->tick = i;
+                    slot->data[0] = static_cast<float>(i);
+                    q.commit();
+                    continue;
+                }
+            }
+            chunk.tick = i;
+            chunk.data[0] = static_cast<float>(i);
+            if (!q.push(chunk)) break;
+        }
+    });
+    std::thread cons([&]() {
+        bufferChunk_S chunk{};
+        for (std::size_t i = 1; i <= NUM_CHUNKS; ++i) {
+            if (!q.pop(&chunk)) { orderOk = false; break; }
+            if (chunk.tick != i) orderOk = false;
+        }
+    });
+    prod.join();
+    cons.join();
+    auto t1 = clk::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(NUM_CHUNKS);
+}
+
+// consumer naps every 64 pops so the queue actually overflows
+static bool run_overflow(OverflowPolicy_E policy, double& nsPerChunk) {
+    using clk = std::chrono::steady_clock;
+    SpscRingBuffer_C<bufferChunk_S> q(ACQ_RING_BUFFER_CAPACITY, policy);
+    std::atomic<bool> done{false};
+    bool ok = true;
+    uint64_t received = 0;
+
+    std::thread cons([&]() {
+        bufferChunk_S chunk{};
+        uint64_t lastTick = 0;
+        for (;;) {
+            const bool finished = done.load(std::memory_order_acquire);
+            if (!q.try_pop(&chunk)) {
+                if (finished) break;
+                std::this_thread::yield();
+                continue;
+            }
+            if (chunk.tick <= lastTick || chunk.data[NUM_SAMPLES_CHUNK - 1] != static_cast<float>(chunk.tick)) {
+                ok = false;
+            }
+            lastTick = chunk.tick;
+            received++;
+            if ((received % 64) == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        }
+    });
+
+    auto t0 = clk::now();
+    for (std::size_t i = 1; i <= NUM_CHUNKS / 10; ++i) {
+        bufferChunk_S* slot = q.acquire_write_slot();
+        if (slot == nullptr) { ok = false; break; }
+        slot->tick = i;
+        slot->data[NUM_SAMPLES_CHUNK - 1] = static_cast<float>(i);
+        q.commit();
+    }
+    auto t1 = clk::now();
+    done.store(true, std::memory_order_release);
+    cons.join();
+    nsPerChunk = std::chrono::duration<double, std::nano>(t1 - t0).count() / double(NUM_CHUNKS / 10);
+
+    const SpscQueueStats_S st = q.get_stats();
+    LOG_ALWAYS("  " << OverflowPolicy_to_string(policy) << ": received=" << received << " pushed=" << st.pushed
+               << " dropped_oldest=" << st.dropped_oldest << " dropped_newest=" << st.dropped_newest
+               << " producer_blocks=" << st.producer_blocks << " high_water=" << st.high_water);
+    if (received + st.dropped_oldest + st.dropped_newest != NUM_CHUNKS / 10) ok = false;
+    if (st.high_water > st.capacity) ok = false;
+    if (policy == OverflowPolicy_Block && (st.dropped_oldest + st.dropped_newest) != 0) ok = false;
+    return ok;
+}
+
+// fan-out: producer publishes flat out, "fast" spins on try_read, "slow" naps every 64 reads
+static bool run_broadcast(double& nsPerPublish) {
+    using clk = std::chrono::steady_clock;
+    BroadcastRingBuffer_C<bufferChunk_S> stream(EEG_STREAM_CAPACITY);
+    const int fastId = stream.subscribe("fast");
+    const int slowId = stream.subscribe("slow");
+    std::atomic<bool> done{false};
+    bool ok = true;
+
+    auto reader = [&](int id, bool slow, uint64_t& got) {
+        bufferChunk_S chunk{};
+        uint64_t lastTick = 0;
+        got = 0;
+        for (;;) {
+            const bool finished = done.load(std::memory_order_acquire);
+            const StreamRead_E r = stream.try_read(id, &chunk);
+            if (r == StreamRead_Ok) {
+                // ticks must only move forward and payload must match its tick (no torn reads)
+                if (chunk.tick <= lastTick || chunk.data[0] != static_cast<float>(chunk.tick)
+                    || chunk.data[NUM_SAMPLES_CHUNK - 1] != static_cast<float>(chunk.tick)) {
+                    ok = false;
+                }
+                lastTick = chunk.tick;
+                got++;
+                if (slow && (got % 64) == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            } else if (r == StreamRead_Empty) {
+                if (finished) break;
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    uint64_t gotFast = 0, gotSlow = 0;
+    std::thread fast([&]() { reader(fastId, false, gotFast); });
+    std::thread slow([&]() { reader(slowId, true, gotSlow); });
+
+    auto t0 = clk::now();
+    bufferChunk_S chunk{};
+    for (std::size_t i = 1; i <= NUM_CHUNKS; ++i) {
+        chunk.tick = i;
+        chunk.data[0] = static_cast<float>(i);
+        chunk.data[NUM_SAMPLES_CHUNK - 1] = static_cast<float>(i);
+        stream.publish(chunk);
+    }
+    auto t1 = clk::now();
+    done.store(true, std::memory_order_release);
+    fast.join();
+    slow.join();
+    nsPerPublish = std::chrono::duration<double, std::nano>(t1 - t0).count() / double(NUM_CHUNKS);
+
+    for (const StreamSubscriberStats_S& st : stream.get_stats()) {
+        LOG_ALWAYS("  subscriber " << st.name << ": reads=" << st.reads << " dropped=" << st.dropped
+                   << " overruns=" << st.overruns << " lag=" << st.lag);
+        if (st.reads + st.dropped != NUM_CHUNKS || st.lag != 0) {
+            ok = false;
+        }
+    }
+    (void)gotFast; (void)gotSlow;
+    return ok;
+}
+
+// same fan-out, but the producer waits for the fast reader after every half ring, so fast never gets lapped
+static bool run_broadcast_paced() {
+    using clk = std::chrono::steady_clock;
+    constexpr std::size_t N = NUM_CHUNKS / 10;
+    BroadcastRingBuffer_C<bufferChunk_S> stream(EEG_STREAM_CAPACITY);
+    const int fastId = stream.subscribe("fast");
+    const int slowId = stream.subscribe("slow");
+    const std::size_t burst = stream.get_capacity() / 2;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> fastGot{0};
+
+    struct Seen_S {
+        uint64_t got = 0;
+        uint64_t gapItems = 0;  // ticks that never showed up
+        uint64_t outOfOrder = 0;
+        uint64_t torn = 0;
+        uint64_t overrunReturns = 0;
+    };
+    auto reader = [&](int id, bool slow, Seen_S& seen) {
+        bufferChunk_S chunk{};
+        uint64_t lastTick = 0;
+        for (;;) {
+            const bool finished = done.load(std::memory_order_acquire);
+            const StreamRead_E r = stream.try_read(id, &chunk);
+            if (r == StreamRead_Ok) {
+                if (chunk.tick <= lastTick) seen.outOfOrder++;
+                else seen.gapItems += chunk.tick - lastTick - 1;
+                if (chunk.data[0] != static_cast<float>(chunk.tick)
+                    || chunk.data[NUM_SAMPLES_CHUNK / 2] != static_cast<float>(chunk.tick) + 0.5f
+                    || chunk.data[NUM_SAMPLES_CHUNK - 1] != static_cast<float>(chunk.tick)) {
+                    seen.torn++;
+                }
+                lastTick = chunk.tick;
+                seen.got++;
+                if (!slow) fastGot.store(seen.got, std::memory_order_release);
+                if (slow && (seen.got % 64) == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            } else if (r == StreamRead_Overrun) {
+                seen.overrunReturns++;
+            } else {
+                if (finished) break;
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    Seen_S fastSeen, slowSeen;
+    std::thread fast([&]() { reader(fastId, false, fastSeen); });
+    std::thread slow([&]() { reader(slowId, true, slowSeen); });
+
+    bool stalled = false;
+    bufferChunk_S chunk{};
+    for (std::size_t i = 1; i <= N && !stalled; ++i) {
+        chunk.tick = i;
+        chunk.data[0] = static_cast<float>(i);
+        chunk.data[NUM_SAMPLES_CHUNK / 2] = static_cast<float>(i) + 0.5f;
+        chunk.data[NUM_SAMPLES_CHUNK - 1] = static_cast<float>(i);
+        stream.publish(chunk);
+        if ((i % burst) == 0 || i == N) {
+            const auto deadline = clk::now() + std::chrono::seconds(2);
+            while (fastGot.load(std::memory_order_acquire) < i) {
+                if (clk::now() > deadline) { stalled = true; break; }
+                std::this_thread::yield();
+            }
+        }
+    }
+    done.store(true, std::memory_order_release);
+    fast.join();
+    slow.join();
+
+    StreamSubscriberStats_S fastSt, slowSt;
+    for (const StreamSubscriberStats_S& st : stream.get_stats()) {
+        (st.name == "fast" ? fastSt : slowSt) = st;
+    }
+    const bool okFast = !stalled && fastSeen.got == N && fastSt.reads == N && fastSt.dropped == 0 && fastSt.overruns == 0
+                        && fastSeen.gapItems == 0 && fastSeen.outOfOrder == 0 && fastSeen.torn == 0;
+    const bool okSlow = slowSt.dropped > 0 && slowSt.overruns > 0 && slowSeen.gapItems == slowSt.dropped
+                        && slowSeen.overrunReturns == slowSt.overruns && slowSt.reads + slowSt.dropped == N
+                        && slowSeen.outOfOrder == 0 && slowSeen.torn == 0;
+    LOG_ALWAYS("  paced fast: reads=" << fastSt.reads << "/" << N << " dropped=" << fastSt.dropped << " gaps=" << fastSeen.gapItems
+               << " out_of_order=" << fastSeen.outOfOrder << " torn=" << fastSeen.torn << (stalled ? " STALLED" : "")
+               << (okFast ? "  OK" : "  FAIL"));
+    LOG_ALWAYS("  paced slow: reads=" << slowSt.reads << " dropped=" << slowSt.dropped << " (seen as tick gaps " << slowSeen.gapItems
+               << ") overruns=" << slowSt.overruns << " (returned " << slowSeen.overrunReturns << ")"
+               << (okSlow ? "  OK" : "  FAIL"));
+    return okFast && okSlow;
+}
+
+int main() {
+    logger::tlabel = "RingBufferBench";
+    LOG_ALWAYS("RingBufferBench: " << NUM_CHUNKS << " chunks, capacity=" << ACQ_RING_BUFFER_CAPACITY);
+
+    bool okLocked = false, okSpsc = false, okSlots = false;
+    double nsLocked = 0.0, nsSpsc = 0.0, nsSlots = 0.0;
+    {
+        RingBuffer_C<bufferChunk_S> q(ACQ_RING_BUFFER_CAPACITY);
+        nsLocked = run_once(q, okLocked);
+    }
+    {
+        SpscRingBuffer_C<bufferChunk_S> q(ACQ_RING_BUFFER_CAPACITY);
+        nsSpsc = run_once(q, okSpsc);
+    }
+    {
+        SpscRingBuffer_C<bufferChunk_S> q(ACQ_RING_BUFFER_CAPACITY);
+        nsSlots = run_once(q, okSlots, /*useSlots=*/true);
+    }
+
+    LOG_ALWAYS("RingBuffer_C     (sem+mutex): " << std::fixed << std::setprecision(1) << nsLocked << " ns/chunk" << (okLocked ? "" : "  ORDER FAIL"));
+    LOG_ALWAYS("SpscRingBuffer_C (lock-free): " << std::fixed << std::setprecision(1) << nsSpsc   << " ns/chunk" << (okSpsc   ? "" : "  ORDER FAIL"));
+    LOG_ALWAYS("SpscRingBuffer_C (slots):     " << std::fixed << std::setprecision(1) << nsSlots  << " ns/chunk" << (okSlots  ? "" : "  ORDER FAIL"));
+    if (nsSpsc > 0.0 && nsSlots > 0.0) {
+        LOG_ALWAYS("speedup: " << std::fixed << std::setprecision(2) << (nsLocked / nsSpsc) << "x (push), "
+                               << (nsLocked / nsSlots) << "x (slots)");
+    }
+
+    bool okOverflow = true;
+    for (OverflowPolicy_E p : { OverflowPolicy_Block, OverflowPolicy_DropOldest, OverflowPolicy_DropNewest }) {
+        double ns = 0.0;
+        const bool okP = run_overflow(p, ns);
+        LOG_ALWAYS("SpscRingBuffer_C " << OverflowPolicy_to_string(p) << " producer: " << std::fixed << std::setprecision(1) << ns << " ns/chunk" << (okP ? "" : "  CHECK FAIL"));
+        okOverflow = okOverflow && okP;
+    }
+
+    double nsBroadcast = 0.0;
+    const bool okBroadcast = run_broadcast(nsBroadcast);
+    LOG_ALWAYS("BroadcastRingBuffer_C publish:  " << std::fixed << std::setprecision(1) << nsBroadcast << " ns/chunk" << (okBroadcast ? "" : "  CHECK FAIL"));
+    const bool okPaced = run_broadcast_paced();
+    LOG_ALWAYS("BroadcastRingBuffer_C paced fan-out" << (okPaced ? "" : "  CHECK FAIL"));
+
+    return (okLocked && okSpsc && okSlots && okOverflow && okBroadcast && okPaced) ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+#include "../src/utils/SpectralCache.hpp"
+#include "../src/utils/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/* SELF TEST COMPONENTS:
+1) sine of amplitude A on each channel (different A / freq per channel): band power around it ~ A^2/2,
+   nothing leaks into the other channels, alpha-ish band power of a 10 Hz sine lands in 8-13 Hz
+2) white noise: parseval, sum(psd) * bin_hz ~ variance of the window
+3) cache: compute() on the same totalPushed is a hit (no FFTs), a new one recomputes, invalidate() forces it
+4) snr_at: big at the sine, ~1 on plain noise
+*/
+
+static constexpr double PI = 3.14159265358979323846;
+
+// interleaved WINDOW_SCANS x NUM_CH_CHUNK; channel ch gets amp[ch] * sin(2 pi f[ch] t) + noise
+static std::vector<float> make_window(const std::vector<double>& amp, const std::vector<double>& hz,
+                                      double noiseStd, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> nd(0.0f, float(noiseStd));
+    std::vector<float> w(WINDOW_SCANS * NUM_CH_CHUNK);
+    for (std::size_t s = 0; s < WINDOW_SCANS; ++s) {
+        const double t = double(s) / double(PIPELINE_FS_HZ);
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+            const double v = amp[ch] * std::sin(2.0 * PI * hz[ch] * t + 0.3 * double(ch)) + 5.0; // + dc offset
+            w[s * NUM_CH_CHUNK + ch] = float(v) + (noiseStd > 0.0 ? nd(rng) : 0.0f);
+        }
+    }
+    return w;
+}
+
+static bool test_sine_power(SpectralCache_C& spec) {
+    std::vector<double> amp(NUM_CH_CHUNK), hz(NUM_CH_CHUNK);
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        amp[ch] = 10.0 + 5.0 * double(ch % 8);
+        hz[ch] = 10.0 + double(ch % 8) * 2.5; // 10 .. 27.5 Hz
+    }
+    const std::vector<float> w = make_window(amp, hz, 0.0, 1);
+    spec.compute(w, 1000);
+
+    double worst = 0.0, worstLeak = 0.0, worstAlpha = 0.0;
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        const double want = 0.5 * amp[ch] * amp[ch];
+        const double got = spec.band_power(ch, hz[ch] - 1.5, hz[ch] + 1.5);
+        worst = std::max(worst, std::abs(got - want) / want);
+        // everything away from the sine (and DC, removed) is ~0
+        const double rest = spec.band_power(ch, 0.0, 0.5 * double(PIPELINE_FS_HZ)) - got;
+        worstLeak = std::max(worstLeak, rest / want);
+        if (ch % 8 == 0) worstAlpha = std::max(worstAlpha, std::abs(spec.band_power(ch, 8.0, 13.0) - want) / want);
+    }
+    const bool ok = worst < 0.02 && worstLeak < 0.01 && worstAlpha < 0.02;
+    LOG_ALWAYS("sine power: worst rel err " << worst << ", leak outside +-1.5 Hz " << worstLeak
+               << ", 10 Hz in alpha band err " << worstAlpha << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_parseval(SpectralCache_C& spec) {
+    const std::vector<double> zero(NUM_CH_CHUNK, 0.0);
+    double worst = 0.0;
+    double sumRatio = 0.0;
+    const int trials = 20;
+    for (int k = 0; k < trials; ++k) {
+        const std::vector<float> w = make_window(zero, zero, 7.0, 100 + k);
+        spec.compute(w, 2000 + k);
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+            double m = 0.0, v = 0.0;
+            for (std::size_t s = 0; s < WINDOW_SCANS; ++s) m += w[s * NUM_CH_CHUNK + ch];
+            m /= double(WINDOW_SCANS);
+            for (std::size_t s = 0; s < WINDOW_SCANS; ++s) { const double d = w[s * NUM_CH_CHUNK + ch] - m; v += d * d; }
+            v /= double(WINDOW_SCANS);
+            double total = 0.0;
+            for (float p : spec.psd(ch)) total += p;
+            const double ratio = total * SPEC_BIN_HZ / v;
+            sumRatio += ratio;
+            worst = std::max(worst, std::abs(ratio - 1.0));
+        }
+    }
+    // single windows wobble (hann weights the middle), the average doesn't
+    const double meanRatio = sumRatio / double(trials * NUM_CH_CHUNK);
+    const bool ok = std::abs(meanRatio - 1.0) < 0.03 && worst < 0.25;
+    LOG_ALWAYS("parseval (white noise): mean psd power / variance " << meanRatio << ", worst single window off by "
+               << worst << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_cache(SpectralCache_C& spec) {
+    const std::vector<double> amp(NUM_CH_CHUNK, 20.0), hz(NUM_CH_CHUNK, 12.0);
+    const std::vector<float> a = make_window(amp, hz, 1.0, 7);
+    const std::vector<float> b = make_window(amp, hz, 1.0, 8);
+    const uint64_t n0 = spec.get_num_computed();
+
+    const bool first = spec.compute(a, 5000);
+    const std::vector<float> psdA(spec.psd(0).begin(), spec.psd(0).end());
+    const bool again = spec.compute(b, 5000); // same key -> b is never looked at
+    const bool same = std::equal(psdA.begin(), psdA.end(), spec.psd(0).begin());
+    const bool next = spec.compute(b, 5000 + WINDOW_HOP_SCANS * NUM_CH_CHUNK);
+    spec.invalidate();
+    const bool forced = spec.compute(b, 5000 + WINDOW_HOP_SCANS * NUM_CH_CHUNK);
+    const uint64_t ran = spec.get_num_computed() - n0;
+
+    const bool ok = first && !again && same && next && forced && ran == 3 && spec.is_valid();
+    LOG_ALWAYS("cache: first " << first << ", same key " << again << " (psd untouched " << same << "), next hop " << next
+               << ", after invalidate " << forced << ", " << ran << " computes" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_snr(SpectralCache_C& spec) {
+    const std::vector<double> amp(NUM_CH_CHUNK, 3.0), hz(NUM_CH_CHUNK, 12.0);
+    const std::vector<double> zero(NUM_CH_CHUNK, 0.0);
+
+    const std::vector<float> w = make_window(amp, hz, 5.0, 11);
+    spec.compute(w, 9000);
+    float minAt = 1e30f;
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) minAt = std::min(minAt, spec.snr_at(ch, 12.0, 0.5, 2.0));
+
+    // noise only: average over a bunch of frequencies + windows
+    double sumNoise = 0.0;
+    int n = 0;
+    for (int k = 0; k < 10; ++k) {
+        const std::vector<float> nw = make_window(zero, zero, 5.0, 200 + k);
+        spec.compute(nw, 10000 + k);
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+            for (double f = 8.0; f <= 20.0; f += 1.0) { sumNoise += spec.snr_at(ch, f, 0.5, 2.0); ++n; }
+        }
+    }
+    const double meanNoise = sumNoise / double(n);
+    const bool ok = minAt > 5.0f && meanNoise > 0.7 && meanNoise < 1.4;
+    LOG_ALWAYS("snr: min at 12 Hz sine " << minAt << ", mean on noise " << meanNoise << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+int main() {
+    logger::tlabel = "SpectralSelfTest";
+    LOG_ALWAYS("window " << WINDOW_SCANS << " scans @ " << PIPELINE_FS_HZ << " Hz -> nfft " << SPEC_NFFT
+               << ", " << SPEC_BIN_HZ << " Hz bins");
+    SpectralCache_C spec;
+    bool ok = true;
+    ok = test_sine_power(spec) && ok;
+    ok = test_parseval(spec) && ok;
+    ok = test_cache(spec) && ok;
+    ok = test_snr(spec) && ok;
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}
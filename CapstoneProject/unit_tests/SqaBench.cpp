@@ -0,0 +1,179 @@
+#include "../src/utils/WindowMoments.hpp"
+#include "../src/utils/FirSimd.hpp"
+#include "../src/utils/Types.h"
+#include "../src/utils/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+/* BENCH COMPONENTS:
+- SQA per-window stats (mean/std/rms/max/step + counts, kurtosis, histogram entropy) on windows one hop
+  apart, like the consumer hands them to check_artifact_and_flag_window
+- Baseline: the old SQA loop (per channel: strided pass for sums/max/step, strided kurtosis pass, strided
+  histogram pass into a heap std::vector<int>)
+- Then WindowMoments_C on every hop kernel this CPU supports: full recompute every window (reset() first),
+  and incremental (1 new hop per window)
+- Reports us per window, speedup vs baseline, max |diff| of std/kurt/entropy vs baseline
+*/
+
+static constexpr std::size_t NUM_WIN = 4000; // 4000 hops (~21 min of EEG at 250 Hz)
+static constexpr float AMP_T = 200.0f, STEP_T = 100.0f;
+static constexpr std::size_t NCH = NUM_CH_CHUNK;
+
+using clk = std::chrono::steady_clock;
+
+// ---- the old code (SignalQualityAnalyzer.cpp before WindowMoments_C) ----
+static float hist_entropy_channel(std::span<const float> snap, size_t ch,
+                                  int bins = 64, float minv = -200.0f, float maxv = 200.0f) {
+    if (!(maxv > minv) || bins <= 1) return 0.0f;
+    std::vector<int> h((size_t)bins, 0);
+    float inv = 1.0f / (maxv - minv);
+    for (size_t s = 0; s < WINDOW_SCANS; ++s) {
+        float v = snap[s * NUM_CH_CHUNK + ch];
+        float t = (v - minv) * inv;
+        int b = (int)(t * bins);
+        b = std::max(0, std::min(b, bins - 1));
+        h[(size_t)b]++;
+    }
+    float H = 0.0f;
+    float n = (float)WINDOW_SCANS;
+    for (int c : h) {
+        if (c == 0) continue;
+        float p = (float)c / n;
+        H += -p * std::log(p);
+    }
+    return H;
+}
+
+static float excess_kurtosis_channel(std::span<const float> snap, size_t ch, float mean) {
+    double m2 = 0.0, m4 = 0.0;
+    for (size_t s = 0; s < WINDOW_SCANS; ++s) {
+        double d = (double)snap[s * NUM_CH_CHUNK + ch] - (double)mean;
+        double d2 = d * d;
+        m2 += d2;
+        m4 += d2 * d2;
+    }
+    m2 /= (double)WINDOW_SCANS;
+    m4 /= (double)WINDOW_SCANS;
+    if (m2 < 1e-12) return 0.0f;
+    return (float)(m4 / (m2 * m2) - 3.0);
+}
+
+static void old_window_stats(std::span<const float> win_view, Stats_s& winStats,
+                             std::array<int, NUM_CH_CHUNK>& ampCount, std::array<int, NUM_CH_CHUNK>& stepCount) {
+    ampCount.fill(0);
+    stepCount.fill(0);
+    for (size_t ch = 0; ch < NUM_CH_CHUNK; ch++) {
+        double sum = 0.0, sumsq = 0.0;
+        float max_abs = 0.0f;
+        float max_step = 0.0f;
+        float prev = win_view[0 * NUM_CH_CHUNK + ch];
+        for (size_t s = 0; s < WINDOW_SCANS; ++s) {
+            float sample = win_view[s * NUM_CH_CHUNK + ch];
+            sum += sample;
+            sumsq += (double)sample * (double)sample;
+            float av = std::abs(sample);
+            max_abs = std::max(max_abs, av);
+            if (av > AMP_T) ampCount[ch]++;
+            if (s > 0) {
+                float step = std::abs(sample - prev);
+                max_step = std::max(max_step, step);
+                if (step > STEP_T) stepCount[ch]++;
+            }
+            prev = sample;
+        }
+        float chMean = (float)(sum / double(WINDOW_SCANS));
+        float ex2 = (float)(sumsq / (double)WINDOW_SCANS);
+        float var = ex2 - chMean * chMean;
+        winStats.mean_uv[ch] = chMean;
+        winStats.std_uv[ch] = std::sqrt(std::max(var, 0.0f));
+        winStats.rms_uv[ch] = std::sqrt(std::max(ex2, 0.0f));
+        winStats.max_abs_uv[ch] = max_abs;
+        winStats.max_step_uv[ch] = max_step;
+        winStats.kurt[ch] = excess_kurtosis_channel(win_view, ch, chMean);
+        winStats.entropy[ch] = hist_entropy_channel(win_view, ch);
+    }
+}
+// -------------------------------------------------------------------------
+
+static std::span<const float> window_at(const std::vector<float>& stream, std::size_t w) {
+    return std::span<const float>(stream.data() + w * WINDOW_HOP_SCANS * NCH, WINDOW_SCANS * NCH);
+}
+
+int main() {
+    logger::tlabel = "SqaBench";
+
+    // fake EEG-ish input: 15 uV noise + 10 Hz alpha, a few blinks, small per channel DC
+    const std::size_t nScans = WINDOW_SCANS + NUM_WIN * WINDOW_HOP_SCANS;
+    std::vector<float> stream(nScans * NCH);
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> noise(0.0f, 15.0f);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    float blink = 0.0f;
+    for (std::size_t s = 0; s < nScans; ++s) {
+        if (u01(rng) < 0.001f) blink = 250.0f;
+        blink *= 0.98f;
+        for (std::size_t ch = 0; ch < NCH; ++ch) {
+            stream[s * NCH + ch] = 2.0f * float(ch) + noise(rng) + blink
+                                   + 10.0f * std::sin(2.0f * 3.14159265f * 10.0f * float(s) / float(PIPELINE_FS_HZ) + float(ch));
+        }
+    }
+
+    std::vector<Stats_s> ref(NUM_WIN), out(NUM_WIN);
+    std::array<int, NUM_CH_CHUNK> amp{}, step{};
+    volatile int sink = 0;
+    auto t0 = clk::now();
+    for (std::size_t w = 0; w < NUM_WIN; ++w) {
+        old_window_stats(window_at(stream, w), ref[w], amp, step);
+        sink = sink + amp[0] + step[0];
+    }
+    const double usBase = std::chrono::duration<double, std::micro>(clk::now() - t0).count() / double(NUM_WIN);
+    LOG_ALWAYS(NUM_WIN << " windows of " << WINDOW_SCANS << " scans x " << NCH << " ch, hop " << WINDOW_HOP_SCANS);
+    LOG_ALWAYS(std::left << std::setw(30) << "old per-channel passes" << std::right
+               << std::fixed << std::setprecision(1) << usBase << " us/window");
+
+    // float sums in the old code -> std differs ~1e-4 rel on windows with a DC offset; kurt from that mean too
+    bool ok = true;
+    auto run = [&](FirSimdPath_E p, bool incremental) {
+        WindowMoments_C wm(AMP_T, STEP_T, p);
+        const auto t1 = clk::now();
+        for (std::size_t w = 0; w < NUM_WIN; ++w) {
+            if (!incremental) wm.reset();
+            wm.update(window_at(stream, w), uint64_t(WINDOW_SCANS + w * WINDOW_HOP_SCANS) * NCH, out[w]);
+            sink = sink + wm.get_amp_counts()[0];
+        }
+        const double us = std::chrono::duration<double, std::micro>(clk::now() - t1).count() / double(NUM_WIN);
+
+        double dStd = 0.0, dKurt = 0.0, dEnt = 0.0;
+        for (std::size_t w = 0; w < NUM_WIN; ++w) {
+            for (std::size_t ch = 0; ch < NCH; ++ch) {
+                dStd = std::max(dStd, double(std::fabs(out[w].std_uv[ch] - ref[w].std_uv[ch])));
+                dKurt = std::max(dKurt, double(std::fabs(out[w].kurt[ch] - ref[w].kurt[ch])));
+                dEnt = std::max(dEnt, double(std::fabs(out[w].entropy[ch] - ref[w].entropy[ch])));
+            }
+        }
+        const bool okP = dStd < 1e-2 && dKurt < 1e-2 && dEnt < 1e-4;
+        ok = ok && okP;
+        const std::string name = std::string("WindowMoments_C ") + FirSimdPath_to_string(wm.get_path()) + (incremental ? " incr" : " full");
+        LOG_ALWAYS(std::left << std::setw(30) << name << std::right
+                   << std::fixed << std::setprecision(1) << us << " us/window"
+                   << "  speedup " << std::setprecision(2) << (usBase / us) << "x"
+                   << "  max|diff| std " << std::scientific << std::setprecision(1) << dStd
+                   << " kurt " << dKurt << " ent " << dEnt << (okP ? "" : "  MISMATCH"));
+    };
+    for (FirSimdPath_E p : { FirSimd_Scalar, FirSimd_AVX2 }) {
+        if (!fir_simd_path_supported(p)) {
+            LOG_ALWAYS("WindowMoments_C " << FirSimdPath_to_string(p) << ": not supported here, skipped");
+            continue;
+        }
+        run(p, false);
+        run(p, true);
+    }
+    LOG_ALWAYS("runtime pick: " << FirSimdPath_to_string(WindowMoments_C(AMP_T, STEP_T).get_path()));
+    return ok ? 0 : 1;
+}
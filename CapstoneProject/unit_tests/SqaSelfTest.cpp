@@ -0,0 +1,341 @@
+#include "../src/utils/WindowMoments.hpp"
+#include "../src/utils/MirroredRingBuffer.hpp"
+#include "../src/utils/SlidingExtrema.hpp"
+#include "../src/utils/P2Quantile.hpp"
+#include "../src/utils/RobustStats.hpp"
+#include "../src/utils/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/* SELF TEST COMPONENTS:
+1) WindowMoments_C vs the old full-window SQA math (sum/sumsq pass + kurtosis pass + histogram entropy pass)
+   on a live MirroredRingBuffer_C window that moves by 1 hop (usual), several hops, partial refills
+   (UI change mid build) and jumps bigger than a window. Signal has big DC offsets, spikes/steps over the
+   thresholds and values outside the histogram range
+2) incremental path is really taken (1 hop computed per usual move)
+3) avx2 hop kernel gives bit identical stats to the scalar one (timing: SqaBench)
+4) SlidingMax_C / SlidingMin_C / SlidingQuantile_C vs sorting the last N values every push
+   (ramp-up, ties, runs that keep the old max alive, the max leaving the window)
+5) P2Quantile_C vs exact quantiles on gaussian + 3% big outliers; RobustBaseline_C's MAD gives the clean
+   sigma where std doesn't, and every sample of a moving window is fed exactly once; 1..5 samples are exact
+   nearest rank for every p (5 is where the markers get seeded, not yet the p-th quantile)
+*/
+
+static constexpr float AMP_T = 200.0f, STEP_T = 100.0f;
+
+// the SQA's per-window stats before WindowMoments_C
+struct RefStats_S {
+    Stats_s st;
+    std::array<int, NUM_CH_CHUNK> amp{}, step{};
+};
+
+static void reference_stats(std::span<const float> w, RefStats_S& r) {
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        double sum = 0.0, sumsq = 0.0;
+        float maxAbs = 0.0f, maxStep = 0.0f;
+        int amp = 0, step = 0;
+        float prev = w[ch];
+        for (std::size_t s = 0; s < WINDOW_SCANS; ++s) {
+            const float v = w[s * NUM_CH_CHUNK + ch];
+            sum += v;
+            sumsq += double(v) * double(v);
+            maxAbs = std::max(maxAbs, std::abs(v));
+            amp += std::abs(v) > AMP_T;
+            if (s > 0) {
+                maxStep = std::max(maxStep, std::abs(v - prev));
+                step += std::abs(v - prev) > STEP_T;
+            }
+            prev = v;
+        }
+        const double mean = sum / double(WINDOW_SCANS);
+        double m2 = 0.0, m4 = 0.0;
+        std::vector<int> h(SQA_HIST_BINS, 0);
+        for (std::size_t s = 0; s < WINDOW_SCANS; ++s) {
+            const float v = w[s * NUM_CH_CHUNK + ch];
+            const double d = double(v) - mean;
+            m2 += d * d;
+            m4 += d * d * d * d;
+            int b = int((v - SQA_HIST_MIN_UV) / (SQA_HIST_MAX_UV - SQA_HIST_MIN_UV) * float(SQA_HIST_BINS));
+            h[std::clamp(b, 0, SQA_HIST_BINS - 1)]++;
+        }
+        m2 /= double(WINDOW_SCANS);
+        m4 /= double(WINDOW_SCANS);
+        double H = 0.0;
+        for (int c : h) {
+            if (c == 0) continue;
+            const double p = double(c) / double(WINDOW_SCANS);
+            H -= p * std::log(p);
+        }
+        r.st.mean_uv[ch] = float(mean);
+        r.st.std_uv[ch] = float(std::sqrt(m2));
+        r.st.rms_uv[ch] = float(std::sqrt(sumsq / double(WINDOW_SCANS)));
+        r.st.max_abs_uv[ch] = maxAbs;
+        r.st.max_step_uv[ch] = maxStep;
+        r.st.kurt[ch] = (m2 < 1e-12) ? 0.0f : float(m4 / (m2 * m2) - 3.0);
+        r.st.entropy[ch] = float(H);
+        r.amp[ch] = amp;
+        r.step[ch] = step;
+    }
+}
+
+// EEG-ish: noise + alpha, per channel DC (one huge), now and then a blink / electrode pop
+struct SignalGen_S {
+    std::mt19937 rng{42};
+    std::normal_distribution<float> n01{0.0f, 1.0f};
+    std::uniform_real_distribution<float> u01{0.0f, 1.0f};
+    std::size_t t = 0;
+    float pop = 0.0f;
+    void next_scan(float* row) {
+        const float alpha = 12.0f * std::sin(2.0f * 3.14159265f * 10.0f * float(t) / float(PIPELINE_FS_HZ));
+        if (u01(rng) < 0.002f) pop = (u01(rng) < 0.5f ? -1.0f : 1.0f) * (150.0f + 300.0f * u01(rng));
+        pop *= 0.97f;
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+            const float dc = (ch == 0) ? 5000.0f : float(ch) * 3.0f;
+            row[ch] = dc + alpha + 10.0f * n01(rng) + ((ch % 3 == 1) ? pop : 0.0f);
+        }
+        ++t;
+    }
+};
+
+static bool close_rel(float a, float b, float rel, float abs) {
+    return std::fabs(a - b) <= abs + rel * std::max(std::fabs(a), std::fabs(b));
+}
+
+static bool test_vs_reference() {
+    MirroredRingBuffer_C<float> win(WINDOW_SCANS * NUM_CH_CHUNK);
+    SignalGen_S gen;
+    std::vector<float> row(NUM_CH_CHUNK);
+    auto push_scans = [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            gen.next_scan(row.data());
+            win.push_n(row.data(), NUM_CH_CHUNK);
+        }
+    };
+    auto move = [&](std::size_t scans) {
+        win.discard_n(std::min(scans, WINDOW_SCANS) * NUM_CH_CHUNK);
+        push_scans(scans > WINDOW_SCANS ? WINDOW_SCANS : scans);
+        if (scans > WINDOW_SCANS) { // skipped stretch of stream
+            for (std::size_t i = 0; i < scans - WINDOW_SCANS; ++i) gen.next_scan(row.data());
+            win.discard_n(win.get_count());
+            push_scans(WINDOW_SCANS);
+        }
+    };
+    push_scans(WINDOW_SCANS);
+
+    WindowMoments_C wm(AMP_T, STEP_T);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    std::size_t windows = 0, bad = 0, oneHop = 0, oneHopIncremental = 0, ampHits = 0, stepHits = 0;
+    float worstKurt = 0.0f, worstEnt = 0.0f, worstStd = 0.0f;
+    for (std::size_t it = 0; it < 4000; ++it) {
+        const float r = u01(rng);
+        std::size_t scans = WINDOW_HOP_SCANS;
+        if (it > 0) {
+            if (r < 0.10f) scans = WINDOW_HOP_SCANS * (2 + std::size_t(u01(rng) * 3.0f));               // skipped windows
+            else if (r < 0.18f) scans = 1 + std::size_t(u01(rng) * float(WINDOW_HOP_SCANS * 3));       // partial refills
+            else if (r < 0.22f) scans = WINDOW_SCANS + std::size_t(u01(rng) * float(WINDOW_SCANS)); // way behind
+            move(scans);
+        }
+
+        Stats_s st{};
+        wm.update(win.view(), win.get_total_pushed(), st);
+        RefStats_S ref;
+        reference_stats(win.view(), ref);
+        ++windows;
+        if (it > 0 && scans == WINDOW_HOP_SCANS) {
+            ++oneHop;
+            oneHopIncremental += (wm.get_last_hops_computed() == 1);
+        }
+
+        bool ok = true;
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+            ok = ok && close_rel(st.mean_uv[ch], ref.st.mean_uv[ch], 1e-5f, 1e-3f);
+            ok = ok && close_rel(st.std_uv[ch], ref.st.std_uv[ch], 1e-4f, 1e-3f);
+            ok = ok && close_rel(st.rms_uv[ch], ref.st.rms_uv[ch], 1e-5f, 1e-3f);
+            ok = ok && st.max_abs_uv[ch] == ref.st.max_abs_uv[ch] && st.max_step_uv[ch] == ref.st.max_step_uv[ch];
+            ok = ok && wm.get_amp_counts()[ch] == ref.amp[ch] && wm.get_step_counts()[ch] == ref.step[ch];
+            ok = ok && close_rel(st.kurt[ch], ref.st.kurt[ch], 1e-3f, 1e-3f);
+            ok = ok && close_rel(st.entropy[ch], ref.st.entropy[ch], 1e-5f, 1e-5f);
+            worstKurt = std::max(worstKurt, std::fabs(st.kurt[ch] - ref.st.kurt[ch]));
+            worstEnt = std::max(worstEnt, std::fabs(st.entropy[ch] - ref.st.entropy[ch]));
+            worstStd = std::max(worstStd, std::fabs(st.std_uv[ch] - ref.st.std_uv[ch]) / std::max(ref.st.std_uv[ch], 1e-6f));
+            ampHits += ref.amp[ch];
+            stepHits += ref.step[ch];
+        }
+        bad += !ok;
+    }
+    const bool ok = bad == 0 && oneHopIncremental == oneHop && ampHits > 0 && stepHits > 0;
+    LOG_ALWAYS("vs full recompute: " << bad << " of " << windows << " windows differ (worst kurt " << worstKurt << ", entropy "
+               << worstEnt << ", std rel " << worstStd << "), " << oneHopIncremental << "/" << oneHop
+               << " one-hop moves incremental, " << ampHits << " amp / " << stepHits << " step hits" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_avx2_matches_scalar() {
+    if (!fir_simd_path_supported(FirSimd_AVX2)) {
+        LOG_ALWAYS("avx2 vs scalar hop kernel: no avx2 on this cpu, skipped");
+        return true;
+    }
+    // values all over: inside/outside the histogram range, over the thresholds, big DC on some channels
+    std::mt19937 rng(11);
+    std::normal_distribution<float> n01(0.0f, 1.0f);
+    const std::size_t nWin = 300;
+    std::vector<float> stream((WINDOW_SCANS + nWin * WINDOW_HOP_SCANS) * NUM_CH_CHUNK);
+    for (std::size_t i = 0; i < stream.size(); ++i) {
+        const std::size_t ch = i % NUM_CH_CHUNK;
+        stream[i] = ((ch % 4 == 0) ? 3000.0f : 0.0f) + ((ch % 5 == 2) ? 150.0f : 30.0f) * n01(rng);
+    }
+    WindowMoments_C a(AMP_T, STEP_T, FirSimd_Scalar), b(AMP_T, STEP_T, FirSimd_AVX2);
+    std::size_t diff = 0;
+    for (std::size_t w = 0; w < nWin; ++w) {
+        const std::span<const float> win(stream.data() + w * WINDOW_HOP_SCANS * NUM_CH_CHUNK, WINDOW_SCANS * NUM_CH_CHUNK);
+        const uint64_t pushed = uint64_t(WINDOW_SCANS + w * WINDOW_HOP_SCANS) * NUM_CH_CHUNK;
+        Stats_s sa{}, sb{};
+        a.update(win, pushed, sa);
+        b.update(win, pushed, sb);
+        diff += (std::memcmp(&sa, &sb, sizeof(Stats_s)) != 0) || a.get_amp_counts() != b.get_amp_counts()
+                || a.get_step_counts() != b.get_step_counts();
+    }
+    const bool ok = diff == 0 && b.get_path() == FirSimd_AVX2;
+    LOG_ALWAYS("avx2 vs scalar hop kernel: " << diff << " of " << nWin << " windows differ" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_sliding_trackers() {
+    const std::size_t N = 141; // ~45 s of hops
+    SlidingMax_C mx(N);
+    SlidingMin_C mn(N);
+    SlidingQuantile_C q(N);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    std::vector<float> hist, last;
+    std::size_t bad = 0, pushes = 0;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        float v;
+        const float r = u01(rng);
+        if (r < 0.2f) v = std::round(u01(rng) * 5.0f);          // lots of ties
+        else if (r < 0.3f) v = 1000.0f - float(i % 300);         // falling runs (deque stays long)
+        else v = 100.0f * u01(rng);
+        mx.push(v);
+        mn.push(v);
+        q.push(v);
+        hist.push_back(v);
+        ++pushes;
+
+        last.assign(hist.end() - std::ptrdiff_t(std::min(hist.size(), N)), hist.end());
+        std::sort(last.begin(), last.end());
+        auto ref_q = [&](float p) {
+            const float pos = p * float(last.size() - 1);
+            const std::size_t k = std::size_t(pos);
+            if (k + 1 >= last.size()) return last.back();
+            return last[k] + (pos - float(k)) * (last[k + 1] - last[k]);
+        };
+        bool ok = mx.get() == last.back() && mn.get() == last.front() && mx.get_count() == last.size();
+        ok = ok && q.min() == last.front() && q.max() == last.back() && q.get_count() == last.size();
+        for (float p : { 0.05f, 0.25f, 0.5f, 0.9f, 0.95f }) ok = ok && q.quantile(p) == ref_q(p);
+        bad += !ok;
+    }
+    const bool ok = bad == 0;
+    LOG_ALWAYS("sliding max/min/quantile (N=" << N << "): " << bad << " of " << pushes << " pushes wrong" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_p2_small() {
+    const double vals[5] = { 7.0, -3.0, 12.0, 0.5, 4.0 };
+    std::size_t bad = 0;
+    for (double p : { 0.01, 0.25, 0.5, 0.75, 0.99 }) {
+        P2Quantile_C q(p);
+        for (std::size_t n = 1; n <= 5; ++n) {
+            q.push(vals[n - 1]);
+            std::vector<double> sorted(vals, vals + n);
+            std::sort(sorted.begin(), sorted.end());
+            const double exact = sorted[std::size_t(std::lround(p * double(n - 1)))];
+            bad += q.get() != exact;
+        }
+    }
+    const bool ok = bad == 0;
+    LOG_ALWAYS("P2 quantiles, 1..5 samples: " << bad << " of 25 not nearest rank" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_p2_robust() {
+    const std::size_t N = 200000;
+    std::mt19937 rng(8);
+    std::normal_distribution<float> g(0.0f, 10.0f);
+    std::uniform_real_distribution<float> u01(0.0f, 1.0f);
+    std::vector<float> x(N);
+    for (auto& v : x) v = (u01(rng) < 0.03f) ? (u01(rng) < 0.5f ? -1.0f : 1.0f) * (150.0f + 150.0f * u01(rng)) : g(rng);
+
+    bool ok = true;
+    std::vector<float> sorted = x;
+    std::sort(sorted.begin(), sorted.end());
+    const float spread = sorted[std::size_t(0.99 * (N - 1))] - sorted[std::size_t(0.01 * (N - 1))];
+    float worst = 0.0f;
+    for (double p : { 0.01, 0.1, 0.5, 0.9, 0.99 }) {
+        P2Quantile_C q(p);
+        for (float v : x) q.push(v);
+        const float exact = sorted[std::size_t(p * double(N - 1))];
+        worst = std::max(worst, std::fabs(float(q.get()) - exact) / spread);
+    }
+    ok = ok && worst < 0.01f;
+
+    // interleave the same data into a sliding window, moves of 1 hop / partial / more than a window
+    MirroredRingBuffer_C<float> win(WINDOW_SCANS * NUM_CH_CHUNK);
+    RobustBaseline_C rb;
+    std::size_t next = 0, fed = 0;
+    std::vector<float> row(NUM_CH_CHUNK);
+    auto push_scan = [&]() {
+        for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) row[ch] = x[(next + ch * 7919) % N];
+        ++next;
+        win.push_n(row.data(), NUM_CH_CHUNK);
+    };
+    for (std::size_t s = 0; s < WINDOW_SCANS; ++s) push_scan();
+    rb.update(win.view(), win.get_total_pushed());
+    fed += WINDOW_SCANS;
+    bool fedOk = rb.get_num_scans() == fed;
+    while (next < N / 2) {
+        const float r = u01(rng);
+        std::size_t m = WINDOW_HOP_SCANS;
+        if (r < 0.2f) m = 1 + std::size_t(u01(rng) * float(WINDOW_HOP_SCANS));
+        else if (r < 0.25f) m = WINDOW_SCANS + 1 + std::size_t(u01(rng) * float(WINDOW_SCANS));
+        const std::size_t keep = std::min(m, WINDOW_SCANS);
+        win.discard_n(keep * NUM_CH_CHUNK);
+        for (std::size_t s = 0; s < m; ++s) {
+            if (win.get_count() == WINDOW_SCANS * NUM_CH_CHUNK) win.discard_n(NUM_CH_CHUNK);
+            push_scan();
+        }
+        rb.update(win.view(), win.get_total_pushed());
+        fed += keep; // more than a window -> only the window's worth was ever visible
+        fedOk = fedOk && rb.get_num_scans() == fed;
+    }
+    ok = ok && fedOk;
+
+    // clean sigma is 10: MAD*1.4826 should be ~10 even with the outliers, plain std isn't
+    double sum = 0.0, sumsq = 0.0;
+    for (float v : x) { sum += v; sumsq += double(v) * v; }
+    const double stdAll = std::sqrt(sumsq / N - (sum / N) * (sum / N));
+    float worstSigma = 0.0f;
+    for (std::size_t ch = 0; ch < NUM_CH_CHUNK; ++ch) {
+        worstSigma = std::max(worstSigma, std::fabs(MAD_TO_SIGMA * rb.get_mad(ch) - 10.0f) / 10.0f);
+    }
+    ok = ok && worstSigma < 0.08f && stdAll > 30.0;
+    LOG_ALWAYS("P2 quantiles: worst " << 100.0f * worst << "% of p01..p99 spread off exact; robust sigma within "
+               << 100.0f * worstSigma << "% of the clean 10 uV (std of the same data " << stdAll << "), "
+               << rb.get_num_scans() << " scans fed" << (fedOk ? " once each" : " WRONG COUNT") << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+int main() {
+    logger::tlabel = "SqaSelfTest";
+    bool ok = true;
+    ok = test_vs_reference() && ok;
+    ok = test_avx2_matches_scalar() && ok;
+    ok = test_sliding_trackers() && ok;
+    ok = test_p2_small() && ok;
+    ok = test_p2_robust() && ok;
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#include "../src/acq/FakeAcquisition.h"
+#include "../src/acq/ChunkGapTracker.hpp"
+#include "../src/utils/Logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+/* SELF TEST COMPONENTS:
+1) transport on but lossless: exact same samples as transport off (own rng), counter contiguous
+2) lossy link: every delivered chunk is the right slice of the uninterrupted stream (counter says where,
+   to float rounding), counter jumps add up to get_lost_scans()
+3) delivery timing (x20 speed): chunks arrive in order, when latency_ms() says, stalls come out as bursts
+4) ChunkGapTracker_C: tick jumps + counter jumps are gaps, a window is only contiguous once it's all post gap
+*/
+
+static FakeAcquisition_C::stimConfigs_S base_cfg() {
+    FakeAcquisition_C::stimConfigs_S cfg{};
+    cfg.alpha.enabled = true;
+    cfg.lineNoise.enabled = true;
+    cfg.pacing = AcqPacing_Unpaced;
+    return cfg;
+}
+
+static bool test_lossless_identical() {
+    FakeAcquisition_C::stimConfigs_S cfgOff = base_cfg();
+    FakeAcquisition_C::stimConfigs_S cfgOn = base_cfg();
+    cfgOn.transport = FakeAcquisition_C::transportConfigs_S::preset(FakeTransport_Lossy);
+    cfgOn.transport.lossProb = 0.0;
+    FakeAcquisition_C off(cfgOff), on(cfgOn);
+
+    std::vector<float> a(NUM_SAMPLES_CHUNK), b(NUM_SAMPLES_CHUNK);
+    std::size_t diff = 0, badCounter = 0;
+    for (std::size_t k = 0; k < 500; ++k) {
+        off.getData(NUM_SCANS_CHUNK, a.data());
+        on.getData(NUM_SCANS_CHUNK, b.data());
+        diff += (std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) != 0);
+        uint64_t c = 0;
+        on.get_scan_counter(c);
+        badCounter += (c != k * NUM_SCANS_CHUNK);
+    }
+    const bool ok = diff == 0 && badCounter == 0 && on.get_lost_scans() == 0;
+    LOG_ALWAYS("lossless transport: " << diff << " chunks differ from transport off, " << badCounter
+               << " bad counters" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_loss_accounting() {
+    const std::size_t nChunks = 4000;
+    FakeAcquisition_C::stimConfigs_S cfg = base_cfg();
+    cfg.transport = FakeAcquisition_C::transportConfigs_S::preset(FakeTransport_Lossy);
+    FakeAcquisition_C lossy(cfg);
+    FakeAcquisition_C::stimConfigs_S cfgRef = base_cfg();
+    FakeAcquisition_C ref(cfgRef);
+
+    // uninterrupted stream, long enough for every lost scan too
+    const std::size_t refChunks = nChunks + nChunks * cfg.transport.lossMaxScans / NUM_SCANS_CHUNK + 1;
+    std::vector<float> stream(refChunks * NUM_SAMPLES_CHUNK);
+    for (std::size_t k = 0; k < refChunks; ++k) ref.getData(NUM_SCANS_CHUNK, stream.data() + k * NUM_SAMPLES_CHUNK);
+
+    std::vector<float> x(NUM_SAMPLES_CHUNK);
+    uint64_t next = 0, jumps = 0, jumped = 0;
+    std::size_t mismatch = 0;
+    for (std::size_t k = 0; k < nChunks; ++k) {
+        lossy.getData(NUM_SCANS_CHUNK, x.data());
+        uint64_t c = 0;
+        lossy.get_scan_counter(c);
+        if (c != next) {
+            ++jumps;
+            jumped += c - next;
+        }
+        next = c + NUM_SCANS_CHUNK;
+        // not bit exact: lost runs move the block boundaries the phasors get renormalized at (~1e-14)
+        const float* r = stream.data() + c * NUM_CH_CHUNK;
+        float maxDiff = 0.0f;
+        for (std::size_t i = 0; i < x.size(); ++i) maxDiff = std::max(maxDiff, std::fabs(x[i] - r[i]));
+        mismatch += (maxDiff > 1e-3f);
+    }
+    const bool ok = mismatch == 0 && jumps > 0 && jumped == lossy.get_lost_scans();
+    LOG_ALWAYS("lossy transport: " << jumps << " counter jumps, " << jumped << " scans (fake says " << lossy.get_lost_scans()
+               << "), " << mismatch << " chunks not where the counter says" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_delivery_timing() {
+    using clk = std::chrono::steady_clock;
+    const double speed = 20.0;
+    const std::size_t nChunks = 200; // 25.6 s of stream -> ~1.3 s
+    FakeAcquisition_C::stimConfigs_S cfg = base_cfg();
+    cfg.pacing = AcqPacing_Speed;
+    cfg.speed = speed;
+    cfg.transport = FakeAcquisition_C::transportConfigs_S::preset(FakeTransport_Bluetooth);
+    cfg.transport.stallProb = 0.1; // enough bursts in a short run
+    FakeAcquisition_C acq(cfg);
+
+    std::vector<float> x(NUM_SAMPLES_CHUNK);
+    std::vector<double> arrivalMs, delayMs;
+    const auto t0 = clk::now();
+    for (std::size_t k = 0; k < nChunks; ++k) {
+        acq.getData(NUM_SCANS_CHUNK, x.data());
+        arrivalMs.push_back(std::chrono::duration<double, std::milli>(clk::now() - t0).count());
+        delayMs.push_back(acq.latency_ms());
+    }
+    // pacer anchors on the first chunk -> compare everything relative to it
+    const double chunkMs = 1000.0 * NUM_SCANS_CHUNK / ACQ_FS_HZ / speed;
+    // late by synthesis time in a burst (debug, 64 ch builds: a few ms); the max also eats single missed
+    // wakeups on a loaded box, so judge the model on the median and only use the max to catch drift
+    double early = 0.0;
+    std::vector<double> late;
+    std::size_t bursts = 0, belowBase = 0;
+    for (std::size_t k = 1; k < nChunks; ++k) {
+        const double expect = arrivalMs[0] + double(k) * chunkMs + (delayMs[k] - delayMs[0]);
+        early = std::max(early, expect - arrivalMs[k]);
+        late.push_back(std::max(0.0, arrivalMs[k] - expect));
+        bursts += (arrivalMs[k] - arrivalMs[k - 1] < 0.25 * chunkMs);
+        belowBase += (delayMs[k] < cfg.transport.baseDelayMs / speed - 1e-9);
+    }
+    std::sort(late.begin(), late.end());
+    const double lateMed = late[late.size() / 2], lateMax = late.back();
+    const bool ok = early < 1.0 && lateMed < 2.0 && lateMax < 50.0 && bursts > 0 && belowBase == 0 && acq.get_stalls() > 0;
+    LOG_ALWAYS("delivery timing x" << speed << ": up to " << early << " ms early / " << lateMed << " ms (median) " << lateMax
+               << " ms (max) late vs the modelled arrival, " << acq.get_stalls()
+               << " stalls -> " << bursts << " burst chunks" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+static bool test_gap_tracker() {
+    ChunkGapTracker_C gt;
+    bufferChunk_S c;
+    c.numScans = NUM_SCANS_CHUNK;
+    const std::size_t win = 4 * NUM_SCANS_CHUNK;
+    bool ok = true;
+    uint64_t tick = 0;
+    auto feed = [&](uint64_t n, uint32_t lost = 0) {
+        bool gap = false;
+        for (uint64_t i = 0; i < n; ++i) {
+            c.tick = ++tick;
+            c.lost_scans = (i == 0) ? lost : 0;
+            gap = gt.on_chunk(c) || gap;
+        }
+        return gap;
+    };
+
+    ok = ok && !feed(3) && gt.window_is_contiguous(win, 0);      // no gap yet: anything goes
+    tick += 2;                                                    // 2 chunks dropped in the queue
+    ok = ok && feed(1) && gt.get_dropped_chunks() == 2 && gt.get_lost_scans() == 2 * NUM_SCANS_CHUNK;
+    ok = ok && !gt.window_is_contiguous(win, 0);
+    ok = ok && !feed(3) && gt.window_is_contiguous(win, 0);       // 4 chunks since the gap
+    ok = ok && !gt.window_is_contiguous(win, NUM_SCANS_CHUNK / 2); // half of the last one still stashed
+    ok = ok && feed(1, 5) && gt.get_gaps() == 2 && gt.get_lost_scans() == 2 * NUM_SCANS_CHUNK + 5;
+    ok = ok && !gt.window_is_contiguous(win, 0);
+    LOG_ALWAYS("gap tracker: " << gt.get_gaps() << " gaps, " << gt.get_dropped_chunks() << " dropped chunks, "
+               << gt.get_lost_scans() << " lost scans" << (ok ? "  OK" : "  FAIL"));
+    return ok;
+}
+
+int main() {
+    logger::tlabel = "TransportSelfTest";
+    bool ok = true;
+    ok = test_lossless_identical() && ok;
+    ok = test_loss_accounting() && ok;
+    ok = test_delivery_timing() && ok;
+    ok = test_gap_tracker() && ok;
+    LOG_ALWAYS((ok ? "ALL PASSED" : "FAILURES"));
+    return ok ? 0 : 1;
+}